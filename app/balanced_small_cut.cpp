@@ -36,6 +36,7 @@
 #include "io/graph_io.h"
 #include "tlx/cmdline_parser.hpp"
 #include "tlx/logger.hpp"
+#include "tools/instrumentation.h"
 #include "tools/random_functions.h"
 #include "tools/timer.h"
 
@@ -131,6 +132,8 @@ int main(int argn, char** argv) {
     cfg->save_cut = true;
     cfg->set_node_in_cut = true;
 
+    instrumentation::addCmdlineFlag(&cmdl);
+
     if (!cmdl.process(argn, argv))
         return -1;
 
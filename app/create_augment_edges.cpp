@@ -17,6 +17,7 @@
 #include "io/graph_io.h"
 #include "tlx/cmdline_parser.hpp"
 #include "tlx/logger.hpp"
+#include "tools/instrumentation.h"
 #include "tools/random_functions.h"
 
 int main(int argn, char** argv) {
@@ -38,6 +39,8 @@ int main(int argn, char** argv) {
     cmdl.add_flag('v', "verbose", cfg->verbose, "more verbose logs");
     cmdl.add_size_t('r', "seed", cfg->seed, "random seed");
 
+    instrumentation::addCmdlineFlag(&cmdl);
+
     if (!cmdl.process(argn, argv))
         return -1;
 
@@ -34,22 +34,10 @@
 #include "tlx/cmdline_parser.hpp"
 #include "tlx/logger.hpp"
 #include "tlx/string.hpp"
+#include "tools/graph_generator.h"
+#include "tools/instrumentation.h"
 #include "tools/random_functions.h"
 
-bool existsEdge(mutableGraphPtr G, NodeID s, NodeID t) {
-    if (s == t) {
-        return true;
-    }
-
-    for (EdgeID e : G->edges_of(s)) {
-        NodeID tgt = G->getEdgeTarget(s, e);
-        if (tgt == t) {
-            return true;
-        }
-    }
-    return false;
-}
-
 int main(int argn, char** argv) {
     tlx::CmdlineParser cmdl;
     auto cfg = configuration::getConfig();
@@ -68,28 +56,16 @@ int main(int argn, char** argv) {
     cmdl.add_bool('s', "static", run_static, "run static algorithm");
     cmdl.add_flag('v', "verbose", cfg->verbose, "more verbose logs");
 
+    instrumentation::addCmdlineFlag(&cmdl);
+
     if (!cmdl.process(argn, argv))
         return -1;
 
     auto G = graph_io::readGraphWeighted<mutable_graph>(initial_graph);
-    std::vector<std::pair<NodeID, NodeID> > decrementalEdges;
 
     LOG1 << "Creating edges...";
-    for (auto v : G->nodes()) {
-        size_t i = 0;
-        while (i < edges_per_vertex) {
-            NodeID r = random_functions::nextInt(0, G->n() - 1);
-            if (!existsEdge(G, v, r)) {
-                G->new_edge_order(v, r, 1);
-                decrementalEdges.emplace_back(v, r);
-                ++i;
-            }
-        }
-    }
-
-    LOG1 << "Permuting...";
-
-    random_functions::permutate_vector_good(&decrementalEdges);
+    auto decrementalEdges =
+        graph_generator::overlayRandomEdges(G, edges_per_vertex);
 
     LOG1 << "Starting decremental...";
 
@@ -31,9 +31,12 @@
 #include "data_structure/graph_access.h"
 #include "data_structure/mutable_graph.h"
 #include "io/graph_io.h"
+#include "io/temporal_edge_stream.h"
 #include "tlx/cmdline_parser.hpp"
 #include "tlx/logger.hpp"
 #include "tlx/string.hpp"
+#include "tools/instrumentation.h"
+#include "tools/numa_tools.h"
 #include "tools/random_functions.h"
 
 int main(int argn, char** argv) {
@@ -52,11 +55,40 @@ int main(int argn, char** argv) {
 #ifdef PARALLEL
     size_t procs = 1;
     cmdl.add_size_t('p', "proc", procs, "number of processes");
+    cmdl.add_flag("numa", cfg->numa,
+                  "NUMA-aware memory placement and thread pinning");
 #endif
     cmdl.add_size_t('r', "seed", cfg->seed, "random seed");
     cmdl.add_bool('s', "static", run_static, "run static algorithm");
     cmdl.add_size_t('t', "timeout", timeout, "timeout in seconds");
     cmdl.add_flag('v', "verbose", cfg->verbose, "more verbose logs");
+    cmdl.add_size_t("cache_bytes", cfg->cactus_cache_bytes,
+                    "memory budget of the cactus cache in bytes");
+    cmdl.add_size_t("cache_inserts", cfg->cactus_cache_inserts,
+                    "maximum number of edge inserts to replay on a cactus");
+    cmdl.add_bool("compact_cache", cfg->compact_cactus_cache,
+                  "store cached cacti in serialized form");
+    size_t sort_buffer = (1 << 22);
+    std::string sort_dir = "";
+    cmdl.add_size_t("sort_buffer", sort_buffer,
+                    "updates held in memory when sorting unsorted input");
+    cmdl.add_string("sort_dir", sort_dir,
+                    "directory for sorted runs of unsorted input");
+    std::string checkpoint = "";
+    std::string resume = "";
+    size_t checkpoint_every = 0;
+    size_t resume_at = 0;
+    cmdl.add_string("checkpoint", checkpoint,
+                    "write state to this file at the end of the run");
+    cmdl.add_size_t("checkpoint_every", checkpoint_every,
+                    "also write checkpoint every n updates");
+    cmdl.add_string("resume", resume,
+                    "resume from checkpoint instead of initial computation");
+    cmdl.add_size_t("resume_at", resume_at,
+                    "continue with the first update with this timestamp "
+                    "(default: after the updates in the checkpoint)");
+
+    instrumentation::addCmdlineFlag(&cmdl);
 
     if (!cmdl.process(argn, argv))
         return -1;
@@ -79,6 +111,7 @@ int main(int argn, char** argv) {
 #ifdef PARALLEL
     LOGC(verbose) << "PARALLEL DEFINED, USING " << procs << " THREADS";
     omp_set_num_threads(procs);
+    numa_tools::bindThreads();
     parallel_cactus<mutableGraphPtr> cactus;
 #else
     LOGC(verbose) << "PARALLEL NOT DEFINED";
@@ -94,10 +127,18 @@ int main(int argn, char** argv) {
         exit(1);
     }
 
-    auto [numV, tempEdges] = graph_io::readTemporalGraph(dynamic_edges);
+    temporal_edge_stream stream(dynamic_edges, sort_buffer, sort_dir);
+    NodeID numV = stream.numVertices();
 
     LOG1 << "graph with " << numV << " vertices!";
-    if (initial_graph == "") {
+    // when resuming, the graph is restored from the checkpoint
+    bool resuming = (resume != "" && !run_static);
+    if (resuming) {
+        if (initial_graph != "") {
+            LOG1 << "resuming from checkpoint, ignoring initial graph "
+                 << initial_graph;
+        }
+    } else if (initial_graph == "") {
         G = std::make_shared<mutable_graph>();
         G->start_construction(numV);
         G->finish_construction();
@@ -105,8 +146,8 @@ int main(int argn, char** argv) {
         G = graph_io::readGraphWeighted<mutable_graph>(initial_graph);
     }
 
-    size_t numNodes = G->n();
-    size_t initialNumEdges = G->m();
+    size_t numNodes = resuming ? numV : G->n();
+    size_t initialNumEdges = resuming ? 0 : G->m();
 
     timer run_timer;
     size_t ctr = 0;
@@ -122,42 +163,43 @@ int main(int argn, char** argv) {
 #else
         noi_minimum_cut<mutableGraphPtr> static_alg;
 #endif
-        EdgeID previous_timestamp = std::get<3>(tempEdges[0]);
         EdgeWeight previous_cut = static_alg.perform_minimum_cut(G);
         size_t edgesInBatch = 0;
-        for (auto [s, t, w, timestamp] : tempEdges) {
-            if (run_timer.elapsed() > timeout) {
-                timedOut = true;
-                break;
-            }
-            if ((timestamp != previous_timestamp || disable_batching)
-                && edgesInBatch > 0) {
-                edgesInBatch = 0;
-                previous_timestamp = timestamp;
-                staticruns++;
-                EdgeWeight current_cut = static_alg.perform_minimum_cut(G);
-                if (current_cut != previous_cut) {
-                    previous_cut = current_cut;
-                    cutchange++;
+        std::vector<temporal_edge_stream::update> batch;
+        while (!timedOut && stream.nextBatch(&batch)) {
+            for (size_t i = 0; i < batch.size(); ++i) {
+                auto [s, t, w, timestamp] = batch[i];
+                if (run_timer.elapsed() > timeout) {
+                    timedOut = true;
+                    break;
                 }
-            }
-            ctr++;
-            if (s == t) continue;
-            edgesInBatch++;
-            if (w > 0) {
-                inserts++;
-                G->new_edge_order(s, t, w);
-            } else {
-                deletes++;
-                EdgeID eToT = UNDEFINED_EDGE;
-                for (EdgeID e : G->edges_of(s)) {
-                    if (G->getEdgeTarget(s, e) == t) {
-                        eToT = e;
-                        break;
+                if ((i == 0 || disable_batching) && edgesInBatch > 0) {
+                    edgesInBatch = 0;
+                    staticruns++;
+                    EdgeWeight current_cut = static_alg.perform_minimum_cut(G);
+                    if (current_cut != previous_cut) {
+                        previous_cut = current_cut;
+                        cutchange++;
                     }
                 }
-                if (eToT != UNDEFINED_EDGE) {
-                    G->deleteEdge(s, eToT);
+                ctr++;
+                if (s == t) continue;
+                edgesInBatch++;
+                if (w > 0) {
+                    inserts++;
+                    G->new_edge_order(s, t, w);
+                } else {
+                    deletes++;
+                    EdgeID eToT = UNDEFINED_EDGE;
+                    for (EdgeID e : G->edges_of(s)) {
+                        if (G->getEdgeTarget(s, e) == t) {
+                            eToT = e;
+                            break;
+                        }
+                    }
+                    if (eToT != UNDEFINED_EDGE) {
+                        G->deleteEdge(s, eToT);
+                    }
                 }
             }
         }
@@ -169,13 +211,42 @@ int main(int argn, char** argv) {
         }
     } else {
         dynamic_mincut dynmc;
-        EdgeWeight previous_cut = dynmc.initialize(G);
-        EdgeWeight current_cut = 0;
-        for (auto [s, t, w, timestamp] : tempEdges) {
+        EdgeWeight previous_cut;
+        size_t skip = 0;
+        if (!resuming) {
+            previous_cut = dynmc.initialize(G);
+        } else {
+            skip = dynmc.loadCheckpoint(resume);
+            previous_cut = dynmc.getCurrentCut();
+            numNodes = dynmc.getOriginalGraph()->n();
+            initialNumEdges = dynmc.getOriginalGraph()->m();
+            if (resume_at > 0) {
+                // stream is sorted, updates before resume_at are a prefix
+                skip = 0;
+                temporal_edge_stream::update u;
+                while (stream.next(&u) && std::get<3>(u) < resume_at) {
+                    skip++;
+                }
+                stream.rewind();
+            }
+            LOG1 << "resuming at update " << skip;
+        }
+        EdgeWeight current_cut = previous_cut;
+        temporal_edge_stream::update u;
+        while (stream.next(&u)) {
+            auto [s, t, w, timestamp] = u;
             if (run_timer.elapsed() > timeout) {
                 timedOut = true;
                 break;
             }
+            if (ctr < skip) {
+                ctr++;
+                continue;
+            }
+            if (checkpoint != "" && checkpoint_every > 0 && ctr > skip
+                && (ctr - skip) % checkpoint_every == 0) {
+                dynmc.saveCheckpoint(checkpoint, ctr);
+            }
             ctr++;
             if (s == t) continue;
             if (w > 0) {
@@ -193,6 +264,9 @@ int main(int argn, char** argv) {
         staticruns = dynmc.getCallsOfStaticAlgorithm();
         LOG1 << "n " << dynmc.getCurrentCactus()->n()
              << " c " << dynmc.getCurrentCut();
+        if (checkpoint != "") {
+            dynmc.saveCheckpoint(checkpoint, ctr);
+        }
     }
 
     std::string graph = initial_graph;
@@ -34,6 +34,7 @@
 #include "tlx/cmdline_parser.hpp"
 #include "tlx/logger.hpp"
 #include "tlx/string.hpp"
+#include "tools/instrumentation.h"
 #include "tools/random_functions.h"
 
 int main(int argn, char** argv) {
@@ -59,9 +60,17 @@ int main(int argn, char** argv) {
     cmdl.add_size_t('t', "timeout", timeout, "timeout in seconds");
     cmdl.add_bool('v', "vbs", configuration::getConfig()->verbose, "verbose");
     cmdl.add_size_t('x', "seed", configuration::getConfig()->seed, "rnd seed");
+    cmdl.add_size_t("cache_bytes", cfg->cactus_cache_bytes,
+                    "memory budget of the cactus cache in bytes");
+    cmdl.add_size_t("cache_inserts", cfg->cactus_cache_inserts,
+                    "maximum number of edge inserts to replay on a cactus");
+    cmdl.add_bool("compact_cache", cfg->compact_cactus_cache,
+                  "store cached cacti in serialized form");
 
     configuration::getConfig()->save_cut = true;
 
+    instrumentation::addCmdlineFlag(&cmdl);
+
     if (!cmdl.process(argn, argv))
         return -1;
 
@@ -10,10 +10,12 @@
  *****************************************************************************/
 
 #include <ext/alloc_traits.h>
+#include <omp.h>
 #include <stdlib.h>
 
 #include <algorithm>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -21,11 +23,14 @@
 #include "algorithms/global_mincut/minimum_cut.h"
 #include "algorithms/global_mincut/noi_minimum_cut.h"
 #include "algorithms/misc/core_decomposition.h"
+#include "common/configuration.h"
 #include "common/definitions.h"
 #include "data_structure/graph_access.h"
 #include "io/graph_io.h"
 #include "tlx/cmdline_parser.hpp"
 #include "tlx/logger.hpp"
+#include "tools/instrumentation.h"
+#include "tools/numa_tools.h"
 #include "tools/timer.h"
 
 int main(int argn, char** argv) {
@@ -36,24 +41,39 @@ int main(int argn, char** argv) {
     std::string graph_filename;
     bool no_cut = false;
     bool lowest_core = false;
+    size_t threads = omp_get_max_threads();
 
     std::vector<std::string> cores;
     cmdl.add_stringlist('k', "cores", cores, "kCores");
     cmdl.add_bool('l', "lowest_core", lowest_core,
                   "Search for lowest core where cut is not min degree");
     cmdl.add_bool('c', "no_cut", no_cut, "Disable minimum cut testing.");
+    cmdl.add_size_t('p', "threads", threads,
+                    "Number of threads, target cores are processed "
+                    "concurrently");
+    cmdl.add_flag("numa", configuration::getConfig()->numa,
+                  "NUMA-aware memory placement and thread pinning");
     cmdl.add_param_string("graph", graph_filename, "path to graph file");
 
+    instrumentation::addCmdlineFlag(&cmdl);
+
     if (!cmdl.process(argn, argv))
         return -1;
 
+    omp_set_num_threads(threads);
+    numa_tools::bindThreads();
     timer t;
     graphAccessPtr G =
         graph_io::readGraphWeighted(graph_filename);
 
     LOG << "io time: " << t.elapsed();
     t.restart();
+#ifdef PARALLEL
+    k_cores kCores = core_decomposition::parallel_peeling(G);
+#else
     k_cores kCores = core_decomposition::batagelj_zaversnik(G);
+#endif
+    LOG << "core decomposition time: " << t.elapsed();
     std::vector<size_t> tgts;
     uint32_t max_core =
         kCores.degrees[kCores.vertices[G->number_of_nodes() - 1]];
@@ -82,38 +102,73 @@ int main(int argn, char** argv) {
         exit(1);
     }
 
-    for (size_t target_core : tgts) {
-        if (max_core >= target_core) {
-            auto connected_graph = core_decomposition::createCoreGraph(
-                kCores, target_core, G);
-            std::string outputname = graph_filename
-                                     + "_core_" + std::to_string(target_core);
-
-            LOG1 << "output graph: strongly connected component with core "
-                 << target_core << " nodes: "
-                 << connected_graph->number_of_nodes()
-                 << " edges: " << connected_graph->number_of_edges();
-
-            size_t result = 0;
-            if (!no_cut) {
-                minimum_cut* mc = new noi_minimum_cut<graphAccessPtr>();
-                result = mc->perform_minimum_cut(connected_graph);
-            }
+    // Target cores are processed concurrently, each by a single thread.
+    // A single target core is processed by the calling thread, so that the
+    // core graph extraction runs in parallel with all threads instead of
+    // in a nested parallel region with one thread. In lowest core mode,
+    // cores above the lowest core with a small cut found so far are
+    // skipped, as they can not be the result.
+    size_t lowest_found = std::numeric_limits<size_t>::max();
+    graphAccessPtr lowest_graph = nullptr;
+#pragma omp parallel for schedule(dynamic, 1) if (tgts.size() > 1)
+    for (size_t i = 0; i < tgts.size(); ++i) {
+        size_t target_core = tgts[i];
+        if (max_core < target_core)
+            continue;
+
+        if (lowest_core) {
+            size_t lowest;
+#pragma omp critical
+            lowest = lowest_found;
+            if (lowest < target_core)
+                continue;
+        }
 
-            if (result < connected_graph->getMinDegree()) {
-                std::string out_path = graph_filename + "_core_" +
-                                       std::to_string(target_core);
-                LOG1 << "small min cut " << result << " -> saving";
-                graph_io::writeGraph(connected_graph, out_path);
+        auto connected_graph = core_decomposition::createCoreGraph(
+            kCores, target_core, G);
+
+        LOG1 << "output graph: connected component with core "
+             << target_core << " nodes: "
+             << connected_graph->number_of_nodes()
+             << " edges: " << connected_graph->number_of_edges();
 
+        // only need to know whether there is a cut below the minimum degree
+        size_t result = 0;
+        if (!no_cut) {
+            noi_minimum_cut<graphAccessPtr> mc;
+            result = mc.perform_minimum_cut_threshold(
+                connected_graph, connected_graph->getMinDegree());
+        }
+
+        if (result < connected_graph->getMinDegree()) {
+            LOG1 << "small cut " << result << " in core " << target_core;
+            if (lowest_core) {
                 // Lowest core only finds one graph where cut != degree.
-                // As its found we can exit now.
-                if (lowest_core)
-                    exit(0);
+                // It is written once all lower cores are finished.
+#pragma omp critical
+                {
+                    if (target_core < lowest_found) {
+                        lowest_found = target_core;
+                        lowest_graph = connected_graph;
+                    }
+                }
             } else {
-                LOG1 << "minimum degree equals minimum cut "
-                     << result << " " << connected_graph->getMinDegree();
+                std::string out_path = graph_filename + "_core_" +
+                                       std::to_string(target_core);
+                LOG1 << "saving " << out_path;
+                graph_io::writeGraph(connected_graph, out_path);
             }
+        } else {
+            LOG1 << "minimum degree equals minimum cut "
+                 << result << " " << connected_graph->getMinDegree();
         }
     }
+
+    if (lowest_graph) {
+        std::string out_path = graph_filename + "_core_" +
+                               std::to_string(lowest_found);
+        LOG1 << "lowest core with small min cut: " << lowest_found
+             << " -> saving";
+        graph_io::writeGraph(lowest_graph, out_path);
+    }
 }
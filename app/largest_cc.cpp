@@ -15,13 +15,14 @@
 #include <string>
 #include <vector>
 
-#include "algorithms/misc/strongly_connected_components.h"
+#include "algorithms/misc/connected_components.h"
 #include "common/configuration.h"
 #include "common/definitions.h"
 #include "io/graph_io.h"
 #include "tlx/cmdline_parser.hpp"
 #include "tlx/logger.hpp"
 #include "tlx/string/split.hpp"
+#include "tools/instrumentation.h"
 
 int main(int argn, char** argv) {
     static constexpr bool debug = false;
@@ -35,15 +36,15 @@ int main(int argn, char** argv) {
     cmdl.add_flag('w', "weighted", weighted, "weighted graph");
     configuration::getConfig()->graph_filename = path;
 
+    instrumentation::addCmdlineFlag(&cmdl);
+
     if (!cmdl.process(argn, argv))
         return -1;
 
     graphAccessPtr G =
         graph_io::readGraphWeighted(path);
 
-    strongly_connected_components scc;
-
-    auto out = scc.largest_scc(G);
+    auto out = connected_components::largest_cc(G);
     if (weighted) {
         graph_io::writeGraphWeighted(out, tlx::split(".", path)[0] + ".cc");
     } else {
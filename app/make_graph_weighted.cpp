@@ -27,6 +27,7 @@
 #include "parallel/coarsening/contract_graph.h"
 #include "tlx/cmdline_parser.hpp"
 #include "tlx/logger.hpp"
+#include "tools/instrumentation.h"
 #include "tools/random_functions.h"
 
 int main(int argn, char** argv) {
@@ -55,6 +56,8 @@ int main(int argn, char** argv) {
     cmdl.add_size_t('s', "seed", cfg->seed,
                     "random seed (using time otherwise)");
 
+    instrumentation::addCmdlineFlag(&cmdl);
+
     if (!cmdl.process(argn, argv)) {
         LOG << "Error in command line processing!";
         exit(1);
@@ -28,6 +28,8 @@
 #include "io/graph_io.h"
 #include "tlx/cmdline_parser.hpp"
 #include "tlx/logger.hpp"
+#include "tools/instrumentation.h"
+#include "tools/numa_tools.h"
 #include "tools/random_functions.h"
 #include "tools/string.h"
 #include "tools/timer.h"
@@ -48,11 +50,17 @@ int main(int argn, char** argv) {
 #ifdef PARALLEL
     std::vector<std::string> procs;
     cmdl.add_stringlist('p', "proc", procs, "number of processes");
+    cmdl.add_flag("numa", cfg->numa,
+                  "NUMA-aware memory placement and thread pinning");
 #endif
     cmdl.add_param_string("algo", cfg->algorithm, "algorithm name");
     cmdl.add_string('q', "pq", cfg->queue_type,
                     "name of priority queue implementation");
     cmdl.add_size_t('i', "iter", num_iterations, "number of iterations");
+    cmdl.add_flag("sorted_adjacency", cfg->sorted_adjacency,
+                  "Find triangles by intersecting sorted adjacency lists");
+    cmdl.add_flag("bridge_cut", cfg->bridge_cut,
+                  "Use the lightest bridge as initial cut in viecut");
     cmdl.add_bool('l', "disable_limiting", cfg->disable_limiting,
                   "disable limiting of PQ values");
     cmdl.add_bool('s', "save_cut", cfg->save_cut,
@@ -73,6 +81,28 @@ int main(int argn, char** argv) {
     cmdl.add_string('t', "cactus_filename", cfg->cactus_filename,
                     "name of GraphML file for the cactus graph");
 
+    cmdl.add_size_t("lp_iterations", cfg->lp_iterations,
+                    "maximum number of label propagation rounds");
+    cmdl.add_double("lp_convergence", cfg->lp_convergence,
+                    "stop label propagation when less than this fraction "
+                    "of vertices changes label");
+    cmdl.add_size_t("lp_cluster_size", cfg->lp_cluster_size,
+                    "maximum label propagation cluster size (0: unlimited)");
+
+    cmdl.add_double("epsilon", cfg->approximation_epsilon,
+                    "algorithm approx finds a cut of at most (1 + epsilon) "
+                    "times the minimum cut with probability 1 - 1/n");
+    cmdl.add_string("capforest", cfg->parallel_capforest,
+                    "parallel capforest: partitioned (deterministic) or "
+                    "shared");
+
+    size_t threshold = 0;
+    cmdl.add_size_t("threshold", threshold,
+                    "only decide whether the minimum cut is at least this "
+                    "value, output is a smaller cut or this value");
+
+    instrumentation::addCmdlineFlag(&cmdl);
+
     if (!cmdl.process(argn, argv))
         return -1;
 
@@ -121,11 +151,16 @@ int main(int argn, char** argv) {
 
             auto mc = selectMincutAlgorithm<GraphPtr>(cfg->algorithm);
             omp_set_num_threads(numthread);
+            numa_tools::bindThreads();
             cfg->threads = numthread;
 
             t.restart();
             EdgeWeight cut;
-            cut = mc->perform_minimum_cut(G);
+            if (threshold > 0) {
+                cut = mc->perform_minimum_cut_threshold(G, threshold);
+            } else {
+                cut = mc->perform_minimum_cut(G);
+            }
 
             if (cfg->output_path != "") {
                 if (!cfg->save_cut) {
@@ -27,6 +27,8 @@
 #include "io/graph_io.h"
 #include "tlx/cmdline_parser.hpp"
 #include "tlx/logger.hpp"
+#include "tools/instrumentation.h"
+#include "tools/numa_tools.h"
 #include "tools/random_functions.h"
 #include "tools/timer.h"
 
@@ -51,6 +53,8 @@ int main(int argn, char** argv) {
 #ifdef PARALLEL
     std::vector<std::string> procs;
     cmdl.add_stringlist('p', "proc", procs, "number of processes");
+    cmdl.add_flag("numa", configuration::getConfig()->numa,
+                  "NUMA-aware memory placement and thread pinning");
     cmdl.add_param_string("algo", configuration::getConfig()->algorithm,
                           "algorithm name ('vc', 'exact')");
 #else
@@ -71,6 +75,8 @@ int main(int argn, char** argv) {
                     configuration::getConfig()->sampling_type,
                     "sampling variant for pre-run of viecut");
 
+    instrumentation::addCmdlineFlag(&cmdl);
+
     if (!cmdl.process(argn, argv))
         return -1;
 
@@ -115,6 +121,7 @@ int main(int argn, char** argv) {
                 configuration::getConfig()->algorithm);
             t.restart();
             omp_set_num_threads(numthread);
+            numa_tools::bindThreads();
 
             auto G2 = sf.one_ks(G);
 
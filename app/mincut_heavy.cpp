@@ -27,6 +27,8 @@
 #include "io/graph_io.h"
 #include "tlx/cmdline_parser.hpp"
 #include "tlx/logger.hpp"
+#include "tools/instrumentation.h"
+#include "tools/numa_tools.h"
 #include "tools/quality_metrics.h"
 #include "tools/random_functions.h"
 #include "tools/string.h"
@@ -51,6 +53,8 @@ int main(int argn, char** argv) {
 #ifdef PARALLEL
     std::vector<std::string> procs;
     cmdl.add_stringlist('p', "proc", procs, "number of processes");
+    cmdl.add_flag("numa", configuration::getConfig()->numa,
+                  "NUMA-aware memory placement and thread pinning");
     cmdl.add_param_string("algo", configuration::getConfig()->algorithm,
                           "algorithm name ('vc', 'exact')");
 #else
@@ -66,6 +70,8 @@ int main(int argn, char** argv) {
     cmdl.add_bool('s', "save_cut", configuration::getConfig()->save_cut,
                   "compute and save minimum cut");
 
+    instrumentation::addCmdlineFlag(&cmdl);
+
     if (!cmdl.process(argn, argv))
         return -1;
 
@@ -110,6 +116,7 @@ int main(int argn, char** argv) {
                 configuration::getConfig()->algorithm);
             mc->perform_minimum_cut(G2);
             omp_set_num_threads(numthread);
+            numa_tools::bindThreads();
 
             for (NodeID n : G->nodes()) {
                 if (indices[n] < G->number_of_nodes()) {
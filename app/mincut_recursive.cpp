@@ -24,7 +24,7 @@
 #else
 #include "algorithms/global_mincut/cactus/cactus_mincut.h"
 #endif
-#include "algorithms/misc/strongly_connected_components.h"
+#include "algorithms/misc/connected_components.h"
 #include "common/configuration.h"
 #include "common/definitions.h"
 #include "data_structure/graph_access.h"
@@ -33,6 +33,7 @@
 #include "tlx/cmdline_parser.hpp"
 #include "tlx/logger.hpp"
 #include "tools/graph_extractor.h"
+#include "tools/instrumentation.h"
 #include "tools/timer.h"
 
 int main(int argn, char** argv) {
@@ -46,6 +47,8 @@ int main(int argn, char** argv) {
     cfg->find_most_balanced_cut = true;
     cfg->save_cut = true;
 
+    instrumentation::addCmdlineFlag(&cmdl);
+
     if (!cmdl.process(argn, argv))
         return -1;
 
@@ -85,8 +88,8 @@ int main(int argn, char** argv) {
 
         cut = current_cut;
         graph_extractor ge;
-        strongly_connected_components scc;
-        G = scc.largest_scc(ge.extract_block(G, largest_id).first);
+        auto block = ge.extract_block(G, largest_id).first;
+        G = connected_components::largest_cc(block);
 
         if (output) {
             std::string name = cfg->graph_filename + "_" + std::to_string(ct++);
@@ -25,6 +25,7 @@
 #include "io/graph_io.h"
 #include "tlx/cmdline_parser.hpp"
 #include "tlx/logger.hpp"
+#include "tools/instrumentation.h"
 #include "tools/random_functions.h"
 #include "tools/timer.h"
 
@@ -53,39 +54,74 @@ int main(int argn, char** argv) {
                     "edge selection rule");
     cmdl.add_string('f', "partition_file", config->partition_file,
                     "Partition file");
+    cmdl.add_double('g', "gap", config->gap,
+                    "Stop at this relative gap between cut and lower bound");
     cmdl.add_flag('i', "use_ilp", config->use_ilp, "Use ILP");
+    cmdl.add_string("incumbent_file", config->incumbent_file,
+                    "Write every improved cut to this file "
+                    "as <seconds> <component> <cut>");
+    cmdl.add_size_t('L', "local_search_threads",
+                    config->local_search_threads,
+                    "number of threads in every local search");
     cmdl.add_double('l', "removeTerminalsBeforeBranch",
                     config->removeTerminalsBeforeBranch,
                     "Remove low degree terminals before branch [only -X]");
     cmdl.add_int('k', "top_k", config->top_k,
                  "multiterminal cut between top k vertices (invalidates t)");
+    cmdl.add_size_t('M', "memory_budget", config->memory_budget,
+                    "Memory budget of branch and bound [MiB], 0 = unlimited");
+    cmdl.add_flag("disable_spilling", config->disable_spilling,
+                  "Stop at memory budget instead of spilling problems");
     cmdl.add_double('n', "preset_percentage", config->preset_percentage,
                     "percentag of vertices that are preset");
     cmdl.add_string('o', "first_branch_path", config->first_branch_path,
                     "Print graph at time of first branching, then terminate.");
     cmdl.add_size_t('p', "proc", config->threads, "number of threads");
+    cmdl.add_size_t("small_component_size", config->small_component_size,
+                    "Solve components with at most this many vertices "
+                    "and edges concurrently, one thread each");
     cmdl.add_string('q', "queue_type", config->queue_type,
                     "Type of priority queue used");
     cmdl.add_int('r', "random_k", config->random_k,
                  "multiterminal cut between k random vertices");
     cmdl.add_size_t('s', "seed", config->seed, "random seed");
+    cmdl.add_flag("sorted_adjacency", config->sorted_adjacency,
+                  "Find triangles by intersecting sorted adjacency lists");
+    cmdl.add_string('S', "solver", config->multicut_solver,
+                    "exact (branch and bound) or multilevel (heuristic)");
+    cmdl.add_size_t("coarsest_size", config->multilevel_coarsest_size,
+                    "Vertices of coarsest graph [only -S multilevel]");
+    cmdl.add_string("spill_directory", config->spill_directory,
+                    "Directory of spill file for problems over memory budget");
     cmdl.add_stringlist('t', "terminal", config->term_strings,
                         "add terminal vertex");
     cmdl.add_size_t('T', "maxtime", config->timeoutSeconds,
                     "Timeout after [s]");
+    cmdl.add_size_t("transposition_table", config->transposition_table_size,
+                    "Size of table of seen problems [MiB], 0 = disabled");
     cmdl.add_flag('w', "write_solution", config->write_solution,
                   "Print best solution");
     cmdl.add_flag('X', "inexact", config->inexact, "Apply inexact heuristics");
 
+    instrumentation::addCmdlineFlag(&cmdl);
+
     if (!cmdl.process(argn, argv))
         return -1;
 
+    if (config->multicut_solver != "exact"
+        && config->multicut_solver != "multilevel") {
+        LOG1 << "ERROR: unknown solver " << config->multicut_solver
+             << " (exact or multilevel)";
+        exit(1);
+    }
+
     random_functions::setSeed(config->seed);
 
     std::vector<NodeID> terminals;
 
     mutableGraphPtr G;
     FlowType flow;
+    FlowType lower_bound = 0;
     timer t;
     try {
         multiterminal_cut mc;
@@ -104,6 +140,7 @@ int main(int argn, char** argv) {
              << config->preset_percentage;
         t.restart();
         flow = mc.multicut(G, terminals, config->num_terminals);
+        lower_bound = mc.lowerBound();
 
 #ifdef USE_GUROBI
     } catch (GRBException e) {
@@ -118,11 +155,14 @@ int main(int argn, char** argv) {
               << " time=" << t.elapsed()
               << " terminals=" << config->num_terminals
               << " cut=" << flow
+              << " lower_bound=" << lower_bound
+              << " gap=" << config->gap
               << " n=" << G->number_of_nodes()
               << " m=" << G->number_of_edges() / 2
               << " use_ilp=" << config->use_ilp
               << " processes=" << config->threads
               << " inexact=" << config->inexact
+              << " solver=" << config->multicut_solver
               << " seed=" << config->seed << std::endl;
     MPI_Finalize();
 }
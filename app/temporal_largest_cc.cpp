@@ -15,13 +15,14 @@
 #include <string>
 #include <vector>
 
-#include "algorithms/misc/strongly_connected_components.h"
+#include "algorithms/misc/connected_components.h"
 #include "common/configuration.h"
 #include "common/definitions.h"
 #include "io/graph_io.h"
 #include "tlx/cmdline_parser.hpp"
 #include "tlx/logger.hpp"
 #include "tlx/string/split.hpp"
+#include "tools/instrumentation.h"
 
 int main(int argn, char** argv) {
     static constexpr bool debug = false;
@@ -33,6 +34,8 @@ int main(int argn, char** argv) {
     cmdl.add_param_string("graph", path, "path to graph file");
     configuration::getConfig()->graph_filename = path;
 
+    instrumentation::addCmdlineFlag(&cmdl);
+
     if (!cmdl.process(argn, argv))
         return -1;
 
@@ -46,16 +49,9 @@ int main(int argn, char** argv) {
     G->finish_construction();
     graphAccessPtr GA = G->to_graph_access();
 
-    strongly_connected_components scc;
-    std::vector<int32_t> components(GA->number_of_nodes());
-    auto ct = scc.strong_components(GA, &components);
+    auto [components, ct, compsizes] = connected_components::components(GA);
     LOG << "count of connected components: " << ct;
 
-    std::vector<uint64_t> compsizes(static_cast<uint64_t>(ct));
-    for (int32_t component : components) {
-        ++compsizes[component];
-    }
-
     auto max_size = std::max_element(compsizes.begin(), compsizes.end());
     int max_comp = static_cast<int>(max_size - compsizes.begin());
 
@@ -0,0 +1,170 @@
+/******************************************************************************
+ * mincut_benchmark.cpp
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "algorithms/global_mincut/algorithms.h"
+#include "algorithms/global_mincut/minimum_cut.h"
+#include "algorithms/misc/core_decomposition.h"
+#include "common/configuration.h"
+#include "common/definitions.h"
+#include "data_structure/graph_access.h"
+#include "data_structure/mutable_graph.h"
+#include "tlx/cmdline_parser.hpp"
+#include "tlx/logger.hpp"
+#include "tools/graph_generator.h"
+#include "tools/instrumentation.h"
+#include "tools/random_functions.h"
+
+// Benchmark suite for the global minimum cut algorithms. All graphs are
+// generated in process with fixed seeds, so that runs on different versions
+// of the code are comparable. Use --benchmark_out=<file> and
+// --benchmark_out_format=json to write the results as JSON.
+
+struct benchmark_graph {
+    std::string name;
+    graphAccessPtr G;
+};
+
+static std::vector<benchmark_graph> generateGraphs(size_t scale) {
+    std::vector<benchmark_graph> graphs;
+    size_t seed = 0;
+
+    // 3x3 torus of gnp blocks with 5 edges between neighboring blocks
+    random_functions::setSeed(seed);
+    size_t block_vertices = 100 * scale;
+    graphs.push_back({ "gnp_torus_" + std::to_string(block_vertices),
+                       graph_generator::gnpTorus(block_vertices, 3, 5) });
+
+    // gnp torus with a random unit weight edge overlay, as in the
+    // decremental_gnp workload
+    random_functions::setSeed(seed);
+    auto overlay = mutable_graph::from_graph_access(
+        graph_generator::gnpTorus(block_vertices, 3, 5));
+    graph_generator::overlayRandomEdges(overlay, 2);
+    graphs.push_back({ "decremental_gnp_" + std::to_string(block_vertices),
+                       overlay->to_graph_access() });
+
+    // largest connected component of the 4-core of an R-MAT graph, as
+    // the low degree vertices would make the minimum cut trivial
+    random_functions::setSeed(seed);
+    size_t rmat_scale = 10;
+    for (size_t s = scale; s > 1; s /= 2) {
+        ++rmat_scale;
+    }
+    auto rmat = graph_generator::rmat(rmat_scale, 8);
+    k_cores kCores = core_decomposition::batagelj_zaversnik(rmat);
+    graphs.push_back({ "rmat_" + std::to_string(rmat_scale) + "_core4",
+                       core_decomposition::createCoreGraph(kCores, 4, rmat) });
+
+    for (const auto& g : graphs) {
+        LOG1 << "generated " << g.name << " n=" << g.G->number_of_nodes()
+             << " m=" << g.G->number_of_edges() / 2;
+    }
+    return graphs;
+}
+
+static void runMincut(benchmark::State& state, graphAccessPtr G,  // NOLINT
+                      std::string algorithm, std::string pq, int threads) {
+    auto cfg = configuration::getConfig();
+    cfg->pq = pq;
+    cfg->threads = threads;
+    cfg->save_cut = false;
+    omp_set_num_threads(threads);
+
+    EdgeWeight cut = 0;
+    for (auto _ : state) {
+        random_functions::setSeed(cfg->seed);
+        std::unique_ptr<minimum_cut> mc(
+            selectMincutAlgorithm<graphAccessPtr>(algorithm));
+        cut = mc->perform_minimum_cut(G);
+        benchmark::DoNotOptimize(cut);
+    }
+
+    state.counters["n"] = G->number_of_nodes();
+    state.counters["m"] = G->number_of_edges() / 2;
+    state.counters["cut"] = cut;
+    state.counters["threads"] = threads;
+}
+
+int main(int argn, char** argv) {
+    benchmark::Initialize(&argn, argv);
+
+    tlx::CmdlineParser cmdl;
+    size_t scale = 1;
+    size_t max_threads = omp_get_max_threads();
+    std::vector<std::string> algorithms;
+    std::vector<std::string> pqs;
+    cmdl.add_size_t('s', "scale", scale, "size factor of generated graphs");
+    cmdl.add_size_t('p', "max_threads", max_threads,
+                    "maximum number of threads (benchmarks powers of 2)");
+    cmdl.add_stringlist('a', "algo", algorithms, "algorithms to benchmark");
+    cmdl.add_stringlist('q', "pq", pqs, "priority queues to benchmark");
+
+    instrumentation::addCmdlineFlag(&cmdl);
+
+    if (!cmdl.process(argn, argv))
+        return -1;
+
+    std::vector<int> threads;
+#ifdef PARALLEL
+    for (size_t t = 1; t <= max_threads; t *= 2) {
+        threads.emplace_back(t);
+    }
+    if (algorithms.empty())
+        algorithms = { "inexact", "exact", "cactus" };
+    // the parallel algorithms have a fixed priority queue
+    pqs = { "default" };
+    std::string suffix = "par";
+#else
+    threads.emplace_back(1);
+    if (algorithms.empty())
+        algorithms = { "noi", "vc", "cactus", "ks", "matula" };
+    if (pqs.empty())
+        pqs = { "default", "bqueue", "heap", "bstack" };
+    std::string suffix = "";
+#endif
+
+    auto graphs = generateGraphs(scale);
+    for (const auto& algo : algorithms) {
+        for (const auto& pq : pqs) {
+            // priority queue only changes the algorithms based on noi
+            bool uses_pq = (algo == "noi" || algo == "vc" || algo == "cactus");
+            if (!uses_pq && pq != pqs.front())
+                continue;
+
+            for (int t : threads) {
+                for (const auto& g : graphs) {
+                    std::string name = algo + suffix + "/" + g.name
+                                       + "/pq:" + (uses_pq ? pq : "none")
+                                       + "/threads:" + std::to_string(t);
+                    benchmark::RegisterBenchmark(
+                        name.c_str(), runMincut, g.G, algo, pq, t)
+                    ->Unit(benchmark::kMillisecond)
+                    ->UseRealTime();
+                }
+            }
+        }
+    }
+
+    benchmark::AddCustomContext("scale", std::to_string(scale));
+    benchmark::AddCustomContext("max_threads", std::to_string(max_threads));
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+}
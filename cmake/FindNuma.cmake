@@ -0,0 +1,45 @@
+# - Find Numa
+# Find the native libnuma includes and library
+#
+#  Numa_INCLUDE_DIR - where to find numa.h, etc.
+#  Numa_LIBRARIES   - List of libraries when using libnuma.
+#  Numa_FOUND       - True if libnuma found.
+
+find_path(Numa_INCLUDE_DIR numa.h NO_DEFAULT_PATH PATHS
+  $ENV{HOME}/.local/include
+  /usr/include
+  /opt/local/include
+  /usr/local/include
+)
+
+find_library(Numa_LIBRARY
+  NAMES numa libnuma
+  PATHS $ENV{HOME}/.local/lib
+        /lib
+        /usr/lib
+        /usr/local/lib
+        /opt/local/lib
+        /usr/lib/x86_64-linux-gnu
+)
+
+if (Numa_INCLUDE_DIR AND Numa_LIBRARY)
+  set(Numa_FOUND TRUE)
+  set( Numa_LIBRARIES ${Numa_LIBRARY} )
+else ()
+  set(Numa_FOUND FALSE)
+  set( Numa_LIBRARIES )
+endif ()
+
+if (Numa_FOUND)
+  message(STATUS "Found Numa: ${Numa_LIBRARY}")
+else ()
+  message(STATUS "Not Found Numa: ${Numa_LIBRARY}")
+  if (Numa_FIND_REQUIRED)
+    message(FATAL_ERROR "Could NOT find libnuma. Disable using -DUSE_NUMA=off!")
+  endif ()
+endif ()
+
+mark_as_advanced(
+  Numa_LIBRARY
+  Numa_INCLUDE_DIR
+  )
@@ -26,6 +26,7 @@
 #include "common/definitions.h"
 #include "data_structure/mutable_graph.h"
 #include "data_structure/priority_queues/maxNodeHeap.h"
+#include "tools/instrumentation.h"
 #include "tools/random_functions.h"
 #include "tools/timer.h"
 
@@ -40,30 +41,37 @@ class push_relabel {
     virtual ~push_relabel() { }
 
  private:
+    // Vertex states and distance counts are not reset in every iteration,
+    // instead they are reset when they are first accessed in an iteration.
+    // Thus, a limited flow problem only takes time proportional to the
+    // region it touches and not to the number of vertices in the graph.
     void init(mutableGraphPtr G,
               std::vector<NodeID> sources,
               NodeID source) {
         m_current_iteration++;
         if (m_excess.size() < G->n()) {
             m_excess.resize(G->n(), 0);
-            m_distance.resize(G->n(), 0);
+            m_label.resize(G->n(), { 0, 0 });
             m_active.resize(G->n(), false);
-            m_count.resize(2 * G->n(), 0);
             m_bfstouched.resize(G->n(), false);
         }
-        std::fill(m_excess.begin(), m_excess.end(), 0);
-        std::fill(m_distance.begin(), m_distance.end(), 0);
-        std::fill(m_active.begin(), m_active.end(), false);
-        std::fill(m_count.begin(), m_count.end(), 0);
-        std::fill(m_bfstouched.begin(), m_bfstouched.end(), false);
+        if (m_count.size() < 2 * G->n() + 1) {
+            m_count.resize(2 * G->n() + 1, 0);
+            m_count_stamp.resize(2 * G->n() + 1, 0);
+        }
+        m_touched.clear();
+        m_untouched = G->n();
+        m_default_distance = 0;
         m_Q.reset();
-        m_count[0] = G->number_of_nodes() - 1;
-        m_count[G->number_of_nodes()] = 1;
+        count(0) = G->number_of_nodes() - 1;
+        count(G->number_of_nodes()) = 1;
 
         NodeID flow_source = sources[source];
-        m_distance[flow_source] = G->number_of_nodes();
+        touch(flow_source);
+        m_label[flow_source].distance = G->number_of_nodes();
 
         for (NodeID n : sources) {
+            touch(n);
             m_active[n] = true;
         }
 
@@ -80,38 +88,43 @@ class push_relabel {
         std::queue<NodeID> Q;
         NodeID flow_source = sources[source];
 
-        std::fill(m_bfstouched.begin(), m_bfstouched.end(), false);
+        clearTouched();
         size_t depthPR = configuration::getConfig()->depthOfPartialRelabeling;
 
         if constexpr (limited && initial) {
-            size_t fillValue = depthPR + 1;
-            std::fill(m_distance.begin(), m_distance.end(), fillValue);
-            m_count[0] = 0;
-            m_count[fillValue] = m_G->n() - 1;
+            NodeID fillValue = depthPR + 1;
+            m_default_distance = fillValue;
+            for (NodeID n : m_touched) {
+                m_label[n].distance = fillValue;
+            }
+            count(0) = 0;
+            count(fillValue) = m_G->n() - 1;
         } else {
-            for (NodeID n : m_G->nodes()) {
-                m_distance[n] = std::max(m_distance[n], m_G->number_of_nodes());
+            m_default_distance = std::max(m_default_distance, m_G->n());
+            for (NodeID n : m_touched) {
+                m_label[n].distance =
+                    std::max(m_label[n].distance, m_G->number_of_nodes());
             }
         }
 
         for (NodeID sink : sources) {
             if (sink == flow_source) {
-                m_distance[sink] = m_G->n();
+                m_label[sink].distance = m_G->n();
                 continue;
             }
 
             Q.push(sink);
-            m_bfstouched[sink] = true;
-            m_count[m_distance[sink]]--;
-            m_count[0]++;
-            m_distance[sink] = 0;
+            markTouched(sink);
+            count(m_label[sink].distance)--;
+            count(0)++;
+            m_label[sink].distance = 0;
         }
 
         if constexpr (limited && initial) {
             if (depthPR + 1 <= 1) return;
         }
 
-        m_bfstouched[flow_source] = true;
+        markTouched(flow_source);
 
         NodeID node = 0;
         while (!Q.empty()) {
@@ -125,17 +138,18 @@ class push_relabel {
                 EdgeID rev_e = m_G->getReverseEdge(node, e);
                 if (initial || (m_G->getEdgeWeight(target, rev_e) -
                                 getEdgeFlow(target, rev_e)) > 0) {
-                    m_count[m_distance[target]]--;
-                    m_distance[target] = m_distance[node] + 1;
-                    m_count[m_distance[target]]++;
+                    touch(target);
+                    count(m_label[target].distance)--;
+                    m_label[target].distance = m_label[node].distance + 1;
+                    count(m_label[target].distance)++;
                     if constexpr (!(limited && initial)) {
                         Q.push(target);
                     } else {
-                        if (m_distance[target] < depthPR) {
+                        if (m_label[target].distance < depthPR) {
                             Q.push(target);
                         }
                     }
-                    m_bfstouched[target] = true;
+                    markTouched(target);
                 }
             }
         }
@@ -145,7 +159,8 @@ class push_relabel {
     void push(NodeID source, EdgeID e, NodeID sourceDistance) {
         m_pushes++;
         NodeID target = m_G->getEdgeTarget(source, e);
-        if (sourceDistance <= m_distance[target]) [[likely]] return;
+        if (sourceDistance <= distance(target)) [[likely]] return;
+        touch(target);
 
         FlowType capacity = m_G->getEdgeWeight(source, e);
         FlowType flow = getEdgeFlow(source, e);
@@ -180,9 +195,9 @@ class push_relabel {
             if constexpr (limited) {
                 // min heap if limited as first flow faster
                 // max heap if not for better asymptotic runtime
-                m_Q.insert(target, (-1) * m_distance[target]);
+                m_Q.insert(target, (-1) * m_label[target].distance);
             } else {
-                m_Q.insert(target, m_distance[target]);
+                m_Q.insert(target, m_label[target].distance);
             }
             // m_Q.push(target);
         }
@@ -190,7 +205,7 @@ class push_relabel {
 
     // try to push as much excess as possible out of the node node
     void discharge(NodeID node) {
-        NodeID nodeDistance = m_distance[node];
+        NodeID nodeDistance = m_label[node].distance;
         for (EdgeID e : m_G->edges_of(node)) {
             if (m_excess[node] == 0)
                 break;
@@ -199,10 +214,10 @@ class push_relabel {
         }
 
         if (m_excess[node] > 0) {
-            if (m_count[m_distance[node]] == 1
-                && m_distance[node] < m_G->number_of_nodes()) {
+            if (count(m_label[node].distance) == 1
+                && m_label[node].distance < m_G->number_of_nodes()) {
                 // hence this layer will be empty after the relabel step
-                gap_heuristic(m_distance[node]);
+                gap_heuristic(m_label[node].distance);
             } else {
                 relabel(node);
             }
@@ -212,11 +227,18 @@ class push_relabel {
     // gap heuristic
     void gap_heuristic(NodeID level) {
         m_gaps++;
-        for (NodeID node : m_G->nodes()) {
-            if (m_distance[node] < level) continue;
-            m_count[m_distance[node]]--;
-            m_distance[node] = std::max(m_distance[node], m_G->n());
-            m_count[m_distance[node]]++;
+        // untouched vertices have no excess and all have the same distance
+        if (m_default_distance >= level) {
+            count(m_default_distance) -= m_untouched;
+            m_default_distance = std::max(m_default_distance, m_G->n());
+            count(m_default_distance) += m_untouched;
+        }
+
+        for (NodeID node : m_touched) {
+            if (m_label[node].distance < level) continue;
+            count(m_label[node].distance)--;
+            m_label[node].distance = std::max(m_label[node].distance, m_G->n());
+            count(m_label[node].distance)++;
             enqueue(node);
         }
     }
@@ -227,32 +249,66 @@ class push_relabel {
         m_work += WORK_OP_RELABEL;
         m_num_relabels++;
 
-        m_count[m_distance[node]]--;
-        m_distance[node] = 2 * m_G->number_of_nodes();
+        count(m_label[node].distance)--;
+        m_label[node].distance = 2 * m_G->number_of_nodes();
 
         for (EdgeID e : m_G->edges_of(node)) {
             if (m_G->getEdgeWeight(node, e) - getEdgeFlow(node, e) > 0) {
                 NodeID target = m_G->getEdgeTarget(node, e);
-                m_distance[node] =
-                    std::min(m_distance[node], m_distance[target] + 1);
+                m_label[node].distance =
+                    std::min(m_label[node].distance, distance(target) + 1);
             }
             m_work++;
         }
 
-        m_count[m_distance[node]]++;
+        count(m_label[node].distance)++;
         enqueue(node);
     }
 
+    void touch(NodeID node) {
+        if (m_label[node].iteration != m_current_iteration) {
+            m_label[node].iteration = m_current_iteration;
+            m_excess[node] = 0;
+            m_label[node].distance = m_default_distance;
+            m_active[node] = false;
+            m_touched.emplace_back(node);
+            m_untouched--;
+        }
+    }
+
+    void markTouched(NodeID node) {
+        m_bfstouched[node] = true;
+        m_bfsmarked.emplace_back(node);
+    }
+
+    void clearTouched() {
+        for (NodeID node : m_bfsmarked) {
+            m_bfstouched[node] = false;
+        }
+        m_bfsmarked.clear();
+    }
+
+    NodeID distance(NodeID node) const {
+        if (m_label[node].iteration != m_current_iteration)
+            return m_default_distance;
+        return m_label[node].distance;
+    }
+
+    int& count(NodeID distance) {
+        if (m_count_stamp[distance] != m_current_iteration) {
+            m_count_stamp[distance] = m_current_iteration;
+            m_count[distance] = 0;
+        }
+        return m_count[distance];
+    }
+
     std::vector<NodeID> computeSourceSet(const std::vector<NodeID>& sources,
                                          NodeID curr_source) {
         std::vector<NodeID> source_set;
         // perform bfs starting from source set
         source_set.clear();
         NodeID src = sources[curr_source];
-
-        for (NodeID node : m_G->nodes()) {
-            m_bfstouched[node] = false;
-        }
+        clearTouched();
 
         std::queue<NodeID> Q;
         for (NodeID tgt : sources) {
@@ -260,7 +316,7 @@ class push_relabel {
                 continue;
 
             Q.push(tgt);
-            m_bfstouched[tgt] = true;
+            markTouched(tgt);
         }
 
         while (!Q.empty()) {
@@ -275,7 +331,7 @@ class push_relabel {
                                   - getEdgeFlow(edge_source, rev_e);
                 if (resCap > 0 && !m_bfstouched[edge_source]) {
                     Q.push(edge_source);
-                    m_bfstouched[edge_source] = true;
+                    markTouched(edge_source);
                 }
             }
         }
@@ -283,7 +339,7 @@ class push_relabel {
         std::queue<NodeID> Qsrc;
         Qsrc.push(src);
         source_set.emplace_back(src);
-        m_bfstouched[src] = true;
+        markTouched(src);
         while (!Qsrc.empty()) {
             NodeID node = Qsrc.front();
             Qsrc.pop();
@@ -292,7 +348,7 @@ class push_relabel {
                 NodeID n = m_G->getEdgeTarget(node, e);
                 if (!m_bfstouched[n]) {
                     source_set.emplace_back(n);
-                    m_bfstouched[n] = true;
+                    markTouched(n);
                     Qsrc.push(n);
                 }
             }
@@ -403,6 +459,7 @@ class push_relabel {
             if constexpr (limited) {
                 if (m_limitreached) {
                     double timeAll = t.elapsed();
+                    recordCounters(timeAll);
                     size_t depthPR =
                         configuration::getConfig()->depthOfPartialRelabeling;
                     LOG0 << "RESULT-PR n=" << G->n() << " m=" << G->m()
@@ -438,11 +495,8 @@ class push_relabel {
             source_set = computeSourceSet(sources, curr_source);
         }
 
-        LOGC(extended_logs) << "updates " << m_global_updates
-                            << " relabel " << m_num_relabels
-                            << " pushes " << m_pushes;
-
         double timeAll = t.elapsed();
+        recordCounters(timeAll);
 
         size_t depthPR = configuration::getConfig()->depthOfPartialRelabeling;
         LOG0 << "RESULT-PR n=" << G->n() << " m=" << G->m()
@@ -457,12 +511,34 @@ class push_relabel {
     }
 
  private:
+    void recordCounters(double time) {
+        instrumentation::addPhase("push_relabel", time);
+        instrumentation::addCounter("push_relabel/global_updates",
+                                    m_global_updates);
+        instrumentation::addCounter("push_relabel/relabels", m_num_relabels);
+        instrumentation::addCounter("push_relabel/gaps", m_gaps);
+        instrumentation::addCounter("push_relabel/pushes", m_pushes);
+        instrumentation::addCounter("push_relabel/actual_pushes",
+                                    m_actual_pushes);
+    }
+
     std::vector<FlowType> m_excess;
-    std::vector<NodeID> m_distance;
+    // distance label and the iteration in which it was last set, stored
+    // together as both are read for every push
+    struct distance_label {
+        NodeID   distance;
+        uint32_t iteration;
+    };
+    std::vector<distance_label> m_label;
     std::vector<bool> m_active;   // store which nodes are in the queue already
     std::vector<int> m_count;
+    std::vector<uint32_t> m_count_stamp;
+    std::vector<NodeID> m_touched;
+    NodeID m_untouched;
+    NodeID m_default_distance;
     maxNodeHeap m_Q;
     std::vector<bool> m_bfstouched;
+    std::vector<NodeID> m_bfsmarked;
     std::vector<std::vector<FlowType> > edge_flow;
     int m_num_relabels;
     int m_gaps;
@@ -470,13 +546,12 @@ class push_relabel {
     int m_pushes;
     int m_actual_pushes;
     int m_work;
-    int m_current_iteration;
+    uint32_t m_current_iteration;
     NodeID m_sink;
     FlowType m_limit;
     bool m_limitreached;
     size_t m_problemid;
     mutableGraphPtr m_G;
-    static const bool extended_logs = false;
 
     timer t;
 };
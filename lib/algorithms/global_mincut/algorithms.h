@@ -17,6 +17,7 @@
 #include "parallel/algorithm/exact_parallel_minimum_cut.h"
 #include "parallel/algorithm/parallel_cactus.h"
 #endif
+#include "algorithms/global_mincut/approximate_mincut.h"
 #include "algorithms/global_mincut/cactus/cactus_mincut.h"
 #include "algorithms/global_mincut/ks_minimum_cut.h"
 #include "algorithms/global_mincut/matula_approx.h"
@@ -43,6 +44,8 @@ template <class GraphPtr>
     if (argv_str == "cactus")
         return new cactus_mincut<GraphPtr>();
 #endif
+    if (argv_str == "approx")
+        return new approximate_mincut<GraphPtr>();
 #ifdef PARALLEL
     if (argv_str == "inexact")
         return new viecut<GraphPtr>();
@@ -0,0 +1,276 @@
+/******************************************************************************
+ * approximate_mincut.h
+ *
+ * Source of VieCut
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#pragma once
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "algorithms/global_mincut/matula_approx.h"
+#include "algorithms/global_mincut/minimum_cut.h"
+#include "common/configuration.h"
+#include "common/definitions.h"
+#include "data_structure/graph_access.h"
+#include "data_structure/mutable_graph.h"
+#include "tlx/logger.hpp"
+#include "tools/timer.h"
+
+#ifdef PARALLEL
+#include "parallel/algorithm/exact_parallel_minimum_cut.h"
+#else
+#include "algorithms/global_mincut/noi_minimum_cut.h"
+#endif
+
+// (1 + epsilon)-approximate minimum cut by skeleton sampling (Karger).
+// Matula's algorithm gives an estimate L of the minimum cut with
+// lambda <= L <= 2 lambda, thus L / 2 is a lower bound of lambda. Every edge
+// of weight w is then kept with weight Binomial(w, p) for
+// p = c log n / (epsilon^2 L / 2). With high probability, all cuts of the
+// resulting skeleton are within a factor of (1 +- epsilon) of their expected
+// value, thus the minimum cut of the skeleton is a (1 + epsilon)-approximate
+// minimum cut of the input graph. The skeleton is solved exactly and the cut
+// it induces is evaluated on the input graph. If the value of that cut is
+// not within (1 + epsilon) / (1 - epsilon) of the skeleton cut scaled by
+// 1 / p, the sample did not concentrate and is repeated with twice the
+// sampling probability. This check does not detect every failed sample, the
+// approximation guarantee only holds with probability 1 - 1/n. Graphs where
+// p >= 1 are solved exactly.
+template <class GraphPtr>
+class approximate_mincut : public minimum_cut {
+ public:
+    typedef GraphPtr GraphPtrType;
+    approximate_mincut() { }
+    virtual ~approximate_mincut() { }
+    static constexpr bool debug = false;
+
+    // constant c of the sampling probability. By Karger's sampling theorem,
+    // p >= 3 (d + 2) ln n / (epsilon^2 lambda) fails with probability at
+    // most n^-d. As p is computed from L / 2 <= lambda, c = 18 fails with
+    // probability at most 1/n even if L / 2 is much smaller than lambda.
+    static constexpr double sampling_constant = 18.0;
+
+    EdgeWeight perform_minimum_cut(GraphPtr G) {
+        if (!G) {
+            return -1;
+        }
+
+        auto cfg = configuration::getConfig();
+        const bool save_cut = cfg->save_cut;
+        const double epsilon = cfg->approximation_epsilon;
+        NodeID n = G->number_of_nodes();
+        if (n < 2 || epsilon <= 0.0) {
+            return exactMinimumCut(G);
+        }
+
+        timer t;
+        cfg->save_cut = false;
+        matula_approx<GraphPtr> matula;
+        EdgeWeight estimate = matula.perform_minimum_cut(copyGraph(G));
+        cfg->save_cut = save_cut;
+        LOG << "matula estimate " << estimate << " in " << t.elapsedToZero();
+
+        // estimate / 2 <= lambda
+        double p = sampling_constant * std::log(n)
+                   / (epsilon * epsilon * static_cast<double>(estimate) / 2.0);
+
+        std::vector<bool> side;
+        EdgeWeight cut = UNDEFINED_EDGE;
+        size_t attempt = 0;
+        while (p < 1.0 && cut == UNDEFINED_EDGE) {
+            graphAccessPtr skeleton = sampleSkeleton(G, p, attempt++);
+            LOG << "skeleton with p=" << p << " has "
+                << skeleton->number_of_edges() << " of "
+                << G->number_of_edges() << " edges, sampled in "
+                << t.elapsedToZero();
+
+            cfg->save_cut = true;
+            EdgeWeight skeleton_cut = exactMinimumCut(skeleton);
+            cfg->save_cut = save_cut;
+
+            side.resize(n);
+            for (NodeID v = 0; v < n; ++v) {
+                side[v] = skeleton->getNodeInCut(v);
+            }
+            EdgeWeight sampled_cut = evaluateCut(G, side);
+            LOG << "skeleton cut has value " << sampled_cut << " in "
+                << t.elapsedToZero();
+
+            // skeleton_cut / p <= (1 + epsilon) lambda and the skeleton
+            // value of the cut is at least (1 - epsilon) p sampled_cut
+            if ((1.0 - epsilon) * p * static_cast<double>(sampled_cut)
+                <= (1.0 + epsilon) * static_cast<double>(skeleton_cut)) {
+                cut = sampled_cut;
+            } else {
+                p *= 2;
+            }
+        }
+
+        if (cut == UNDEFINED_EDGE) {
+            LOG << "sampling probability " << p << ", solving exactly";
+            return exactMinimumCut(G);
+        }
+
+        // trivial cut of a minimum degree vertex
+        if (G->getMinDegree() < cut) {
+            cut = G->getMinDegree();
+            std::fill(side.begin(), side.end(), false);
+            for (NodeID v = 0; v < n; ++v) {
+                if (G->getWeightedNodeDegree(v) == cut) {
+                    side[v] = true;
+                    break;
+                }
+            }
+        }
+
+        if (save_cut) {
+            for (NodeID v = 0; v < n; ++v) {
+                G->setNodeInCut(v, side[v]);
+                G->setPartitionIndex(v, side[v] ? 0 : 1);
+            }
+        }
+        return cut;
+    }
+
+ private:
+    // splitmix64, seeded per edge so that both directions of an edge draw the
+    // same sample, independent of the thread that samples them
+    struct edge_random {
+        typedef uint64_t result_type;
+        uint64_t state;
+
+        static constexpr result_type min() {
+            return 0;
+        }
+
+        static constexpr result_type max() {
+            return UINT64_MAX;
+        }
+
+        result_type operator () () {
+            uint64_t z = (state += 0x9e3779b97f4a7c15);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            return z ^ (z >> 31);
+        }
+    };
+
+    template <class AnyGraphPtr>
+    EdgeWeight exactMinimumCut(AnyGraphPtr G) {
+#ifdef PARALLEL
+        exact_parallel_minimum_cut<AnyGraphPtr> mc;
+#else
+        noi_minimum_cut<AnyGraphPtr> mc;
+#endif
+        return mc.perform_minimum_cut(G);
+    }
+
+    // matula contracts mutable graphs in place
+    GraphPtr copyGraph(GraphPtr G) {
+        if constexpr (std::is_same<GraphPtr, mutableGraphPtr>::value) {
+            return std::make_shared<mutable_graph>(*G);
+        } else {
+            return G;
+        }
+    }
+
+    static EdgeWeight sampleWeight(NodeID u, NodeID v, EdgeWeight w,
+                                   double p, uint64_t seed) {
+        if (u > v)
+            std::swap(u, v);
+        edge_random r { (seed * 0xff51afd7ed558ccd)
+                        ^ ((static_cast<uint64_t>(u) << 32) | v) };
+        r();
+        if (w == 1) {
+            return (r() < p * static_cast<double>(edge_random::max()));
+        }
+        std::binomial_distribution<EdgeWeight> binomial(w, p);
+        return binomial(r);
+    }
+
+    graphAccessPtr sampleSkeleton(GraphPtr G, double p, size_t attempt) {
+        NodeID n = G->number_of_nodes();
+        uint64_t seed = configuration::getConfig()->seed + (attempt << 32);
+        std::vector<EdgeID> first_edge(n + 1, 0);
+
+#ifdef PARALLEL
+#pragma omp parallel for schedule(dynamic, 1024)
+#endif
+        for (NodeID v = 0; v < n; ++v) {
+            for (EdgeID e : G->edges_of(v)) {
+                NodeID t = G->getEdgeTarget(v, e);
+                EdgeWeight w = G->getEdgeWeight(v, e);
+                if (t != v && sampleWeight(v, t, w, p, seed) > 0) {
+                    first_edge[v + 1]++;
+                }
+            }
+        }
+
+        for (NodeID v = 0; v < n; ++v) {
+            first_edge[v + 1] += first_edge[v];
+        }
+
+        std::vector<NodeID> targets(first_edge[n]);
+        std::vector<EdgeWeight> weights(first_edge[n]);
+#ifdef PARALLEL
+#pragma omp parallel for schedule(dynamic, 1024)
+#endif
+        for (NodeID v = 0; v < n; ++v) {
+            EdgeID pos = first_edge[v];
+            for (EdgeID e : G->edges_of(v)) {
+                NodeID t = G->getEdgeTarget(v, e);
+                if (t == v)
+                    continue;
+                EdgeWeight w = sampleWeight(
+                    v, t, G->getEdgeWeight(v, e), p, seed);
+                if (w > 0) {
+                    targets[pos] = t;
+                    weights[pos] = w;
+                    pos++;
+                }
+            }
+        }
+
+        graphAccessPtr skeleton = std::make_shared<graph_access>();
+        skeleton->start_construction(n, first_edge[n]);
+        for (NodeID v = 0; v < n; ++v) {
+            skeleton->new_node();
+            for (EdgeID e = first_edge[v]; e < first_edge[v + 1]; ++e) {
+                skeleton->new_edge(v, targets[e], weights[e]);
+            }
+        }
+        skeleton->finish_construction();
+        return skeleton;
+    }
+
+    EdgeWeight evaluateCut(GraphPtr G, const std::vector<bool>& side) {
+        NodeID n = G->number_of_nodes();
+        EdgeWeight cut = 0;
+#ifdef PARALLEL
+#pragma omp parallel for schedule(dynamic, 1024) reduction(+ : cut)
+#endif
+        for (NodeID v = 0; v < n; ++v) {
+            for (EdgeID e : G->edges_of(v)) {
+                if (side[v] != side[G->getEdgeTarget(v, e)]) {
+                    cut += G->getEdgeWeight(v, e);
+                }
+            }
+        }
+        return cut / 2;
+    }
+};
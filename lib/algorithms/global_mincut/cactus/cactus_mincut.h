@@ -28,13 +28,14 @@
 #include "algorithms/global_mincut/minimum_cut.h"
 #include "algorithms/global_mincut/noi_minimum_cut.h"
 #include "algorithms/global_mincut/viecut.h"
+#include "common/configuration.h"
 #include "common/definitions.h"
 #include "data_structure/graph_access.h"
 #include "data_structure/mutable_graph.h"
 #include "data_structure/priority_queues/maxNodeHeap.h"
 #include "io/graph_io.h"
+#include "tools/instrumentation.h"
 #include "tools/string.h"
-#include "tools/timer.h"
 
 #ifdef PARALLEL
 #include "parallel/coarsening/contract_graph.h"
@@ -50,11 +51,15 @@ class cactus_mincut : public minimum_cut {
     virtual ~cactus_mincut() { }
     static constexpr bool debug = false;
 
-    bool timing = configuration::getConfig()->verbose;
-
     EdgeWeight perform_minimum_cut(GraphPtr G) {
-        // compatibility with min cut interface
-        return std::get<0>(findAllMincuts(G));
+        // compatibility with min cut interface. vertex locations in the
+        // cactus need the partition indices set by contraction with save_cut
+        auto cfg = configuration::getConfig();
+        bool save_cut = cfg->save_cut;
+        cfg->save_cut = true;
+        EdgeWeight cut = std::get<0>(findAllMincuts(G));
+        cfg->save_cut = save_cut;
+        return cut;
     }
 
     std::tuple<EdgeWeight, mutableGraphPtr,
@@ -75,13 +80,14 @@ class cactus_mincut : public minimum_cut {
         }
         recursive_cactus<GraphPtr> rc;
         EdgeWeight mincut = graphs.back()->getMinDegree();
-        timer t;
+        phase_timer t;
         if (known_mincut == UNDEFINED_NODE) {
             viecut<GraphPtr> vc;
             mincut = vc.perform_minimum_cut(graphs.back());
         } else {
             mincut = known_mincut;
         }
+        t.lap("cactus/viecut");
         noi_minimum_cut<GraphPtr> noi;
         std::vector<std::vector<std::pair<NodeID, NodeID> > > guaranteed_edges;
         std::vector<size_t> ge_ids;
@@ -95,14 +101,11 @@ class cactus_mincut : public minimum_cut {
             EdgeWeight current_mincut = mincut;
             ge_ids.emplace_back(graphs.size() - 1);
             guaranteed_edges.emplace_back();
-            LOGC(timing) << "t " << t.elapsed()
-                         << " n " << current_graph->number_of_nodes()
-                         << " m " << current_graph->number_of_edges()
-                         << " cut " << mincut;
+            instrumentation::addLevel("cactus", graphs.size() - 1,
+                                      current_graph->n(), current_graph->m());
 
             std::vector<std::pair<NodeID, NodeID> > contractable;
 
-            timer time;
             auto uf = noi.modified_capforest(current_graph, mincut + 1);
 
             for (NodeID n : current_graph->nodes()) {
@@ -117,9 +120,7 @@ class cactus_mincut : public minimum_cut {
                 }
             }
 
-            LOGC(timing) << "t-noi " << t.elapsed() << " contract "
-                         << graphs.back()->number_of_nodes()
-                         << " to " << uf.n();
+            t.lap("cactus/capforest");
 
             if (uf.n() < current_graph->number_of_nodes()) {
                 auto newg =
@@ -128,12 +129,11 @@ class cactus_mincut : public minimum_cut {
                 mincut = minimum_cut_helpers<GraphPtr>::updateCut(
                     graphs, mincut);
             }
+            t.lap("cactus/contraction");
 
             union_find uf12 = tests::prTests12(
                 graphs.back(), mincut + 1, true);
-            LOGC(timing) << "t12 " << t.elapsed() << " contract "
-                         << graphs.back()->number_of_nodes()
-                         << " to " << uf12.n();
+            t.lap("cactus/padberg-rinaldi tests 1-2");
             if (uf12.n() < graphs.back()->number_of_nodes()) {
                 auto g12 = contraction::fromUnionFind(
                     graphs.back(), &uf12, true);
@@ -141,12 +141,11 @@ class cactus_mincut : public minimum_cut {
                 mincut = minimum_cut_helpers<GraphPtr>::updateCut(
                     graphs, mincut);
             }
+            t.lap("cactus/contraction");
 
             union_find uf34 = tests::prTests34(
                 graphs.back(), mincut + 1, true);
-            LOGC(timing) << "t34 " << t.elapsed() << " contract "
-                         << graphs.back()->number_of_nodes()
-                         << " to " << uf34.n();
+            t.lap("cactus/padberg-rinaldi tests 3-4");
             if (uf34.n() < graphs.back()->number_of_nodes()) {
                 auto g34 = contraction::fromUnionFind(
                     graphs.back(), &uf34, true);
@@ -154,6 +153,7 @@ class cactus_mincut : public minimum_cut {
                 mincut = minimum_cut_helpers<GraphPtr>::updateCut(
                     graphs, mincut);
             }
+            t.lap("cactus/contraction");
 
             if (current_mincut > mincut) {
                 // mincut has improved
@@ -166,14 +166,17 @@ class cactus_mincut : public minimum_cut {
 
         if (graphs.back()->number_of_nodes() > 1)
             mincut = noi.perform_minimum_cut(graphs.back());
+        t.lap("cactus/noi");
 
         rc.setMincut(mincut);
         auto out_graph = rc.flowMincut(graphs);  // This is the cactus graph!
+        t.lap("cactus/recursive cactus");
 
         minimum_cut_helpers<GraphPtr>::setVertexLocations(
             out_graph, graphs, ge_ids, guaranteed_edges, mincut);
-        LOGC(timing)
-            << "unpacked - n " << out_graph->n() << " m " << out_graph->m();
+        t.lap("cactus/unpacking");
+        instrumentation::addCounter("cactus/vertices", out_graph->n());
+        instrumentation::addCounter("cactus/edges", out_graph->m());
 
         std::vector<std::pair<NodeID, EdgeID> > mb_edges;
         if (configuration::getConfig()->find_most_balanced_cut) {
@@ -155,7 +155,6 @@ class recursive_cactus {
 
         {
             std::vector<NodeID> vtcs = { s, tgt };
-            push_relabel pr;
             problem_id++;
             max_flow = pr.solve_max_flow_min_cut(
                 G, vtcs, 0, false, false, problem_id).first;
@@ -617,4 +616,6 @@ class recursive_cactus {
     timer t;
     EdgeWeight mincut;
     size_t problem_id;
+    // shared by all recursion levels, as its arrays are reset lazily
+    push_relabel<> pr;
 };
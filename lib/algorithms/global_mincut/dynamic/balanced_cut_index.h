@@ -0,0 +1,457 @@
+/******************************************************************************
+ * balanced_cut_index.h
+ *
+ * Source of VieCut
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "common/definitions.h"
+#include "data_structure/mutable_graph.h"
+#include "tlx/logger.hpp"
+
+#ifdef PARALLEL
+#include "parallel/data_structure/union_find.h"
+#else
+#include "data_structure/union_find.h"
+#endif
+
+// Index of the most balanced minimum cut of a cactus under edge insertions.
+//
+// Every minimum cut of the cactus is either a bridge or a pair of edges on a
+// cycle. The index roots the cactus in a DFS and stores the number of
+// vertices in every subtree, thus the side of every cut is a (difference of)
+// ranges of the DFS order and its weight is known.
+//
+// Inserting an edge (s, t) removes exactly the minimum cuts that separate s
+// and t, all other cuts keep their sides. The cactus nodes on the path from
+// s to t are merged in a union-find structure, so every path edge is only
+// visited once until the index is rebuilt. Dead bridges are skipped in a list
+// sorted by weight, cycles that lost cuts recompute their best cut in time
+// linear in the cycle length.
+//
+// Vertex weights are the number of contained vertices, as the weighted
+// degrees used for conductance change with every insertion.
+class balanced_cut_index {
+ public:
+    static constexpr bool debug = false;
+
+    balanced_cut_index() : mincut(0), num_vertices(0), uf(0) { }
+
+    ~balanced_cut_index() { }
+
+    mutableGraphPtr cactus() const {
+        return indexed_cactus;
+    }
+
+    void build(mutableGraphPtr G, EdgeWeight cut) {
+        indexed_cactus = G;
+        mincut = cut;
+        num_vertices = G->getOriginalNodes();
+        NodeID n = G->n();
+
+        node_of.assign(num_vertices, 0);
+        order.clear();
+        vstart.assign(n, 0);
+        vend.assign(n, 0);
+        parent.assign(n, UNDEFINED_NODE);
+        link_depth.assign(n, 0);
+        cycle_of.assign(n, UNDEFINED_NODE);
+        position.assign(n, 0);
+        cycles.clear();
+        cycle_best.clear();
+        cycle_arc.clear();
+        cycle_dirty.clear();
+        cycle_queue = decltype(cycle_queue)();
+        bridges.clear();
+        next_bridge = 0;
+        bridge_alive.assign(n, false);
+        uf = union_find(n);
+        scratch_first.assign(n, UNDEFINED_NODE);
+        scratch_last.assign(n, UNDEFINED_NODE);
+        scratch_side.assign(n, 0);
+        top.resize(n);
+        for (NodeID v = 0; v < n; ++v) {
+            top[v] = v;
+        }
+
+        if (mincut == 0 || n < 2)
+            return;
+
+        std::vector<NodeID> preorder = runDFS(G);
+
+        for (NodeID v : preorder) {
+            if (v == preorder[0])
+                continue;
+            NodeID link = cycle_of[v] == UNDEFINED_NODE
+                          ? parent[v] : cycles[cycle_of[v]][0];
+            link_depth[v] = link_depth[link] + 1;
+
+            if (cycle_of[v] == UNDEFINED_NODE) {
+                bridge_alive[v] = true;
+                bridges.emplace_back(lighterSide(subtree(v)), v);
+            }
+        }
+
+        std::sort(bridges.begin(), bridges.end(),
+                  [](const auto& b1, const auto& b2) {
+                      return b1.first > b2.first;
+                  });
+
+        for (NodeID c = 0; c < cycles.size(); ++c) {
+            recomputeCycle(c);
+        }
+
+        LOG << "built index with " << bridges.size() << " bridges and "
+            << cycles.size() << " cycles";
+    }
+
+    // contracts the cactus path between original vertices s and t
+    void addEdge(NodeID s, NodeID t) {
+        if (mincut == 0 || s >= num_vertices || t >= num_vertices)
+            return;
+
+        NodeID u = top[uf.Find(node_of[s])];
+        NodeID v = top[uf.Find(node_of[t])];
+
+        while (uf.Find(u) != uf.Find(v)) {
+            if (link_depth[u] < link_depth[v])
+                std::swap(u, v);
+
+            NodeID c = cycle_of[u];
+            if (c != UNDEFINED_NODE && c == cycle_of[v]
+                && link_depth[u] == link_depth[v]) {
+                // path enters and leaves the cycle below its root
+                mergeInCycle(c, position[u], position[v]);
+            } else if (c != UNDEFINED_NODE) {
+                mergeInCycle(c, position[u], 0);
+            } else {
+                bridge_alive[u] = false;
+                unite(u, parent[u]);
+            }
+
+            u = top[uf.Find(u)];
+            v = top[uf.Find(v)];
+        }
+    }
+
+    // number of vertices on the lighter side of the most balanced cut
+    EdgeWeight bestWeight() {
+        refresh();
+        return best_weight;
+    }
+
+    // vertices on one side of the most balanced minimum cut
+    std::vector<NodeID> bestSide() {
+        refresh();
+        std::vector<NodeID> side;
+        if (best_weight == 0)
+            return side;
+
+        if (best_cycle == UNDEFINED_NODE) {
+            side.insert(side.end(), order.begin() + vstart[best_bridge],
+                        order.begin() + vend[best_bridge]);
+        } else {
+            const auto& cycle = cycles[best_cycle];
+            auto [first, last] = cycle_arc[best_cycle];
+            NodeID begin = vstart[cycle[first]];
+            NodeID end = vend[cycle[first]];
+            NodeID hole_begin = end;
+            NodeID hole_end = end;
+            if (last + 1 < cycle.size()) {
+                hole_begin = vstart[cycle[last + 1]];
+                hole_end = vend[cycle[last + 1]];
+            }
+            side.insert(side.end(), order.begin() + begin,
+                        order.begin() + hole_begin);
+            side.insert(side.end(), order.begin() + hole_end,
+                        order.begin() + end);
+        }
+        return side;
+    }
+
+ private:
+    // iterative, as cacti can be very deep. Lays out the contained vertices
+    // in DFS order and finds the cycles, which form paths in the DFS tree
+    std::vector<NodeID> runDFS(mutableGraphPtr G) {
+        std::vector<DFSVertexStatus> status(G->n(), UNDISCOVERED);
+        std::vector<EdgeID> next_edge(G->n(), 0);
+        std::vector<NodeID> preorder;
+        std::vector<NodeID> stack;
+
+        auto discover = [&](NodeID v) {
+            status[v] = ACTIVE;
+            preorder.emplace_back(v);
+            stack.emplace_back(v);
+            vstart[v] = order.size();
+            for (NodeID orig : G->containedVertices(v)) {
+                node_of[orig] = v;
+                order.emplace_back(orig);
+            }
+        };
+
+        discover(0);
+        while (!stack.empty()) {
+            NodeID v = stack.back();
+            if (next_edge[v] == G->get_first_invalid_edge(v)) {
+                vend[v] = order.size();
+                status[v] = FINISHED;
+                stack.pop_back();
+                continue;
+            }
+
+            NodeID w = G->getEdgeTarget(v, next_edge[v]++);
+            if (status[w] == UNDISCOVERED) {
+                parent[w] = v;
+                discover(w);
+            } else if (status[w] == ACTIVE && w != parent[v]) {
+                // back edge closes the cycle w -> ... -> v
+                std::vector<NodeID> cycle;
+                for (NodeID c = v; c != w; c = parent[c]) {
+                    cycle.emplace_back(c);
+                }
+                cycle.emplace_back(w);
+                std::reverse(cycle.begin(), cycle.end());
+                for (NodeID i = 1; i < cycle.size(); ++i) {
+                    cycle_of[cycle[i]] = cycles.size();
+                    position[cycle[i]] = i;
+                }
+                cycles.emplace_back(std::move(cycle));
+                cycle_best.emplace_back(0);
+                cycle_arc.emplace_back(0, 0);
+                cycle_dirty.emplace_back(false);
+            }
+        }
+        return preorder;
+    }
+
+    NodeID subtree(NodeID v) const {
+        return vend[v] - vstart[v];
+    }
+
+    EdgeWeight lighterSide(EdgeWeight w) const {
+        return std::min(w, num_vertices - w);
+    }
+
+    // number of vertices in the cycle position, i.e. the cycle vertex and
+    // everything hanging off it
+    EdgeWeight positionWeight(const std::vector<NodeID>& cycle, NodeID i) {
+        if (i == 0)
+            return num_vertices - subtree(cycle[1]);
+        NodeID below = i + 1 < cycle.size() ? subtree(cycle[i + 1]) : 0;
+        return subtree(cycle[i]) - below;
+    }
+
+    void unite(NodeID a, NodeID b) {
+        NodeID top_a = top[uf.Find(a)];
+        NodeID top_b = top[uf.Find(b)];
+        uf.Union(a, b);
+        top[uf.Find(a)] =
+            link_depth[top_a] <= link_depth[top_b] ? top_a : top_b;
+    }
+
+    // merges cycle positions i and j. The merged cycle positions are
+    // non-crossing, positions of groups that separate i from j are on the
+    // path from i to j and are merged as well
+    void mergeInCycle(NodeID c, NodeID i, NodeID j) {
+        const auto& cycle = cycles[c];
+        if (i > j)
+            std::swap(i, j);
+
+        for (NodeID p = 0; p < cycle.size(); ++p) {
+            if (p != i && p != j) {
+                scratch_side[uf.Find(cycle[p])] |= (p > i && p < j) ? 1 : 2;
+            }
+        }
+
+        std::vector<NodeID> crossing;
+        for (NodeID p = 0; p < cycle.size(); ++p) {
+            if (p != i && p != j && scratch_side[uf.Find(cycle[p])] == 3) {
+                crossing.emplace_back(cycle[p]);
+            }
+        }
+        for (NodeID p = 0; p < cycle.size(); ++p) {
+            scratch_side[uf.Find(cycle[p])] = 0;
+        }
+
+        unite(cycle[i], cycle[j]);
+        for (NodeID v : crossing) {
+            unite(cycle[i], v);
+        }
+
+        if (!cycle_dirty[c]) {
+            cycle_dirty[c] = true;
+            dirty_cycles.emplace_back(c);
+        }
+    }
+
+    // finds the most balanced cut of a cycle that does not separate merged
+    // positions. Gaps between consecutive positions that can be cut together
+    // are in the same face of the non-crossing partition of merged positions.
+    // In every face, the best pair of gaps is found with two pointers.
+    void recomputeCycle(NodeID c) {
+        const auto& cycle = cycles[c];
+        NodeID k = cycle.size();
+
+        std::vector<NodeID> group(k);
+        std::vector<EdgeWeight> prefix(k + 1, 0);
+        for (NodeID p = 0; p < k; ++p) {
+            group[p] = uf.Find(cycle[p]);
+            if (scratch_first[group[p]] == UNDEFINED_NODE)
+                scratch_first[group[p]] = p;
+            scratch_last[group[p]] = p;
+            prefix[p + 1] = prefix[p] + positionWeight(cycle, p);
+        }
+
+        // face 0 is the outer face, every group opens a new face between
+        // each pair of consecutive positions
+        std::vector<NodeID> face_of_gap(k);
+        std::vector<NodeID> open_faces;
+        NodeID num_faces = 1;
+        for (NodeID p = 0; p < k; ++p) {
+            NodeID first = scratch_first[group[p]];
+            NodeID last = scratch_last[group[p]];
+            if (first != last) {
+                if (p == first) {
+                    open_faces.emplace_back(num_faces++);
+                } else if (p == last) {
+                    open_faces.pop_back();
+                } else {
+                    open_faces.back() = num_faces++;
+                }
+            }
+            // gap p is between positions p and p + 1
+            face_of_gap[p] = open_faces.empty() ? 0 : open_faces.back();
+        }
+
+        for (NodeID p = 0; p < k; ++p) {
+            scratch_first[group[p]] = UNDEFINED_NODE;
+        }
+
+        // bucket gaps by face, keeping them in cyclic order
+        std::vector<NodeID> face_begin(num_faces + 1, 0);
+        for (NodeID p = 0; p < k; ++p) {
+            face_begin[face_of_gap[p] + 1]++;
+        }
+        for (NodeID f = 0; f < num_faces; ++f) {
+            face_begin[f + 1] += face_begin[f];
+        }
+        std::vector<NodeID> gaps(k);
+        std::vector<NodeID> fill(face_begin.begin(), face_begin.end() - 1);
+        for (NodeID p = 0; p < k; ++p) {
+            gaps[fill[face_of_gap[p]]++] = p;
+        }
+
+        EdgeWeight best = 0;
+        std::pair<NodeID, NodeID> arc(0, 0);
+        for (NodeID f = 0; f < num_faces; ++f) {
+            NodeID a = face_begin[f];
+            for (NodeID b = a + 1; b < face_begin[f + 1]; ++b) {
+                EdgeWeight end = prefix[gaps[b] + 1];
+                while (a + 1 < b
+                       && 2 * (end - prefix[gaps[a + 1] + 1]) >= num_vertices) {
+                    ++a;
+                }
+                for (NodeID cand = a; cand <= a + 1 && cand < b; ++cand) {
+                    EdgeWeight w =
+                        lighterSide(end - prefix[gaps[cand] + 1]);
+                    if (w > best) {
+                        best = w;
+                        arc = std::make_pair(gaps[cand] + 1, gaps[b]);
+                    }
+                }
+            }
+        }
+
+        cycle_best[c] = best;
+        cycle_arc[c] = arc;
+        cycle_dirty[c] = false;
+        if (best > 0)
+            cycle_queue.emplace(best, c);
+    }
+
+    void refresh() {
+        for (NodeID c : dirty_cycles) {
+            recomputeCycle(c);
+        }
+        dirty_cycles.clear();
+
+        while (next_bridge < bridges.size()
+               && !bridge_alive[bridges[next_bridge].second]) {
+            ++next_bridge;
+        }
+
+        // cycles only lose cuts, thus outdated entries are too large
+        while (!cycle_queue.empty()
+               && cycle_queue.top().first
+               != cycle_best[cycle_queue.top().second]) {
+            cycle_queue.pop();
+        }
+
+        best_weight = 0;
+        best_bridge = UNDEFINED_NODE;
+        best_cycle = UNDEFINED_NODE;
+        if (next_bridge < bridges.size()) {
+            best_weight = bridges[next_bridge].first;
+            best_bridge = bridges[next_bridge].second;
+        }
+        if (!cycle_queue.empty() && cycle_queue.top().first > best_weight) {
+            best_weight = cycle_queue.top().first;
+            best_bridge = UNDEFINED_NODE;
+            best_cycle = cycle_queue.top().second;
+        }
+    }
+
+    mutableGraphPtr indexed_cactus;
+    EdgeWeight mincut;
+    EdgeWeight num_vertices;
+
+    // cactus node of every original vertex and vertices in DFS order
+    std::vector<NodeID> node_of;
+    std::vector<NodeID> order;
+    // contained vertices of subtree of v are order[vstart[v]..vend[v])
+    std::vector<NodeID> vstart;
+    std::vector<NodeID> vend;
+    std::vector<NodeID> parent;
+    // depth in tree where cycle vertices are children of the cycle root
+    std::vector<NodeID> link_depth;
+    // cycle of the DFS tree edge to the parent (if any) and position in it
+    std::vector<NodeID> cycle_of;
+    std::vector<NodeID> position;
+
+    std::vector<std::vector<NodeID> > cycles;
+    std::vector<EdgeWeight> cycle_best;
+    std::vector<std::pair<NodeID, NodeID> > cycle_arc;
+    std::vector<bool> cycle_dirty;
+    std::vector<NodeID> dirty_cycles;
+    std::priority_queue<std::pair<EdgeWeight, NodeID> > cycle_queue;
+
+    // (weight of lighter side, child vertex) sorted by decreasing weight
+    std::vector<std::pair<EdgeWeight, NodeID> > bridges;
+    size_t next_bridge;
+    std::vector<bool> bridge_alive;
+
+    // merged cactus vertices and their vertex closest to the root
+    union_find uf;
+    std::vector<NodeID> top;
+
+    // per cactus vertex, reset after every use
+    std::vector<NodeID> scratch_first;
+    std::vector<NodeID> scratch_last;
+    std::vector<uint8_t> scratch_side;
+
+    EdgeWeight best_weight = 0;
+    NodeID best_bridge = UNDEFINED_NODE;
+    NodeID best_cycle = UNDEFINED_NODE;
+};
@@ -0,0 +1,264 @@
+/******************************************************************************
+ * cactus_cache.h
+ *
+ * Source of VieCut
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#pragma once
+
+#include <iterator>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "common/configuration.h"
+#include "common/definitions.h"
+#include "data_structure/mutable_graph.h"
+#include "tlx/logger.hpp"
+#include "tools/instrumentation.h"
+
+// Cache of minimum cut cacti for dynamic minimum cut, keyed by cut value.
+// When the minimum cut decreases, the previous cactus is cached. When edge
+// insertions increase the minimum cut to a cached value again, the cached
+// cactus is updated with the inserted edges instead of recomputed.
+//
+// Inserted edges are stored at the lowest cached cactus, so the cactus for
+// cut value c needs the inserts of all entries with cut value <= c.
+// Taking the lowest cactus thus moves its inserts to the next entry.
+//
+// The cache is bounded by a memory budget. If it is exceeded, cacti are
+// evicted in order of decreasing cut value, as they are the last ones to be
+// reused and need the most inserted edges. Optionally, cacti are stored in
+// their serialized form, which needs a fraction of the memory.
+class cactus_cache {
+ public:
+    static constexpr bool debug = false;
+
+    typedef std::vector<std::tuple<NodeID, NodeID, EdgeWeight> > insert_list;
+
+    cactus_cache()
+        : cactus_cache(configuration::getConfig()->cactus_cache_bytes,
+                       configuration::getConfig()->cactus_cache_inserts,
+                       configuration::getConfig()->compact_cactus_cache) { }
+
+    cactus_cache(size_t max_bytes, size_t max_inserts, bool compact)
+        : max_bytes(max_bytes),
+          max_inserts(max_inserts),
+          compact(compact),
+          total_bytes(0) { }
+
+    ~cactus_cache() { }
+
+    bool empty() const {
+        return entries.empty();
+    }
+
+    size_t size() const {
+        return entries.size();
+    }
+
+    size_t bytes() const {
+        return total_bytes;
+    }
+
+    EdgeWeight lowestCut() const {
+        if (entries.empty())
+            return UNDEFINED_EDGE;
+        return entries.begin()->first;
+    }
+
+    NodeID lowestCactusVertices() const {
+        return entries.begin()->second.vertices;
+    }
+
+    size_t lowestInserts() const {
+        return entries.begin()->second.inserts.size();
+    }
+
+    void put(mutableGraphPtr cactus, EdgeWeight cut) {
+        erase(cut);
+        entry& e = entries[cut];
+        e.vertices = cactus->n();
+        if (compact) {
+            e.serial = cactus->serialize();
+            e.bytes = e.serial.size() * sizeof(uint64_t);
+        } else {
+            e.cactus = cactus;
+            e.bytes = cactus->memoryUsage();
+        }
+        total_bytes += e.bytes;
+        evict();
+    }
+
+    void addEdge(NodeID s, NodeID t, EdgeWeight wgt) {
+        if (entries.empty())
+            return;
+
+        entry& lowest = entries.begin()->second;
+        if (lowest.inserts.size() <= max_inserts) {
+            lowest.inserts.emplace_back(s, t, wgt);
+            lowest.bytes += sizeof(insert_list::value_type);
+            total_bytes += sizeof(insert_list::value_type);
+            evict();
+        } else {
+            // all cached cacti need these inserts, thus rebuilding any of
+            // them is more expensive than recomputing
+            LOG << "too many inserts, clearing cactus cache";
+            instrumentation::addCounter("cactus_cache/evictions",
+                                        entries.size());
+            entries.clear();
+            total_bytes = 0;
+        }
+    }
+
+    // removes the lowest cactus from the cache and returns it together with
+    // the edges inserted since it was cached
+    std::pair<mutableGraphPtr, insert_list> takeLowest() {
+        auto lowest = entries.begin();
+        mutableGraphPtr cactus = lowest->second.cactus;
+        if (compact) {
+            cactus = mutable_graph::deserialize(lowest->second.serial);
+        }
+        insert_list inserts = std::move(lowest->second.inserts);
+        total_bytes -= lowest->second.bytes;
+        entries.erase(lowest);
+        instrumentation::addCounter("cactus_cache/hits");
+
+        if (!entries.empty()) {
+            entry& next = entries.begin()->second;
+            if (inserts.size() + next.inserts.size() > max_inserts) {
+                LOG << "too many inserts, clearing cactus cache";
+                instrumentation::addCounter("cactus_cache/evictions",
+                                            entries.size());
+                entries.clear();
+                total_bytes = 0;
+            } else {
+                next.inserts.insert(next.inserts.end(),
+                                    inserts.begin(), inserts.end());
+                size_t insert_bytes =
+                    inserts.size() * sizeof(insert_list::value_type);
+                next.bytes += insert_bytes;
+                total_bytes += insert_bytes;
+                evict();
+            }
+        }
+        return std::make_pair(cactus, inserts);
+    }
+
+    // appends all entries to out, in the format read by deserialize
+    void serialize(std::vector<uint64_t>* out) {
+        out->emplace_back(entries.size());
+        for (auto& [cut, e] : entries) {
+            std::vector<uint64_t> serial =
+                compact ? e.serial : e.cactus->serialize();
+            out->emplace_back(cut);
+            out->emplace_back(serial.size());
+            out->insert(out->end(), serial.begin(), serial.end());
+            out->emplace_back(e.inserts.size());
+            for (auto [s, t, wgt] : e.inserts) {
+                out->emplace_back(s);
+                out->emplace_back(t);
+                out->emplace_back(wgt);
+            }
+        }
+    }
+
+    // replaces the cache content with the length words at data and returns
+    // the number of words read. Returns 0 and leaves the cache empty if the
+    // data is truncated.
+    size_t deserialize(const uint64_t* data, size_t length) {
+        entries.clear();
+        total_bytes = 0;
+        size_t pos = 0;
+        if (length == 0) {
+            return 0;
+        }
+        uint64_t num_entries = data[pos++];
+        for (uint64_t i = 0; i < num_entries; ++i) {
+            if (pos + 2 > length) {
+                return truncated();
+            }
+            EdgeWeight cut = data[pos++];
+            uint64_t serial_size = data[pos++];
+            // serial_size + 1 words for graph and number of inserts
+            if (serial_size == 0 || serial_size >= length - pos) {
+                return truncated();
+            }
+            entry& e = entries[cut];
+            // first word of a serialized graph is its number of vertices
+            e.vertices = data[pos];
+            if (compact) {
+                e.serial.assign(data + pos, data + pos + serial_size);
+                e.bytes = serial_size * sizeof(uint64_t);
+            } else {
+                e.cactus = mutable_graph::deserialize(data + pos);
+                e.bytes = e.cactus->memoryUsage();
+            }
+            total_bytes += e.bytes;
+            pos += serial_size;
+
+            uint64_t num_inserts = data[pos++];
+            if (num_inserts > (length - pos) / 3) {
+                return truncated();
+            }
+            for (uint64_t j = 0; j < num_inserts; ++j) {
+                e.inserts.emplace_back(data[pos], data[pos + 1],
+                                       data[pos + 2]);
+                pos += 3;
+            }
+            size_t insert_bytes =
+                num_inserts * sizeof(insert_list::value_type);
+            e.bytes += insert_bytes;
+            total_bytes += insert_bytes;
+        }
+        evict();
+        return pos;
+    }
+
+ private:
+    size_t truncated() {
+        entries.clear();
+        total_bytes = 0;
+        return 0;
+    }
+
+    struct entry {
+        mutableGraphPtr cactus;
+        std::vector<uint64_t> serial;
+        insert_list inserts;
+        NodeID vertices;
+        size_t bytes;
+    };
+
+    void erase(EdgeWeight cut) {
+        auto it = entries.find(cut);
+        if (it != entries.end()) {
+            total_bytes -= it->second.bytes;
+            entries.erase(it);
+        }
+    }
+
+    void evict() {
+        while (total_bytes > max_bytes && !entries.empty()) {
+            auto highest = std::prev(entries.end());
+            LOG << "evicting cactus for cut " << highest->first
+                << " with " << highest->second.bytes << " bytes";
+            instrumentation::addCounter("cactus_cache/evictions");
+            total_bytes -= highest->second.bytes;
+            entries.erase(highest);
+        }
+    }
+
+    size_t max_bytes;
+    size_t max_inserts;
+    bool compact;
+    size_t total_bytes;
+    std::map<EdgeWeight, entry> entries;
+};
@@ -0,0 +1,83 @@
+/******************************************************************************
+ * cactus_snapshot.h
+ *
+ * Source of VieCut
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "common/definitions.h"
+#include "data_structure/mutable_graph.h"
+
+// Immutable copy of a minimum cut cactus, published by dynamic_mincut after
+// every change of the cactus. A snapshot is never modified after
+// construction, so any number of threads can query it without locks while
+// the dynamic algorithm continues to update its own cactus.
+class cactus_snapshot {
+ public:
+    typedef std::tuple<NodeID, NodeID, EdgeWeight> cactus_edge;
+
+    cactus_snapshot(mutableGraphPtr cactus, EdgeWeight cut, uint64_t version)
+        : cut(cut),
+          snapshot_version(version),
+          cactus_vertices(cactus->n()),
+          position(cactus->getOriginalNodes()) {
+        for (NodeID v = 0; v < position.size(); ++v) {
+            position[v] = cactus->getCurrentPosition(v);
+        }
+        for (NodeID n : cactus->nodes()) {
+            for (EdgeID e : cactus->edges_of(n)) {
+                NodeID t = cactus->getEdgeTarget(n, e);
+                if (n < t) {
+                    edges.emplace_back(n, t, cactus->getEdgeWeight(n, e));
+                }
+            }
+        }
+    }
+
+    // true iff no minimum cut separates u and v
+    bool sameSide(NodeID u, NodeID v) const {
+        return position[u] == position[v];
+    }
+
+    EdgeWeight cutValue() const {
+        return cut;
+    }
+
+    // edges of the cactus, given as pairs of cactus vertices. removing an
+    // edge of weight cutValue() or two edges of a cycle gives a minimum cut
+    const std::vector<cactus_edge>& cutEdges() const {
+        return edges;
+    }
+
+    NodeID cactusVertex(NodeID v) const {
+        return position[v];
+    }
+
+    NodeID numCactusVertices() const {
+        return cactus_vertices;
+    }
+
+    // number of the update that published this snapshot
+    uint64_t version() const {
+        return snapshot_version;
+    }
+
+ private:
+    EdgeWeight cut;
+    uint64_t snapshot_version;
+    NodeID cactus_vertices;
+    std::vector<NodeID> position;
+    std::vector<cactus_edge> edges;
+};
+
+typedef std::shared_ptr<const cactus_snapshot> cactusSnapshotPtr;
@@ -11,6 +11,14 @@
 
 #pragma once
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
 #include <tuple>
 #include <unordered_set>
 #include <vector>
@@ -21,9 +29,13 @@
 #include "algorithms/global_mincut/cactus/cactus_mincut.h"
 #endif
 
+#include "algorithms/global_mincut/dynamic/balanced_cut_index.h"
+#include "algorithms/global_mincut/dynamic/cactus_cache.h"
 #include "algorithms/global_mincut/dynamic/cactus_path.h"
+#include "algorithms/global_mincut/dynamic/cactus_snapshot.h"
 #include "common/definitions.h"
 #include "data_structure/mutable_graph.h"
+#include "io/graph_io.h"
 #include "tlx/logger.hpp"
 #include "tools/timer.h"
 
@@ -34,16 +46,20 @@ class dynamic_mincut {
     mutableGraphPtr out_cactus;
     EdgeWeight current_cut;
     size_t flow_problem_id;
-    size_t max_cache_size = 1000;
     size_t callsOfStaticAlgorithm;
 
-    size_t numCachedMincuts;
-    EdgeWeight lowestCachedMincut;
-    std::vector<mutableGraphPtr> cachedCactus;
-    std::vector<std::vector<std::tuple<NodeID, NodeID, EdgeWeight> > >
-    cachedInserts;
-    std::vector<bool> currentlyCaching;
+    cactus_cache cache;
     push_relabel<true, false> pr;
+    balanced_cut_index balanced;
+
+    // latest published cactus, read by other threads with atomic_load
+    cactusSnapshotPtr snapshot;
+    uint64_t num_updates;
+
+    // first words of a checkpoint file
+    static constexpr uint64_t checkpoint_magic = 0x434d4e5944435600;
+    static constexpr uint64_t checkpoint_version = 2;
+    static constexpr size_t checkpoint_header = 6;
 
 #ifdef PARALLEL
     parallel_cactus<mutableGraphPtr> cactus;
@@ -52,7 +68,7 @@ class dynamic_mincut {
 #endif
 
  public:
-    dynamic_mincut() {
+    dynamic_mincut() : num_updates(0) {
         verbose = configuration::getConfig()->verbose;
     }
 
@@ -61,27 +77,123 @@ class dynamic_mincut {
     EdgeWeight initialize(mutableGraphPtr graph) {
         timer t;
         auto [cut, outgraph, balanced] = cactus.findAllMincuts(graph);
-        numCachedMincuts = 0;
         callsOfStaticAlgorithm = 1;
-        lowestCachedMincut = UNDEFINED_EDGE;
+        cache = cactus_cache();
         original_graph = graph;
         out_cactus = outgraph;
         current_cut = cut;
         flow_problem_id = random_functions::next();
         LOGC(verbose) << "initialize t " << t.elapsed() << " cut " << cut
                       << " cactus_vtcs " << outgraph->n();
+        publishSnapshot();
         return cut;
     }
 
+    // Writes the complete state to a file of 64 bit words, which can be
+    // memory-mapped by loadCheckpoint. Graphs are stored in the format of
+    // mutable_graph::serialize. position is returned when the checkpoint is
+    // loaded, e.g. the number of updates processed so far.
+    void saveCheckpoint(const std::string& path, uint64_t position) {
+        std::ofstream f(path, std::ios::binary);
+        if (!f) {
+            LOG1 << "Error: could not open checkpoint file " << path;
+            exit(1);
+        }
+
+        auto write = [&f](const std::vector<uint64_t>& words) {
+            f.write(reinterpret_cast<const char*>(words.data()),
+                    words.size() * sizeof(uint64_t));
+        };
+
+        write({ checkpoint_magic, checkpoint_version, position, current_cut,
+                flow_problem_id, callsOfStaticAlgorithm });
+        for (mutableGraphPtr G : { original_graph, out_cactus }) {
+            std::vector<uint64_t> serial = G->serialize();
+            write({ serial.size() });
+            write(serial);
+        }
+        std::vector<uint64_t> cached;
+        cache.serialize(&cached);
+        write(cached);
+        // e.g. a full disk, which would leave a truncated checkpoint
+        f.flush();
+        if (!f) {
+            LOG1 << "Error: could not write checkpoint file " << path;
+            exit(1);
+        }
+        f.close();
+        if (!f) {
+            LOG1 << "Error: could not close checkpoint file " << path;
+            exit(1);
+        }
+        LOGC(verbose) << "wrote checkpoint " << path << " at " << position;
+    }
+
+    // restores the state written by saveCheckpoint and returns its position
+    uint64_t loadCheckpoint(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0) {
+            LOG1 << "Error: could not open checkpoint file " << path;
+            exit(1);
+        }
+
+        size_t words = st.st_size / sizeof(uint64_t);
+        void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (words < checkpoint_header || mapped == MAP_FAILED) {
+            LOG1 << "Error: could not map checkpoint file " << path;
+            exit(1);
+        }
+
+        const uint64_t* data = static_cast<const uint64_t*>(mapped);
+        if (data[0] != checkpoint_magic || data[1] != checkpoint_version) {
+            LOG1 << "Error: " << path << " is not a dynamic mincut checkpoint";
+            exit(1);
+        }
+
+        uint64_t position = data[2];
+        current_cut = data[3];
+        flow_problem_id = data[4];
+        callsOfStaticAlgorithm = data[5];
+
+        size_t pos = checkpoint_header;
+        std::vector<mutableGraphPtr> graphs;
+        for (size_t i = 0; i < 2; ++i) {
+            if (pos >= words || pos + 1 + data[pos] > words) {
+                LOG1 << "Error: checkpoint file " << path << " is truncated";
+                exit(1);
+            }
+            graphs.emplace_back(mutable_graph::deserialize(data + pos + 1));
+            pos += 1 + data[pos];
+        }
+        original_graph = graphs[0];
+        out_cactus = graphs[1];
+
+        cache = cactus_cache();
+        if (pos < words && cache.deserialize(data + pos, words - pos) == 0) {
+            LOG1 << "Error: checkpoint file " << path << " is truncated";
+            exit(1);
+        }
+
+        munmap(mapped, st.st_size);
+        close(fd);
+        LOGC(verbose) << "loaded checkpoint " << path << " at " << position
+                      << " cut " << current_cut
+                      << " cactus_vtcs " << out_cactus->n();
+        num_updates = position;
+        publishSnapshot();
+        return position;
+    }
+
     void checkCacheAndRecompute() {
         EdgeWeight mincut = UNDEFINED_NODE;
-        if (lowestCachedMincut != UNDEFINED_EDGE) {
+        if (!cache.empty()) {
             noi_minimum_cut<mutableGraphPtr> noi;
             mincut = noi.perform_minimum_cut(original_graph);
         }
 
-        if (mincut == lowestCachedMincut &&
-            2 * cachedInserts.size() < cachedCactus[mincut]->n()) {
+        if (mincut == cache.lowestCut() &&
+            2 * cache.lowestInserts() < cache.lowestCactusVertices()) {
             buildCactusFromCache(mincut);
         } else {
             auto [cut, outg, b] = cactus.findAllMincuts(
@@ -98,6 +210,7 @@ class dynamic_mincut {
         NodeID tCactusPos = out_cactus->getCurrentPosition(t);
         original_graph->new_edge_order(s, t, w);
         cacheEdge(s, t, w);
+        num_updates++;
         if (sCactusPos != tCactusPos) {
             if (current_cut == 0) {
                 if (out_cactus->n() == 2) {
@@ -118,64 +231,36 @@ class dynamic_mincut {
                     contractVertexSet(out_cactus, vtxset);
                 }
             }
+            publishSnapshot();
         }
         // LOGC(verbose) << "t " << timer.elapsed() << " cut " << current_cut
         //              << " vtcs_in_cactus " << out_cactus->n();
         if (configuration::getConfig()->find_most_balanced_cut) {
-            most_balanced_minimum_cut<mutableGraphPtr> mb;
-            mb.findCutFromCactus(out_cactus, current_cut, original_graph);
+            updateMostBalancedCut(s, t, true);
         }
         return current_cut;
     }
 
     void buildCactusFromCache(EdgeWeight mincut) {
-        numCachedMincuts--;
-        currentlyCaching[mincut] = false;
-        if (numCachedMincuts == 0) {
-            lowestCachedMincut = UNDEFINED_EDGE;
-        } else {
-            for (size_t i = mincut + 1; i < currentlyCaching.size(); ++i) {
-                if (currentlyCaching[i]) {
-                    lowestCachedMincut = i;
-                    break;
-                }
-            }
-
-            if (cachedInserts[mincut].size()
-                + cachedInserts[lowestCachedMincut].size() > max_cache_size) {
-                if (numCachedMincuts > 0) {
-                    // delete all larger mincut cacti by shrinking the vector
-                    cachedCactus.resize(mincut + 1);
-                    cachedInserts.resize(mincut + 1);
-                    currentlyCaching.resize(mincut + 1);
-                    numCachedMincuts = 0;
-                }
-                lowestCachedMincut = UNDEFINED_EDGE;
-            } else {
-                for (auto x : cachedInserts[mincut]) {
-                    cachedInserts[lowestCachedMincut].emplace_back(x);
-                }
-            }
-        }
-
-        for (auto [s, t, w] : cachedInserts[mincut]) {
-            NodeID sCactusPos = cachedCactus[mincut]->getCurrentPosition(s);
-            NodeID tCactusPos = cachedCactus[mincut]->getCurrentPosition(t);
+        auto [cached, inserts] = cache.takeLowest();
+        for (auto [s, t, w] : inserts) {
+            NodeID sCactusPos = cached->getCurrentPosition(s);
+            NodeID tCactusPos = cached->getCurrentPosition(t);
             if (sCactusPos != tCactusPos) {
                 auto vtxset = cactus_path::findPath(
-                    cachedCactus[mincut], sCactusPos, tCactusPos, current_cut);
-                if (vtxset.size() == cachedCactus[mincut]->n()) {
+                    cached, sCactusPos, tCactusPos, current_cut);
+                if (vtxset.size() == cached->n()) {
                     auto [cut, outg, b] = cactus.findAllMincuts(original_graph);
                     callsOfStaticAlgorithm++;
                     out_cactus = outg;
                     current_cut = cut;
                     return;
                 } else {
-                    contractVertexSet(cachedCactus[mincut], vtxset);
+                    contractVertexSet(cached, vtxset);
                 }
             }
         }
-        out_cactus = cachedCactus[mincut];
+        out_cactus = cached;
         current_cut = mincut;
     }
 
@@ -261,6 +346,7 @@ class dynamic_mincut {
 
         EdgeWeight wgt = original_graph->getEdgeWeight(s, eToT);
         original_graph->deleteEdge(s, eToT);
+        num_updates++;
         NodeID sCactusPos = out_cactus->getCurrentPosition(s);
         NodeID tCactusPos = out_cactus->getCurrentPosition(t);
 
@@ -288,6 +374,7 @@ class dynamic_mincut {
             auto new_g = rc.decrementalRebuild(original_graph, s, flow, fpid);
             current_cut = flow;
             out_cactus = new_g;
+            publishSnapshot();
         } else {
             size_t fp = flow_problem_id++;
             auto [flow, sourceset] = pr.solve_max_flow_min_cut(
@@ -299,6 +386,7 @@ class dynamic_mincut {
                 auto new_g = rc.decrementalRebuild(original_graph, s, flow, fp);
                 current_cut = flow;
                 out_cactus = new_g;
+                publishSnapshot();
                 LOGC(verbose) << "recomputing, minimum cut changed to " << flow;
             }
         }
@@ -307,10 +395,41 @@ class dynamic_mincut {
                       << " m " << original_graph->m();
 
         if (configuration::getConfig()->find_most_balanced_cut) {
+            updateMostBalancedCut(s, t, false);
+        }
+        return current_cut;
+    }
+
+    // the index is rebuilt when the cactus was recomputed and otherwise only
+    // contracts the cactus path of an inserted edge. Conductance depends on
+    // vertex degrees, which change with every update, so it is recomputed.
+    void updateMostBalancedCut(NodeID s, NodeID t, bool inserted) {
+        auto cfg = configuration::getConfig();
+        if (cfg->find_lowest_conductance) {
             most_balanced_minimum_cut<mutableGraphPtr> mb;
             mb.findCutFromCactus(out_cactus, current_cut, original_graph);
+            return;
         }
-        return current_cut;
+
+        if (balanced.cactus() != out_cactus) {
+            balanced.build(out_cactus, current_cut);
+        } else if (inserted) {
+            balanced.addEdge(s, t);
+        }
+
+        if (cfg->output_path != "") {
+            for (NodeID n : original_graph->nodes()) {
+                original_graph->setNodeInCut(n, false);
+            }
+            for (NodeID n : balanced.bestSide()) {
+                original_graph->setNodeInCut(n, true);
+            }
+            graph_io::writeCut(original_graph, cfg->output_path);
+        }
+    }
+
+    EdgeWeight getMostBalancedCutWeight() {
+        return balanced.bestWeight();
     }
 
     mutableGraphPtr getOriginalGraph() {
@@ -329,40 +448,29 @@ class dynamic_mincut {
         return current_cut;
     }
 
-    void putIntoCache(mutableGraphPtr cactusToCache, EdgeWeight cactusCut) {
-        numCachedMincuts++;
-        if (cactusCut < lowestCachedMincut) {
-            lowestCachedMincut = cactusCut;
-        }
+    // Returns the latest published cactus. Safe to call from any thread
+    // while updates are applied, the returned snapshot stays valid and
+    // unchanged for as long as the caller holds it. Snapshots are only
+    // published if configuration::cactus_snapshots is set.
+    cactusSnapshotPtr getSnapshot() const {
+        return std::atomic_load(&snapshot);
+    }
 
-        if (cachedCactus.size() < cactusCut + 1) {
-            cachedCactus.resize(cactusCut + 1);
-            cachedInserts.resize(cactusCut + 1);
-            currentlyCaching.resize(cactusCut + 1, false);
-        }
+    // copies the current cactus into a new snapshot and replaces the
+    // published one, readers holding the previous snapshot are not affected
+    void publishSnapshot() {
+        if (!configuration::getConfig()->cactus_snapshots)
+            return;
+        cactusSnapshotPtr next = std::make_shared<const cactus_snapshot>(
+            out_cactus, current_cut, num_updates);
+        std::atomic_store(&snapshot, next);
+    }
 
-        cachedCactus[cactusCut] = cactusToCache;
-        cachedInserts[cactusCut].clear();
-        currentlyCaching[cactusCut] = true;
+    void putIntoCache(mutableGraphPtr cactusToCache, EdgeWeight cactusCut) {
+        cache.put(cactusToCache, cactusCut);
     }
 
     void cacheEdge(NodeID s, NodeID t, EdgeWeight wgt) {
-        if (numCachedMincuts > 0
-            && cachedInserts[lowestCachedMincut].size() <= max_cache_size) {
-            cachedInserts[lowestCachedMincut].emplace_back(s, t, wgt);
-        } else {
-            if (numCachedMincuts > 0) {
-                numCachedMincuts--;
-                currentlyCaching[lowestCachedMincut] = false;
-                if (numCachedMincuts > 0) {
-                    // delete all larger mincut cacti by shrinking the vector
-                    cachedCactus.resize(lowestCachedMincut + 1);
-                    cachedInserts.resize(lowestCachedMincut + 1);
-                    currentlyCaching.resize(lowestCachedMincut + 1);
-                    numCachedMincuts = 0;
-                }
-                lowestCachedMincut = UNDEFINED_EDGE;
-            }
-        }
+        cache.addEdge(s, t, wgt);
     }
 };
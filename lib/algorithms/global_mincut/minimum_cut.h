@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 
 #include "common/definitions.h"
@@ -36,22 +37,38 @@ class minimum_cut {
         return perform_minimum_cut();
     }
 
+    // Decides whether the graph is k-edge-connected. Returns the value of a
+    // cut smaller than k, which is not necessarily minimal, if there is one
+    // and k otherwise. Algorithms without a threshold mode compute the
+    // minimum cut.
+    virtual EdgeWeight perform_minimum_cut_threshold(graphAccessPtr G,
+                                                     EdgeWeight k) {
+        return std::min(perform_minimum_cut(G), k);
+    }
+
+    virtual EdgeWeight perform_minimum_cut_threshold(mutableGraphPtr G,
+                                                     EdgeWeight k) {
+        return std::min(perform_minimum_cut(G), k);
+    }
+
     virtual EdgeWeight perform_minimum_cut() {
 #ifdef PARALLEL
         LOG1 << "Please select a parallel minimum cut"
-             << " algorithm [inexact, exact, cactus]!";
+             << " algorithm [inexact, exact, cactus, approx]!";
         LOG1 << "inexact - Run heuristic VieCut algorithm";
         LOG1 << "exact - Run shared-memory exact algorithm";
         LOG1 << "cactus - Find all minimum cuts and build cactus graph!";
+        LOG1 << "approx - (1+eps)-approximation by skeleton sampling";
 #else
         LOG1 << "Please select a minimum cut global_mincut"
-             << " [vc, noi, pr, matula, ks, cactus]!";
+             << " [vc, noi, pr, matula, ks, cactus, approx]!";
         LOG1 << "vc - Run heuristic VieCut algorithm";
         LOG1 << "noi - Run algorithm of Nagamochi, Ono and Ibaraki";
         LOG1 << "pr - Repeated run of routines of Padberg and Rinaldi";
         LOG1 << "matula - Run algorithm of Matula";
         LOG1 << "ks - Run algorithm of Karger and Stein";
         LOG1 << "cactus - Find all minimum cuts and build cactus graph!";
+        LOG1 << "approx - (1+eps)-approximation by skeleton sampling";
 #endif
         exit(1);
         return 42;
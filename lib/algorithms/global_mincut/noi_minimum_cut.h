@@ -32,6 +32,7 @@
 #include "data_structure/priority_queues/maxNodeHeap.h"
 #include "data_structure/priority_queues/node_bucket_pq.h"
 #include "data_structure/priority_queues/vecMaxNodeHeap.h"
+#include "tools/instrumentation.h"
 #include "tools/random_functions.h"
 #include "tools/timer.h"
 
@@ -59,6 +60,22 @@ class noi_minimum_cut : public minimum_cut {
     }
 
     EdgeWeight perform_minimum_cut(GraphPtr G, bool indirect) {
+        return perform_minimum_cut(G, indirect, UNDEFINED_EDGE);
+    }
+
+    EdgeWeight perform_minimum_cut_threshold(GraphPtr G, EdgeWeight k) {
+        if (!G) {
+            return -1;
+        }
+        return std::min(perform_minimum_cut(G, false, k), k);
+    }
+
+    // Stops as soon as a cut smaller than threshold is found. As long as
+    // there is none, capforest contracts all edges with connectivity of at
+    // least threshold, which still keeps all cuts below threshold.
+    // threshold UNDEFINED_EDGE computes the minimum cut.
+    EdgeWeight perform_minimum_cut(GraphPtr G, bool indirect,
+                                   EdgeWeight threshold) {
         if (!G) {
             return -1;
         }
@@ -69,8 +86,13 @@ class noi_minimum_cut : public minimum_cut {
         graphs.push_back(G);
         minimum_cut_helpers<GraphPtr>::setInitialCutValues(graphs);
 
-        while (graphs.back()->number_of_nodes() > 2 && mincut > 0) {
-            auto uf = modified_capforest(graphs.back(), mincut);
+        bool exact = (threshold == UNDEFINED_EDGE);
+        while (graphs.back()->number_of_nodes() > 2 && mincut > 0
+               && (exact || mincut >= threshold)) {
+            instrumentation::addLevel("noi", graphs.size() - 1,
+                                      graphs.back()->n(), graphs.back()->m());
+            auto uf = modified_capforest(graphs.back(),
+                                         std::min(mincut, threshold));
             graphs.emplace_back(
                 contraction::fromUnionFind(graphs.back(), &uf, true));
             mincut = minimum_cut_helpers<GraphPtr>::updateCut(graphs, mincut);
@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <omp.h>
+
 #include <algorithm>
 #include <cstdint>
 #include <cstdlib>
@@ -23,13 +25,14 @@
 #include "algorithms/global_mincut/minimum_cut.h"
 #include "algorithms/global_mincut/minimum_cut_helpers.h"
 #include "algorithms/global_mincut/noi_minimum_cut.h"
+#include "algorithms/misc/parallel_biconnectivity.h"
 #include "algorithms/misc/strongly_connected_components.h"
 #include "common/definitions.h"
 #include "data_structure/flow_graph.h"
 #include "data_structure/graph_access.h"
 #include "tlx/logger.hpp"
 #include "tools/graph_extractor.h"
-#include "tools/timer.h"
+#include "tools/instrumentation.h"
 
 #ifdef PARALLEL
 #include "parallel/coarsening/contract_graph.h"
@@ -46,7 +49,6 @@ class viecut : public minimum_cut {
  public:
     typedef GraphPtr GraphPtrType;
     static constexpr bool debug = false;
-    bool timing = configuration::getConfig()->verbose;
     viecut() { }
 
     virtual ~viecut() { }
@@ -57,6 +59,20 @@ class viecut : public minimum_cut {
 
     EdgeWeight perform_minimum_cut(GraphPtr G,
                                    bool indirect) {
+        return perform_minimum_cut(G, indirect, UNDEFINED_EDGE);
+    }
+
+    EdgeWeight perform_minimum_cut_threshold(GraphPtr G, EdgeWeight k) {
+        if (!G) {
+            return -1;
+        }
+        return std::min(perform_minimum_cut(G, false, k), k);
+    }
+
+    // stops as soon as a cut smaller than threshold is found, see
+    // noi_minimum_cut. threshold UNDEFINED_EDGE computes the minimum cut
+    EdgeWeight perform_minimum_cut(GraphPtr G, bool indirect,
+                                   EdgeWeight threshold) {
         if (!G) {
             return -1;
         }
@@ -66,51 +82,61 @@ class viecut : public minimum_cut {
         graphs.push_back(G);
 
         minimum_cut_helpers<GraphPtr>::setInitialCutValues(graphs);
+        if (configuration::getConfig()->bridge_cut) {
+            phase_timer t("viecut/bridges");
+            parallel_biconnectivity<GraphPtr> bcc(G, omp_get_max_threads());
+            if (bcc.findAllBridges()) {
+                cut = bcc.bridgeCut(cut, configuration::getConfig()->save_cut);
+            }
+        }
+        instrumentation::addLevel("viecut", 0, G->n(), G->m());
 
-        while (graphs.back()->number_of_nodes() > 10000 &&
+        bool exact = (threshold == UNDEFINED_EDGE);
+        while ((exact || cut >= threshold) &&
+               graphs.back()->number_of_nodes() > 10000 &&
                (graphs.size() == 1 ||
                 (graphs.back()->number_of_nodes() <
                  graphs[graphs.size() - 2]->number_of_nodes()))) {
-            timer t;
+            phase_timer t;
             G = graphs.back();
             label_propagation<GraphPtr> lp;
             std::vector<NodeID> cluster_mapping = lp.propagate_labels(G);
             auto [mapping, reverse_mapping] =
                 minimum_cut_helpers<GraphPtr>::remap_cluster(
                     G, cluster_mapping);
-            LOGC(timing) << "LP (total): " << t.elapsedToZero();
+            t.lap("viecut/label propagation");
 
             contraction::findTrivialCuts(G, &mapping, &reverse_mapping, cut);
-            LOGC(timing) << "Trivial Cut Local Search: " << t.elapsedToZero();
+            t.lap("viecut/trivial cut local search");
 
             auto H = contraction::contractGraph(G, mapping, reverse_mapping);
             graphs.push_back(H);
             cut = minimum_cut_helpers<GraphPtr>::updateCut(graphs, cut);
-            LOGC(timing) << "Graph Contraction (to "
-                         << graphs.back()->number_of_nodes()
-                         << " nodes): " << t.elapsedToZero();
+            t.lap("viecut/contraction");
+            if (!exact && cut < threshold)
+                break;
 
-            union_find uf = tests::prTests12(graphs.back(), cut);
+            union_find uf = tests::prTests12(graphs.back(),
+                                             std::min(cut, threshold));
             graphs.push_back(
                 contraction::fromUnionFind(graphs.back(), &uf, true));
             cut = minimum_cut_helpers<GraphPtr>::updateCut(graphs, cut);
-            union_find uf2 = tests::prTests34(graphs.back(), cut);
+            union_find uf2 = tests::prTests34(graphs.back(),
+                                              std::min(cut, threshold));
             graphs.push_back(
                 contraction::fromUnionFind(graphs.back(), &uf2, true));
             cut = minimum_cut_helpers<GraphPtr>::updateCut(graphs, cut);
-            LOGC(timing) << "Padberg-Rinaldi Tests (to "
-                         << graphs.back()->number_of_nodes()
-                         << " nodes): " << t.elapsedToZero();
+            t.lap("viecut/padberg-rinaldi tests");
+            instrumentation::addLevel("viecut", graphs.size() - 1,
+                                      graphs.back()->n(), graphs.back()->m());
         }
 
-        if (graphs.back()->number_of_nodes() > 1) {
-            timer t;
+        if (graphs.back()->number_of_nodes() > 1
+            && (exact || cut >= threshold)) {
+            phase_timer t("viecut/exact algorithm");
             noi_minimum_cut<GraphPtr> noi;
-            cut = std::min(cut, noi.perform_minimum_cut(graphs.back(), true));
-
-            LOGC(timing) << "Exact Algorithm:"
-                         << t.elapsedToZero() << " deg: "
-                         << graphs.back()->getMinDegree();
+            cut = std::min(cut, noi.perform_minimum_cut(graphs.back(), true,
+                                                        threshold));
         }
 
         if (!indirect && configuration::getConfig()->save_cut)
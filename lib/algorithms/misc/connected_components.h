@@ -0,0 +1,226 @@
+/******************************************************************************
+ * connected_components.h
+ *
+ * Source of VieCut
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#pragma once
+
+#include <omp.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "common/definitions.h"
+#include "data_structure/graph_access.h"
+#include "data_structure/mutable_graph.h"
+#include "tlx/logger.hpp"
+#include "tools/graph_extractor.h"
+
+// Parallel connected components of an undirected graph, following the
+// Afforest algorithm of Sutton et al. (https://arxiv.org/abs/1805.05547):
+// union-find hooking on the first few neighbors of every vertex, then skip
+// the (very likely) largest component while linking all remaining edges.
+// Component ids are ordered by the smallest vertex in each component.
+class connected_components {
+ public:
+    static constexpr bool debug = false;
+    // number of neighbor rounds in the sampling phase
+    static constexpr size_t neighbor_rounds = 2;
+    // number of samples to find the largest intermediate component
+    static constexpr size_t num_samples = 1024;
+
+    template <class GraphPtr>
+    static std::tuple<std::vector<int>, size_t, std::vector<size_t> >
+    components(GraphPtr G) {
+        std::vector<NodeID> parent(G->n());
+
+#pragma omp parallel for
+        for (NodeID n = 0; n < G->n(); ++n) {
+            parent[n] = n;
+        }
+
+        for (size_t r = 0; r < neighbor_rounds; ++r) {
+#pragma omp parallel for schedule(dynamic, 1024)
+            for (NodeID n = 0; n < G->n(); ++n) {
+                EdgeID e = G->get_first_edge(n) + r;
+                if (e < G->get_first_invalid_edge(n)) {
+                    link(n, G->getEdgeTarget(n, e), &parent);
+                }
+            }
+            compress(&parent);
+        }
+
+        NodeID frequent = sampleFrequentComponent(parent);
+
+#pragma omp parallel for schedule(dynamic, 1024)
+        for (NodeID n = 0; n < G->n(); ++n) {
+            if (parent[n] == frequent)
+                continue;
+
+            EdgeID start = std::min(G->get_first_edge(n) + neighbor_rounds,
+                                    G->get_first_invalid_edge(n));
+            for (EdgeID e : G->edges_of_starting_at(n, start)) {
+                link(n, G->getEdgeTarget(n, e), &parent);
+            }
+        }
+        compress(&parent);
+
+        return relabel(parent, frequent);
+    }
+
+    static graphAccessPtr largest_cc(graphAccessPtr G) {
+        auto [comp, ct, blocksizes] = components(G);
+        LOG << "count of connected components: " << ct;
+
+        auto max_it = std::max_element(blocksizes.begin(), blocksizes.end());
+        int max_comp = static_cast<int>(max_it - blocksizes.begin());
+
+#pragma omp parallel for
+        for (NodeID n = 0; n < G->n(); ++n) {
+            G->setPartitionIndex(n, comp[n] == max_comp ? 0 : 1);
+        }
+
+        graph_extractor ge;
+        return ge.extract_block(G, 0).first;
+    }
+
+ private:
+    // hooks the higher root to the lower one, as in Afforest. As roots only
+    // ever point to smaller vertices, the root of each component is its
+    // smallest vertex once the algorithm terminates.
+    static void link(NodeID u, NodeID v, std::vector<NodeID>* p) {
+        std::vector<NodeID>& parent = *p;
+        NodeID p1 = parent[u];
+        NodeID p2 = parent[v];
+
+        while (p1 != p2) {
+            NodeID high = std::max(p1, p2);
+            NodeID low = std::min(p1, p2);
+            NodeID p_high = parent[high];
+
+            if (p_high == low)
+                break;
+
+            if (p_high == high
+                && __sync_bool_compare_and_swap(&parent[high], high, low))
+                break;
+
+            p1 = parent[parent[high]];
+            p2 = parent[low];
+        }
+    }
+
+    static void compress(std::vector<NodeID>* p) {
+        std::vector<NodeID>& parent = *p;
+#pragma omp parallel for schedule(dynamic, 16384)
+        for (NodeID n = 0; n < parent.size(); ++n) {
+            while (parent[n] != parent[parent[n]]) {
+                parent[n] = parent[parent[n]];
+            }
+        }
+    }
+
+    static NodeID sampleFrequentComponent(const std::vector<NodeID>& parent) {
+        if (parent.empty())
+            return UNDEFINED_NODE;
+
+        std::unordered_map<NodeID, size_t> sample_counts;
+        std::mt19937 mt(0);
+        std::uniform_int_distribution<NodeID> dist(0, parent.size() - 1);
+        for (size_t i = 0; i < num_samples; ++i) {
+            ++sample_counts[parent[dist(mt)]];
+        }
+
+        auto most_frequent = std::max_element(
+            sample_counts.begin(), sample_counts.end(),
+            [](const auto& a, const auto& b) {
+                return a.second < b.second;
+            });
+
+        LOG << "Largest intermediate component " << most_frequent->first
+            << " contains approx. "
+            << (most_frequent->second * 100 / num_samples) << "% of vertices";
+
+        return most_frequent->first;
+    }
+
+    static std::tuple<std::vector<int>, size_t, std::vector<size_t> >
+    relabel(const std::vector<NodeID>& parent, NodeID frequent) {
+        std::vector<int> component(parent.size());
+        std::vector<size_t> thread_roots(omp_get_max_threads() + 1, 0);
+        std::vector<size_t> blocksizes;
+        size_t num_comp = 0;
+
+#pragma omp parallel
+        {
+            size_t t = omp_get_thread_num();
+            size_t num_threads = omp_get_num_threads();
+            size_t begin = parent.size() * t / num_threads;
+            size_t end = parent.size() * (t + 1) / num_threads;
+
+            // roots are the smallest vertex in their component
+            for (size_t n = begin; n < end; ++n) {
+                if (parent[n] == n) {
+                    ++thread_roots[t + 1];
+                }
+            }
+
+#pragma omp barrier
+#pragma omp single
+            {
+                for (size_t i = 1; i <= num_threads; ++i) {
+                    thread_roots[i] += thread_roots[i - 1];
+                }
+                num_comp = thread_roots[num_threads];
+                blocksizes.resize(num_comp, 0);
+            }
+
+            int next_id = static_cast<int>(thread_roots[t]);
+            for (size_t n = begin; n < end; ++n) {
+                if (parent[n] == n) {
+                    component[n] = next_id++;
+                }
+            }
+
+#pragma omp barrier
+            // the largest component is counted thread-locally to avoid
+            // contention on its counter
+            size_t frequent_size = 0;
+#pragma omp for
+            for (size_t n = 0; n < parent.size(); ++n) {
+                if (parent[n] == frequent) {
+                    ++frequent_size;
+                } else {
+                    component[n] = component[parent[n]];
+#pragma omp atomic
+                    ++blocksizes[component[n]];
+                }
+            }
+
+            if (frequent_size > 0) {
+#pragma omp atomic
+                blocksizes[component[frequent]] += frequent_size;
+            }
+
+#pragma omp barrier
+#pragma omp for
+            for (size_t n = 0; n < parent.size(); ++n) {
+                if (parent[n] == frequent) {
+                    component[n] = component[frequent];
+                }
+            }
+        }
+
+        return std::make_tuple(component, num_comp, blocksizes);
+    }
+};
@@ -11,13 +11,16 @@
 
 #pragma once
 
+#include <omp.h>
 #include <stdlib.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
+#include <numeric>
 #include <vector>
 
-#include "algorithms/misc/strongly_connected_components.h"
+#include "algorithms/misc/connected_components.h"
 #include "common/definitions.h"
 #include "data_structure/graph_access.h"
 #include "tlx/logger.hpp"
@@ -99,35 +102,200 @@ class core_decomposition {
         return kCores;
     }
 
+    // Level-synchronous parallel peeling in the spirit of ParK
+    // (Dasari et al., https://doi.org/10.1109/BigData.2014.7004366).
+    // In level k all remaining vertices of degree <= k are removed, which
+    // decrements the degree of their neighbors atomically. Neighbors whose
+    // degree drops to k are removed in a following subround of level k.
+    // Returns the same k_cores structure as batagelj_zaversnik, the order of
+    // vertices with equal core number is non-deterministic.
+    static k_cores parallel_peeling(graphAccessPtr G) {
+        NodeID n = G->number_of_nodes();
+        k_cores kCores(n);
+        std::vector<NodeID>& degrees = kCores.degrees;
+        std::vector<uint8_t> removed(n, false);
+        EdgeWeight max_degree = 0;
+
+#pragma omp parallel for reduction(max : max_degree)
+        for (NodeID v = 0; v < n; ++v) {
+            EdgeWeight deg = G->getUnweightedNodeDegree(v);
+            degrees[v] = static_cast<NodeID>(deg);
+            max_degree = std::max(max_degree, deg);
+        }
+
+        std::vector<NodeID> remaining(n);
+        std::iota(remaining.begin(), remaining.end(), 0);
+        std::vector<NodeID> frontier;
+
+        for (NodeID k = 0; !remaining.empty(); ++k) {
+            std::vector<NodeID> still_remaining;
+            frontier.clear();
+#pragma omp parallel
+            {
+                std::vector<NodeID> local_frontier;
+                std::vector<NodeID> local_remaining;
+#pragma omp for nowait
+                for (size_t i = 0; i < remaining.size(); ++i) {
+                    NodeID v = remaining[i];
+                    if (removed[v])
+                        continue;
+                    if (degrees[v] <= k) {
+                        local_frontier.emplace_back(v);
+                    } else {
+                        local_remaining.emplace_back(v);
+                    }
+                }
+#pragma omp critical
+                {
+                    frontier.insert(frontier.end(), local_frontier.begin(),
+                                    local_frontier.end());
+                    still_remaining.insert(still_remaining.end(),
+                                           local_remaining.begin(),
+                                           local_remaining.end());
+                }
+            }
+            remaining.swap(still_remaining);
+
+            while (!frontier.empty()) {
+#pragma omp parallel for
+                for (size_t i = 0; i < frontier.size(); ++i) {
+                    removed[frontier[i]] = true;
+                    degrees[frontier[i]] = k;
+                }
+
+                std::vector<NodeID> next_frontier;
+#pragma omp parallel
+                {
+                    std::vector<NodeID> local_next;
+#pragma omp for schedule(dynamic, 256) nowait
+                    for (size_t i = 0; i < frontier.size(); ++i) {
+                        NodeID v = frontier[i];
+                        for (EdgeID e : G->edges_of(v)) {
+                            NodeID tgt = G->getEdgeTarget(e);
+                            if (removed[tgt])
+                                continue;
+                            // only the decrement that brings the degree of
+                            // tgt down to k adds it to the next subround
+                            if (__sync_fetch_and_sub(&degrees[tgt], 1)
+                                == k + 1) {
+                                local_next.emplace_back(tgt);
+                            }
+                        }
+                    }
+#pragma omp critical
+                    {
+                        next_frontier.insert(next_frontier.end(),
+                                             local_next.begin(),
+                                             local_next.end());
+                    }
+                }
+                frontier.swap(next_frontier);
+            }
+        }
+
+        // counting sort of vertices by core number
+        kCores.buckets.resize(max_degree + 1, 0);
+        std::vector<NodeID> num_in_core(max_degree + 1, 0);
+#pragma omp parallel for
+        for (NodeID v = 0; v < n; ++v) {
+            __sync_fetch_and_add(&num_in_core[degrees[v]], 1);
+        }
+
+        for (EdgeWeight i = 1; i < max_degree + 1; ++i) {
+            kCores.buckets[i] = kCores.buckets[i - 1] + num_in_core[i - 1];
+        }
+
+        std::vector<NodeID> next_position = kCores.buckets;
+#pragma omp parallel for
+        for (NodeID v = 0; v < n; ++v) {
+            NodeID pos = __sync_fetch_and_add(&next_position[degrees[v]], 1);
+            kCores.position[v] = pos;
+            kCores.vertices[pos] = v;
+        }
+
+        return kCores;
+    }
+
+    // Extracts the largest connected component of the k-core. Vertex ids in
+    // the core graph are assigned by a parallel prefix sum over the original
+    // ids, and edges are placed in parallel into the precomputed
+    // adjacency arrays.
     static graphAccessPtr createCoreGraph(
-        k_cores kCores, NodeID k, graphAccessPtr G) {
+        const k_cores& kCores, NodeID k, graphAccessPtr G) {
         size_t min_degree = kCores.degrees[kCores.vertices[kCores.buckets[k]]];
-        std::vector<NodeID> reverse(G->number_of_nodes(), G->number_of_nodes());
-        std::vector<NodeID> core;
-        uint64_t num_edges = 0;
-
-        for (NodeID node = 0; node < G->number_of_nodes(); ++node) {
-            if (kCores.position[node] >= kCores.buckets[k]) {
-                reverse[node] = static_cast<unsigned int>(core.size());
-                core.push_back(node);
-                num_edges += kCores.degrees[
-                    kCores.vertices[kCores.position[node]]];
+        NodeID n = G->number_of_nodes();
+        std::vector<NodeID> reverse(n, n);
+        std::vector<NodeID> thread_offset(omp_get_max_threads() + 1, 0);
+        NodeID core_size = 0;
+
+#pragma omp parallel
+        {
+            size_t t = omp_get_thread_num();
+            size_t num_threads = omp_get_num_threads();
+            NodeID begin = static_cast<NodeID>(
+                static_cast<uint64_t>(n) * t / num_threads);
+            NodeID end = static_cast<NodeID>(
+                static_cast<uint64_t>(n) * (t + 1) / num_threads);
+
+            for (NodeID v = begin; v < end; ++v) {
+                if (kCores.degrees[v] >= k) {
+                    ++thread_offset[t + 1];
+                }
+            }
+#pragma omp barrier
+#pragma omp single
+            {
+                for (size_t i = 1; i <= num_threads; ++i) {
+                    thread_offset[i] += thread_offset[i - 1];
+                }
+                core_size = thread_offset[num_threads];
+            }
+
+            NodeID next_id = thread_offset[t];
+            for (NodeID v = begin; v < end; ++v) {
+                if (kCores.degrees[v] >= k) {
+                    reverse[v] = next_id++;
+                }
             }
         }
-        num_edges *= 2;
 
-        auto core_graph = std::make_shared<graph_access>();
+        std::vector<NodeID> core(core_size);
+        std::vector<EdgeID> core_degree(core_size, 0);
+#pragma omp parallel for schedule(dynamic, 1024)
+        for (NodeID v = 0; v < n; ++v) {
+            if (reverse[v] == n)
+                continue;
 
-        core_graph->start_construction((NodeID)core.size(), num_edges);
+            core[reverse[v]] = v;
+            for (EdgeID e : G->edges_of(v)) {
+                if (reverse[G->getEdgeTarget(e)] != n) {
+                    ++core_degree[reverse[v]];
+                }
+            }
+        }
 
-        for (uint32_t i = 0; i < core.size(); ++i) {
+        auto core_graph = std::make_shared<graph_access>();
+        core_graph->start_construction(core_size, 0);
+        std::vector<EdgeID> next_edge(core_size);
+        EdgeID num_edges = 0;
+        for (NodeID i = 0; i < core_size; ++i) {
+            next_edge[i] = num_edges;
+            num_edges += core_degree[i];
+            core_graph->new_node_hacky(num_edges);
+        }
+        core_graph->resize_m(num_edges);
+
+#pragma omp parallel for schedule(dynamic, 1024)
+        for (NodeID i = 0; i < core_size; ++i) {
             NodeID node = core[i];
-            core_graph->new_node();
             for (EdgeID e : G->edges_of(node)) {
                 NodeID target = reverse[G->getEdgeTarget(e)];
-                if (target != G->number_of_nodes()) {
-                    EdgeID new_e = core_graph->new_edge(i, target);
-                    core_graph->setEdgeWeight(new_e, G->getEdgeWeight(e));
+                // every edge is placed once, together with its reverse
+                if (target != n && target > i) {
+                    EdgeID e_for = __sync_fetch_and_add(&next_edge[i], 1);
+                    EdgeID e_rev = __sync_fetch_and_add(&next_edge[target], 1);
+                    core_graph->new_edge_and_reverse(
+                        i, target, e_for, e_rev, G->getEdgeWeight(e));
                 }
             }
         }
@@ -140,9 +308,6 @@ class core_decomposition {
             exit(1);
         }
 
-        std::vector<int> components(core_graph->number_of_nodes());
-        strongly_connected_components scc;
-
-        return scc.largest_scc(core_graph);
+        return connected_components::largest_cc(core_graph);
     }
 };
@@ -10,8 +10,12 @@
  *****************************************************************************/
 #pragma once
 
+#include <omp.h>
+
 #include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -20,6 +24,7 @@
 #include "algorithms/multicut/multicut_problem.h"
 #include "common/configuration.h"
 #include "data_structure/mutable_graph.h"
+#include "data_structure/sorted_adjacency.h"
 #include "data_structure/union_find.h"
 
 // from boost::hash
@@ -39,8 +44,8 @@ class equal_neighborhood {
     equal_neighborhood() { }
 
     void findEqualNeighborhoodsNonNeighbors(
-        problemPointer problem,
-        const std::vector<bool>& active, union_find* uf) {
+        problemPointer problem, const std::vector<bool>& active,
+        const std::optional<sorted_adjacency>& sorted, union_find* uf) {
         mutableGraphPtr G = problem->graph;
 
         std::unordered_set<NodeID> terminals;
@@ -62,11 +67,16 @@ class equal_neighborhood {
                 configuration::getConfig()->neighborhood_degrees
                 && G->getUnweightedNodeDegree(n) > 0) {
                 std::vector<NodeID> v;
-                for (EdgeID e : G->edges_of(n)) {
-                    NodeID tgt = G->getEdgeTarget(n, e);
-                    v.emplace_back(tgt);
+                if (sorted) {
+                    v.assign(sorted->neighbors(n),
+                             sorted->neighbors(n) + sorted->degree(n));
+                } else {
+                    for (EdgeID e : G->edges_of(n)) {
+                        NodeID tgt = G->getEdgeTarget(n, e);
+                        v.emplace_back(tgt);
+                    }
+                    std::sort(v.begin(), v.end());
                 }
-                std::sort(v.begin(), v.end());
                 size_t seed = 0;
                 for (NodeID vtx : v) {
                     hash_combine(seed, vtx);
@@ -80,6 +90,15 @@ class equal_neighborhood {
                             continue;
                         }
 
+                        if (sorted) {
+                            if (sorted->degree(n) == sorted->degree(o)
+                                && equalWeightNeighbors(*sorted, n, o)
+                                == sorted->degree(n)) {
+                                uf->Union(n, o);
+                            }
+                            continue;
+                        }
+
                         std::vector<std::pair<NodeID, EdgeWeight> > ngbrs_n;
                         std::vector<std::pair<NodeID, EdgeWeight> > ngbrs_o;
 
@@ -115,8 +134,8 @@ class equal_neighborhood {
     }
 
     void findEqualNeighborhoodsNeighbors(
-        problemPointer problem,
-        const std::vector<bool>& active, union_find* uf) {
+        problemPointer problem, const std::vector<bool>& active,
+        const std::optional<sorted_adjacency>& sorted, union_find* uf) {
         mutableGraphPtr G = problem->graph;
         std::unordered_set<NodeID> terminals;
         for (const auto& t : problem->terminals) {
@@ -144,6 +163,15 @@ class equal_neighborhood {
                         == G->getUnweightedNodeDegree(o)
                         && G->getWeightedNodeDegree(n)
                         == G->getWeightedNodeDegree(o)) {
+                        if (sorted) {
+                            // neither n nor o is a neighbor of itself
+                            if (equalWeightNeighbors(*sorted, n, o)
+                                == sorted->degree(n) - 1) {
+                                uf->Union(n, o);
+                            }
+                            continue;
+                        }
+
                         std::vector<std::pair<NodeID, EdgeWeight> > ngbrs_n;
                         std::vector<std::pair<NodeID, EdgeWeight> > ngbrs_o;
 
@@ -180,15 +208,201 @@ class equal_neighborhood {
         }
     }
 
+    // parallel version of findEqualNeighborhoodsNonNeighbors. The sorted
+    // neighborhood of every candidate and its fingerprint are computed in
+    // parallel. Candidates are then distributed into buckets by the highest
+    // bits of their fingerprint, every bucket is sorted by fingerprint and
+    // the candidates with the same fingerprint are compared in parallel.
+    // As the union find is not thread-safe, equal pairs are collected and
+    // united afterwards.
+    void findEqualNeighborhoodsNonNeighborsParallel(
+        problemPointer problem, const std::vector<bool>& active,
+        union_find* uf) {
+        mutableGraphPtr G = problem->graph;
+        std::vector<bool> is_terminal(G->n(), false);
+        for (const auto& t : problem->terminals) {
+            is_terminal[t.position] = true;
+        }
+
+        std::vector<fingerprint> candidates;
+        std::vector<size_t> first_neighbor = { 0 };
+        for (NodeID n : G->nodes()) {
+            NodeID deg = G->getUnweightedNodeDegree(n);
+            if (active[G->containedVertices(n)[0]] && !is_terminal[n]
+                && deg <= configuration::getConfig()->neighborhood_degrees
+                && deg > 0) {
+                candidates.push_back({ 0, n, candidates.size() });
+                first_neighbor.emplace_back(first_neighbor.back() + deg);
+            }
+        }
+
+        if (candidates.size() < 2) {
+            return;
+        }
+
+        std::vector<std::pair<NodeID, EdgeWeight> > neighbors(
+            first_neighbor.back());
+        size_t bucket_bits = 0;
+        while ((candidates.size() >> bucket_bits) > bucket_size) {
+            ++bucket_bits;
+        }
+        size_t num_buckets = size_t { 1 } << bucket_bits;
+        std::vector<fingerprint> bucketed(candidates.size());
+        std::vector<size_t> bucket_start(num_buckets + 1, 0);
+
+        // called from branch_multicut worker threads, which do not inherit
+        // the OpenMP thread count of the main thread
+        size_t threads = std::max(configuration::getConfig()->threads,
+                               size_t { 1 });
+        std::vector<std::vector<size_t> > bucket_count(
+            threads, std::vector<size_t>(num_buckets, 0));
+        std::vector<std::vector<std::pair<NodeID, NodeID> > > equal(threads);
+
+#pragma omp parallel num_threads(threads)
+        {
+            int id = omp_get_thread_num();
+#pragma omp for schedule(static)
+            for (size_t i = 0; i < candidates.size(); ++i) {
+                NodeID n = candidates[i].vertex;
+                auto* ngbrs = neighbors.data() + first_neighbor[i];
+                size_t k = 0;
+                for (EdgeID e : G->edges_of(n)) {
+                    ngbrs[k++] = G->getEdge(n, e);
+                }
+                std::sort(ngbrs, ngbrs + k);
+                size_t seed = 0;
+                for (size_t j = 0; j < k; ++j) {
+                    hash_combine(seed, ngbrs[j].first);
+                    hash_combine(seed, ngbrs[j].second);
+                }
+                candidates[i].hash = seed;
+                bucket_count[id][bucketOf(seed, bucket_bits)]++;
+            }
+
+#pragma omp single
+            {
+                for (size_t b = 0; b < num_buckets; ++b) {
+                    bucket_start[b + 1] = bucket_start[b];
+                    for (size_t t = 0; t < threads; ++t) {
+                        size_t count = bucket_count[t][b];
+                        bucket_count[t][b] = bucket_start[b + 1];
+                        bucket_start[b + 1] += count;
+                    }
+                }
+            }
+
+            // same static schedule as above, so every thread scatters the
+            // candidates it counted
+#pragma omp for schedule(static)
+            for (size_t i = 0; i < candidates.size(); ++i) {
+                size_t b = bucketOf(candidates[i].hash, bucket_bits);
+                bucketed[bucket_count[id][b]++] = candidates[i];
+            }
+
+            std::vector<size_t> representatives;
+#pragma omp for schedule(dynamic, 16)
+            for (size_t b = 0; b < num_buckets; ++b) {
+                auto begin = bucketed.begin() + bucket_start[b];
+                auto end = bucketed.begin() + bucket_start[b + 1];
+                std::sort(begin, end, [](const auto& f1, const auto& f2) {
+                              return f1.hash < f2.hash;
+                          });
+
+                for (auto run = begin; run != end; ) {
+                    auto run_end = run + 1;
+                    while (run_end != end && run_end->hash == run->hash) {
+                        ++run_end;
+                    }
+                    // vertices with equal fingerprint are grouped by
+                    // neighborhood, to handle hash collisions
+                    representatives.clear();
+                    for (auto it = run; it != run_end; ++it) {
+                        bool found = false;
+                        for (size_t r : representatives) {
+                            if (equalNeighbors(neighbors, first_neighbor,
+                                               r, it->index)) {
+                                equal[id].emplace_back(
+                                    candidates[r].vertex, it->vertex);
+                                found = true;
+                                break;
+                            }
+                        }
+                        if (!found) {
+                            representatives.emplace_back(it->index);
+                        }
+                    }
+                    run = run_end;
+                }
+            }
+        }
+
+        for (const auto& pairs_of_thread : equal) {
+            for (const auto& [n, o] : pairs_of_thread) {
+                uf->Union(n, o);
+            }
+        }
+    }
+
     union_find findEqualNeighborhoods(
         problemPointer problem,
-        const std::vector<bool>& active) {
+        const std::vector<bool>& active,
+        bool parallel = false) {
         union_find uf(problem->graph->n());
-        findEqualNeighborhoodsNonNeighbors(problem, active, &uf);
-        findEqualNeighborhoodsNeighbors(problem, active, &uf);
+        // with sorted adjacency lists, neighborhoods are compared by
+        // intersecting them instead of sorting copies
+        std::optional<sorted_adjacency> sorted;
+        if (sorted_adjacency::enabled()) {
+            sorted.emplace(problem->graph, parallel);
+        }
+        if (parallel) {
+            findEqualNeighborhoodsNonNeighborsParallel(problem, active, &uf);
+        } else {
+            findEqualNeighborhoodsNonNeighbors(problem, active, sorted, &uf);
+        }
+        findEqualNeighborhoodsNeighbors(problem, active, sorted, &uf);
         return uf;
     }
 
  private:
+    // candidates per bucket in findEqualNeighborhoodsNonNeighborsParallel
+    static constexpr size_t bucket_size = 256;
+
+    struct fingerprint {
+        size_t hash;
+        NodeID vertex;
+        size_t index;
+    };
+
+    // highest bits of the fibonacci hash, as the highest bits of
+    // hash_combine are zero for vertices of low degree
+    static size_t bucketOf(size_t hash, size_t bucket_bits) {
+        uint64_t mixed = static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15;
+        return bucket_bits == 0 ? 0 : mixed >> (64 - bucket_bits);
+    }
+
+    static bool equalNeighbors(
+        const std::vector<std::pair<NodeID, EdgeWeight> >& neighbors,
+        const std::vector<size_t>& first_neighbor, size_t i, size_t j) {
+        size_t deg_i = first_neighbor[i + 1] - first_neighbor[i];
+        size_t deg_j = first_neighbor[j + 1] - first_neighbor[j];
+        return deg_i == deg_j
+               && std::equal(neighbors.begin() + first_neighbor[i],
+                             neighbors.begin() + first_neighbor[i + 1],
+                             neighbors.begin() + first_neighbor[j]);
+    }
+
+    // number of common neighbors of n and o that are connected to both
+    // with the same weight
+    static size_t equalWeightNeighbors(const sorted_adjacency& sorted,
+                                       NodeID n, NodeID o) {
+        size_t equal = 0;
+        sorted.intersect(n, o, [&equal](NodeID, EdgeWeight w_n,
+                                        EdgeWeight w_o) {
+                             if (w_n == w_o)
+                                 ++equal;
+                         });
+        return equal;
+    }
+
     std::unordered_multimap<size_t, NodeID> results;
 };
@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <optional>
 #include <tuple>
 #include <unordered_set>
 #include <utility>
@@ -20,6 +21,8 @@
 #include "algorithms/misc/equal_neighborhood.h"
 #include "algorithms/multicut/multicut_problem.h"
 #include "data_structure/mutable_graph.h"
+#include "data_structure/sorted_adjacency.h"
+#include "tools/simd_intersection.h"
 
 class maximal_clique {
  public:
@@ -27,6 +30,9 @@ class maximal_clique {
 
     std::vector<std::vector<NodeID> > findCliques(
         mutableGraphPtr graph) {
+        if (sorted_adjacency::enabled()) {
+            sorted.emplace(graph);
+        }
         for (NodeID n : graph->nodes()) {
             std::vector<std::pair<NodeID, EdgeWeight> > P;
             std::vector<NodeID> R = { n };
@@ -122,6 +128,57 @@ class maximal_clique {
                                external_weight, new_lightest);
     }
 
+    // same as neighborhoodIntersection with the sorted neighborhood of
+    // vertex n. As n is a common neighbor of all vertices in R, every vertex
+    // of R is in the neighborhood of n.
+    std::tuple<std::vector<std::pair<NodeID, EdgeWeight> >,
+               std::vector<std::pair<NodeID, EdgeWeight> >, size_t, EdgeWeight>
+    sortedNeighborhoodIntersection(
+        NodeID n,
+        const std::vector<std::pair<NodeID, EdgeWeight> >& P,
+        const std::vector<NodeID>& R,
+        const std::vector<std::pair<NodeID, EdgeWeight> >& X,
+        size_t external_weight,
+        EdgeWeight lightest) {
+        const NodeID* ngbrs = sorted->neighbors(n);
+        const EdgeWeight* weights = sorted->neighborWeights(n);
+        size_t degree = sorted->degree(n);
+
+        for (size_t i = 0; i < degree; ++i) {
+            external_weight += weights[i];
+        }
+
+        EdgeWeight new_lightest = lightest;
+        std::vector<std::pair<NodeID, EdgeWeight> > intersect_p;
+        std::vector<NodeID> keys = vertices(P);
+        simd_intersection::intersect(
+            ngbrs, degree, keys.data(), keys.size(),
+            [&](size_t i, size_t j) {
+                intersect_p.emplace_back(ngbrs[i], weights[i] + P[j].second);
+                new_lightest = std::min(weights[i], new_lightest);
+                external_weight -= weights[i];
+            });
+
+        std::vector<std::pair<NodeID, EdgeWeight> > intersect_x;
+        keys = vertices(X);
+        simd_intersection::intersect(
+            ngbrs, degree, keys.data(), keys.size(),
+            [&](size_t i, size_t j) {
+                intersect_x.emplace_back(ngbrs[i], weights[i] + X[j].second);
+                external_weight -= weights[i];
+            });
+
+        for (NodeID r : R) {
+            size_t i = std::lower_bound(ngbrs, ngbrs + degree, r) - ngbrs;
+            if (i < degree && ngbrs[i] == r) {
+                external_weight -= weights[i];
+            }
+        }
+
+        return std::make_tuple(intersect_p, intersect_x,
+                               external_weight, new_lightest);
+    }
+
     bool bronKerbosch(mutableGraphPtr graph,
                       std::vector<std::pair<NodeID, EdgeWeight> >* P,
                       std::vector<NodeID>* R,
@@ -144,42 +201,67 @@ class maximal_clique {
 
         NodeID n = (*P)[0].first;
         std::vector<std::pair<NodeID, EdgeWeight> > neighborhood;
-        for (EdgeID e : graph->edges_of(n)) {
-            neighborhood.emplace_back(graph->getEdge(n, e));
-        }
-        std::sort(neighborhood.begin(), neighborhood.end(), pairs);
-        size_t n_id = 0;
-        size_t p_id = 0;
         std::vector<std::pair<NodeID, EdgeWeight> > intersect;
-        while (p_id < P->size()) {
-            if (n_id == neighborhood.size() ||
-                neighborhood[n_id].first > (*P)[p_id].first) {
-                intersect.emplace_back((*P)[p_id]);
-                ++p_id;
-                continue;
+        if (sorted) {
+            // vertices of P that are not adjacent to n
+            std::vector<bool> adjacent(P->size(), false);
+            std::vector<NodeID> keys = vertices(*P);
+            simd_intersection::intersect(
+                sorted->neighbors(n), sorted->degree(n),
+                keys.data(), keys.size(), [&adjacent](size_t, size_t j) {
+                    adjacent[j] = true;
+                });
+            for (size_t i = 0; i < P->size(); ++i) {
+                if (!adjacent[i])
+                    intersect.emplace_back((*P)[i]);
             }
-
-            if (neighborhood[n_id].first < (*P)[p_id].first) {
-                ++n_id;
-                continue;
+        } else {
+            for (EdgeID e : graph->edges_of(n)) {
+                neighborhood.emplace_back(graph->getEdge(n, e));
             }
+            std::sort(neighborhood.begin(), neighborhood.end(), pairs);
+            size_t n_id = 0;
+            size_t p_id = 0;
+            while (p_id < P->size()) {
+                if (n_id == neighborhood.size() ||
+                    neighborhood[n_id].first > (*P)[p_id].first) {
+                    intersect.emplace_back((*P)[p_id]);
+                    ++p_id;
+                    continue;
+                }
+
+                if (neighborhood[n_id].first < (*P)[p_id].first) {
+                    ++n_id;
+                    continue;
+                }
 
-            n_id++;
-            p_id++;
+                n_id++;
+                p_id++;
+            }
         }
 
         for (size_t i = 0; i < intersect.size(); ++i) {
             n = intersect[i].first;
 
-            neighborhood.clear();
-            for (EdgeID e : graph->edges_of(n)) {
-                neighborhood.emplace_back(graph->getEdge(n, e));
-            }
-            std::sort(neighborhood.begin(), neighborhood.end(), pairs);
+            std::vector<std::pair<NodeID, EdgeWeight> > nextP;
+            std::vector<std::pair<NodeID, EdgeWeight> > nextX;
+            size_t current_ex_weight;
+            EdgeWeight next_lightest;
+            if (sorted) {
+                std::tie(nextP, nextX, current_ex_weight, next_lightest) =
+                    sortedNeighborhoodIntersection(n, *P, *R, *X,
+                                                   ex_weight, lightest);
+            } else {
+                neighborhood.clear();
+                for (EdgeID e : graph->edges_of(n)) {
+                    neighborhood.emplace_back(graph->getEdge(n, e));
+                }
+                std::sort(neighborhood.begin(), neighborhood.end(), pairs);
 
-            auto [nextP, nextX, current_ex_weight, next_lightest] =
-                neighborhoodIntersection(&neighborhood, P, R, X,
-                                         ex_weight, lightest);
+                std::tie(nextP, nextX, current_ex_weight, next_lightest) =
+                    neighborhoodIntersection(&neighborhood, P, R, X,
+                                             ex_weight, lightest);
+            }
             lightest = next_lightest;
 
             if (current_ex_weight >=
@@ -288,4 +370,17 @@ class maximal_clique {
     }
 
     std::vector<std::vector<NodeID> > cliques;
+
+ private:
+    static std::vector<NodeID> vertices(
+        const std::vector<std::pair<NodeID, EdgeWeight> >& v) {
+        std::vector<NodeID> ids;
+        for (const auto& [id, w] : v) {
+            (void)w;
+            ids.emplace_back(id);
+        }
+        return ids;
+    }
+
+    std::optional<sorted_adjacency> sorted;
 };
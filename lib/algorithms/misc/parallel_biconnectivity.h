@@ -0,0 +1,510 @@
+/******************************************************************************
+ * parallel_biconnectivity.h
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#pragma once
+
+#include <omp.h>
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "algorithms/multicut/multicut_problem.h"
+#include "common/definitions.h"
+
+#ifdef PARALLEL
+#include "parallel/data_structure/union_find.h"
+#else
+#include "data_structure/union_find.h"
+#endif
+
+// Articulation points and bridges following Tarjan and Vishkin. Instead of
+// a depth-first search, which is inherently sequential, this uses a
+// spanning forest found by level-synchronous parallel BFS. Subtree sizes,
+// preorder numbers and, for every subtree, the lowest and highest preorder
+// number reachable by a non-tree edge are computed level by level. These
+// replace the Euler tour and prefix sums of the original algorithm, as
+// the BFS levels already give an order in which all children of a vertex
+// are processed before or after it.
+//
+// The tree edge to vertex v is a bridge if no non-tree edge leaves the
+// subtree of v. For articulation points, tree edges are united into
+// biconnected components with a lock-free union find on the vertices
+// (vertex v represents the tree edge to its parent), and a non-root vertex
+// is an articulation point if the tree edge to one of its children is in
+// another biconnected component than the tree edge to its parent. As in
+// find_articulation_points, tree roots are disregarded.
+//
+// terminalsOnBothSides... give the same contractions as find_bridges and
+// find_articulation_points, as the side of a bridge or articulation point
+// is a set of subtrees, which are ranges of preorder numbers.
+template <class GraphPtr>
+class parallel_biconnectivity {
+ public:
+    static constexpr bool debug = false;
+
+    // BFS levels with fewer vertices are expanded by a single thread
+    static constexpr size_t min_parallel_level = 1024;
+
+    parallel_biconnectivity(GraphPtr G, size_t threads)
+        : G(G),
+          threads(std::max(threads, size_t { 1 })),
+          parent(G->n(), UNDEFINED_NODE),
+          parent_edge(G->n(), UNDEFINED_EDGE),
+          first_child(G->n(), 0),
+          child_end(G->n(), 0),
+          subtree_size(G->n(), 0),
+          preorder(G->n(), 0),
+          vertex_at(G->n(), 0),
+          low(G->n(), 0),
+          high(G->n(), 0) {
+        spanningForest();
+        treeNumbering();
+    }
+
+    // finds all bridges, returns true if there is at least one
+    bool findAllBridges() {
+        bridge_children.clear();
+        for (NodeID v : order) {
+            if (parent[v] != v && isSeparated(v)) {
+                bridge_children.emplace_back(v);
+            }
+        }
+        return bridge_children.size() > 0;
+    }
+
+    // finds all articulation points that are not roots of the spanning
+    // forest, returns true if there is at least one
+    bool findAllArticulationPoints() {
+        biconnectedComponents();
+        articulation_points.clear();
+        for (NodeID v : order) {
+            if (parent[v] == v) {
+                continue;
+            }
+            for (size_t i = first_child[v]; i < child_end[v]; ++i) {
+                if (label[order[i]] != label[v]) {
+                    articulation_points.emplace_back(v);
+                    break;
+                }
+            }
+        }
+        return articulation_points.size() > 0;
+    }
+
+    // bridges as (vertex, edge id) of the endpoint closer to the root
+    std::vector<std::pair<NodeID, EdgeID> > bridges() const {
+        std::vector<std::pair<NodeID, EdgeID> > result;
+        for (NodeID c : bridge_children) {
+            result.emplace_back(parent[c], parent_edge[c]);
+        }
+        return result;
+    }
+
+    const std::vector<NodeID>& articulationPoints() const {
+        return articulation_points;
+    }
+
+    // see find_bridges::terminalsOnBothSides, std::nullopt if the graph
+    // has no bridges
+    std::optional<std::variant<union_find, std::pair<NodeID, EdgeID> > >
+    terminalsOnBothSidesOfBridges(const std::vector<terminal>& terminals) {
+        if (bridge_children.empty()) {
+            return std::nullopt;
+        }
+        union_find uf(G->n());
+        bool return_uf = false;
+        for (NodeID c : bridge_children) {
+            size_t sum = 0;
+            for (const auto& t : terminals) {
+                sum += inSubtree(c, t.position);
+            }
+
+            if (sum == 0 || sum == terminals.size()) {
+                // all terminals on one side, contract the other side with
+                // the endpoint of the bridge on the terminal side
+                return_uf = true;
+                NodeID p = parent[c];
+                uf.Union(p, c);
+                if (sum == 0) {
+                    forSubtree(c, [&uf, c](NodeID v) { uf.Union(c, v); });
+                } else {
+                    forComponentWithout(c, { c }, [&uf, p](NodeID v) {
+                                            uf.Union(p, v);
+                                        });
+                }
+            }
+        }
+
+        if (return_uf) {
+            return uf;
+        } else {
+            return std::make_pair(parent[bridge_children[0]],
+                                  parent_edge[bridge_children[0]]);
+        }
+    }
+
+    // see find_articulation_points::terminalsOnBothSides
+    std::optional<union_find> terminalsOnBothSidesOfArticulationPoints(
+        const std::vector<terminal>& terminals) {
+        union_find uf(G->n());
+        bool return_uf = false;
+        std::vector<NodeID> separated;
+        for (NodeID n : articulation_points) {
+            // children of n whose subtrees are only connected to the rest of
+            // the graph through n
+            separated.clear();
+            for (size_t i = first_child[n]; i < child_end[n]; ++i) {
+                if (label[order[i]] != label[n]) {
+                    separated.emplace_back(order[i]);
+                }
+            }
+
+            size_t sum = 0;
+            for (const auto& t : terminals) {
+                sum += (t.position == n
+                        || (inSubtree(n, t.position)
+                            && label[childContaining(n, t.position)]
+                            != label[n]));
+            }
+
+            if (sum == 0) {
+                for (NodeID c : separated) {
+                    forSubtree(c, [&uf, n](NodeID v) { uf.Union(n, v); });
+                }
+                return_uf = true;
+            } else if (sum == terminals.size()) {
+                forComponentWithout(n, separated, [&uf, n](NodeID v) {
+                                        uf.Union(n, v);
+                                    });
+                return_uf = true;
+            }
+        }
+
+        if (return_uf) {
+            return uf;
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    // minimum of cut and the weight of the lightest bridge, which separates
+    // the subtree below it from the rest of the graph. If save_cut and the
+    // bridge is lighter than cut, the vertices of the subtree are set to be
+    // in the cut. Requires findAllBridges().
+    EdgeWeight bridgeCut(EdgeWeight cut, bool save_cut) {
+        NodeID lightest = UNDEFINED_NODE;
+        for (NodeID c : bridge_children) {
+            EdgeWeight wgt = G->getEdgeWeight(parent[c], parent_edge[c]);
+            if (wgt < cut) {
+                cut = wgt;
+                lightest = c;
+            }
+        }
+
+        if (save_cut && lightest != UNDEFINED_NODE) {
+            for (NodeID v : G->nodes()) {
+                G->setNodeInCut(v, inSubtree(lightest, v));
+            }
+        }
+        return cut;
+    }
+
+ private:
+    // level-synchronous BFS from the first unvisited vertex of every
+    // connected component. The children of a vertex are contiguous in
+    // order, as every vertex of a level is expanded by a single thread.
+    void spanningForest() {
+        std::vector<std::vector<NodeID> > next(threads);
+        for (NodeID r : G->nodes()) {
+            if (parent[r] != UNDEFINED_NODE) {
+                continue;
+            }
+            parent[r] = r;
+            roots.emplace_back(r);
+            levels.emplace_back(order.size());
+            order.emplace_back(r);
+
+            size_t begin = order.size() - 1;
+            while (begin < order.size()) {
+                size_t end = order.size();
+                bool parallel = (end - begin >= min_parallel_level);
+#pragma omp parallel num_threads(threads) if (parallel)
+                {
+                    auto& local = next[omp_get_thread_num()];
+#pragma omp for schedule(dynamic, 256)
+                    for (size_t i = begin; i < end; ++i) {
+                        NodeID n = order[i];
+                        for (EdgeID e : G->edges_of(n)) {
+                            NodeID t = G->getEdgeTarget(n, e);
+                            if (parent[t] == UNDEFINED_NODE
+                                && __sync_bool_compare_and_swap(
+                                    &parent[t], UNDEFINED_NODE, n)) {
+                                parent_edge[t] = e;
+                                local.emplace_back(t);
+                            }
+                        }
+                    }
+                }
+
+                for (auto& local : next) {
+                    order.insert(order.end(), local.begin(), local.end());
+                    local.clear();
+                }
+                if (order.size() > end) {
+                    levels.emplace_back(end);
+                }
+                begin = end;
+            }
+        }
+        levels.emplace_back(order.size());
+    }
+
+    // subtree sizes bottom-up, preorder numbers top-down, then lowest and
+    // highest preorder number reachable from every subtree
+    void treeNumbering() {
+#pragma omp parallel for num_threads(threads) schedule(static)
+        for (size_t i = 0; i < order.size(); ++i) {
+            NodeID v = order[i];
+            NodeID p = parent[v];
+            if (p == v) {
+                continue;
+            }
+            if (parent[order[i - 1]] != p || order[i - 1] == p) {
+                first_child[p] = i;
+            }
+            if (i + 1 == order.size() || parent[order[i + 1]] != p
+                || order[i + 1] == p) {
+                child_end[p] = i + 1;
+            }
+        }
+
+        forLevels(/* bottom_up */ true, [this](NodeID v) {
+                      NodeID size = 1;
+                      for (size_t i = first_child[v]; i < child_end[v]; ++i) {
+                          size += subtree_size[order[i]];
+                      }
+                      subtree_size[v] = size;
+                  });
+
+        for (size_t l = 0; l + 1 < levels.size(); ++l) {
+            NodeID r = order[levels[l]];
+            if (parent[r] == r) {
+                preorder[r] = levels[l];
+            }
+        }
+
+        forLevels(/* bottom_up */ false, [this](NodeID v) {
+                      vertex_at[preorder[v]] = v;
+                      NodeID next = preorder[v] + 1;
+                      for (size_t i = first_child[v]; i < child_end[v]; ++i) {
+                          preorder[order[i]] = next;
+                          next += subtree_size[order[i]];
+                      }
+                  });
+
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 1024)
+        for (NodeID v = 0; v < G->n(); ++v) {
+            NodeID lowest = preorder[v];
+            NodeID highest = preorder[v];
+            // the tree edge to the parent is the only edge not considered,
+            // parallel edges to the parent are non-tree edges
+            bool tree_edge_skipped = (parent[v] == v);
+            for (EdgeID e : G->edges_of(v)) {
+                NodeID t = G->getEdgeTarget(v, e);
+                if (!tree_edge_skipped && t == parent[v]) {
+                    tree_edge_skipped = true;
+                    continue;
+                }
+                lowest = std::min(lowest, preorder[t]);
+                highest = std::max(highest, preorder[t]);
+            }
+            low[v] = lowest;
+            high[v] = highest;
+        }
+
+        forLevels(/* bottom_up */ true, [this](NodeID v) {
+                      for (size_t i = first_child[v]; i < child_end[v]; ++i) {
+                          low[v] = std::min(low[v], low[order[i]]);
+                          high[v] = std::max(high[v], high[order[i]]);
+                      }
+                  });
+    }
+
+    // tree edge (parent[w], w) and (parent[v], v) are in the same
+    // biconnected component, if w and v have the same label. Unites tree
+    // edges connected by a non-tree edge between vertices that are not
+    // ancestors of each other, and the tree edges to a vertex v and to its
+    // child w, if a non-tree edge leaves the subtree of w and the subtree of
+    // v (Tarjan and Vishkin, rules 1 and 2)
+    void biconnectedComponents() {
+        label.resize(G->n());
+        for (NodeID v = 0; v < G->n(); ++v) {
+            label[v] = v;
+        }
+
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 1024)
+        for (NodeID w = 0; w < G->n(); ++w) {
+            NodeID v = parent[w];
+            if (v == w) {
+                continue;
+            }
+            if (parent[v] != v && !isSeparated(w, v)) {
+                unite(w, v);
+            }
+            for (EdgeID e : G->edges_of(w)) {
+                NodeID t = G->getEdgeTarget(w, e);
+                if (preorder[t] > preorder[w] && !inSubtree(w, t)) {
+                    unite(w, t);
+                }
+            }
+        }
+
+#pragma omp parallel for num_threads(threads) schedule(static)
+        for (NodeID v = 0; v < G->n(); ++v) {
+            label[v] = labelRoot(v);
+        }
+    }
+
+    NodeID labelRoot(NodeID v) {
+        while (label[v] != v) {
+            NodeID next = label[v];
+            // CAS path halving, see parallel union find
+            __sync_bool_compare_and_swap(&label[v], next, label[next]);
+            v = label[next];
+        }
+        return v;
+    }
+
+    // lock-free union, the root with the larger id is hooked to the other
+    // root, so that no cycles can occur
+    void unite(NodeID v, NodeID w) {
+        while (true) {
+            NodeID r_v = labelRoot(v);
+            NodeID r_w = labelRoot(w);
+            if (r_v == r_w) {
+                return;
+            }
+            if (r_v < r_w) {
+                std::swap(r_v, r_w);
+            }
+            if (__sync_bool_compare_and_swap(&label[r_v], r_v, r_w)) {
+                return;
+            }
+        }
+    }
+
+    bool inSubtree(NodeID root, NodeID v) const {
+        return preorder[v] >= preorder[root]
+               && preorder[v] < preorder[root] + subtree_size[root];
+    }
+
+    // no non-tree edge leaves the subtree of w, except to vertices in the
+    // subtree of v
+    bool isSeparated(NodeID w, NodeID v) const {
+        return low[w] >= preorder[v]
+               && high[w] < preorder[v] + subtree_size[v];
+    }
+
+    bool isSeparated(NodeID w) const {
+        return isSeparated(w, w);
+    }
+
+    // child of n whose subtree contains v, requires inSubtree(n, v)
+    NodeID childContaining(NodeID n, NodeID v) const {
+        auto begin = order.begin() + first_child[n];
+        auto end = order.begin() + child_end[n];
+        auto it = std::upper_bound(begin, end, preorder[v],
+                                   [this](NodeID pre, NodeID c) {
+                                       return pre < preorder[c];
+                                   });
+        return *(it - 1);
+    }
+
+    template <class F>
+    void forSubtree(NodeID root, F f) const {
+        for (NodeID p = preorder[root];
+             p < preorder[root] + subtree_size[root]; ++p) {
+            f(vertex_at[p]);
+        }
+    }
+
+    // calls f for every vertex in the connected component of n that is not
+    // in the subtree of any vertex in excluded
+    template <class F>
+    void forComponentWithout(NodeID n, const std::vector<NodeID>& excluded,
+                             F f) const {
+        auto it = std::upper_bound(roots.begin(), roots.end(), preorder[n],
+                                   [this](NodeID pre, NodeID r) {
+                                       return pre < preorder[r];
+                                   });
+        NodeID root = *(it - 1);
+        std::vector<std::pair<NodeID, NodeID> > skip;
+        for (NodeID c : excluded) {
+            skip.emplace_back(preorder[c], preorder[c] + subtree_size[c]);
+        }
+        std::sort(skip.begin(), skip.end());
+
+        size_t s = 0;
+        for (NodeID p = preorder[root];
+             p < preorder[root] + subtree_size[root]; ++p) {
+            if (s < skip.size() && p == skip[s].first) {
+                p = skip[s++].second - 1;
+                continue;
+            }
+            f(vertex_at[p]);
+        }
+    }
+
+    // calls f for all vertices of every BFS level in parallel, from the
+    // last level to the first if bottom_up and from the first level
+    // otherwise. Levels of different components are independent.
+    template <class F>
+    void forLevels(bool bottom_up, F f) {
+        size_t num_levels = levels.size() - 1;
+        for (size_t k = 0; k < num_levels; ++k) {
+            size_t l = bottom_up ? num_levels - 1 - k : k;
+            size_t begin = levels[l];
+            size_t end = levels[l + 1];
+            bool parallel = (end - begin >= min_parallel_level);
+#pragma omp parallel for num_threads(threads) if (parallel) schedule(guided)
+            for (size_t i = begin; i < end; ++i) {
+                f(order[i]);
+            }
+        }
+    }
+
+    GraphPtr G;
+    size_t threads;
+
+    // spanning forest: parent (roots are their own parent), edge id of the
+    // tree edge at the parent, BFS order and start index of every level
+    std::vector<NodeID> parent;
+    std::vector<EdgeID> parent_edge;
+    std::vector<NodeID> order;
+    std::vector<size_t> levels;
+    std::vector<NodeID> roots;
+    // children of v are order[first_child[v]] to order[child_end[v] - 1]
+    std::vector<size_t> first_child;
+    std::vector<size_t> child_end;
+
+    std::vector<NodeID> subtree_size;
+    std::vector<NodeID> preorder;
+    std::vector<NodeID> vertex_at;
+    std::vector<NodeID> low;
+    std::vector<NodeID> high;
+    std::vector<NodeID> label;
+
+    std::vector<NodeID> bridge_children;
+    std::vector<NodeID> articulation_points;
+};
@@ -11,12 +11,15 @@
 
 #pragma once
 
+#include <malloc.h>
 #include <mpi.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <cstdio>
+#include <fstream>
 #include <iterator>
 #include <limits>
 #include <memory>
@@ -64,27 +67,35 @@ class branch_multicut {
 #endif
     static const bool testing = true;
 
+    // a local instance solves the problem on the calling thread without
+    // any MPI communication, see multiterminal_cut::solveSmallComponents
     branch_multicut(const mutable_graph& original_graph,
                     std::vector<NodeID> original_terminals,
-                    std::vector<bool> fixed_vertex)
+                    std::vector<bool> fixed_vertex,
+                    bool local = false)
         : original_graph(original_graph),
           original_terminals(original_terminals),
           fixed_vertex(fixed_vertex),
           total_time(),
-          q_mutex(configuration::getConfig()->threads),
-          num_threads(configuration::getConfig()->threads),
-          branch_invalid(configuration::getConfig()->threads, 0),
+          local(local),
+          q_mutex(local ? 1 : configuration::getConfig()->threads),
+          num_threads(local ? 1 : configuration::getConfig()->threads),
+          branch_invalid(num_threads, 0),
           kc(original_terminals),
-          mf(original_terminals),
+          mf(original_terminals, num_threads),
           pm(this->original_graph, this->original_terminals,
-             this->fixed_vertex),
+             this->fixed_vertex, num_threads, local),
           msm(this->original_graph, this->original_terminals),
           last_sent_flow(UNDEFINED_FLOW),
           log_timer(0),
           finished(false),
-          mpic() {
-        MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
-        MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+          mpi_size(1),
+          mpi_rank(0),
+          mpic(local) {
+        if (!local) {
+            MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+            MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+        }
         mpi_num_done = 0;
         mpi_done.resize(mpi_size, 0);
         sent_done = false;
@@ -92,17 +103,37 @@ class branch_multicut {
 
     ~branch_multicut() { }
 
+    // lower bound on the optimal cut after find_multiterminal_cut, equal to
+    // the returned cut if the search was neither stopped early nor run with
+    // a relative gap
+    FlowType lowerBound() const {
+        return lower_bound;
+    }
+
+    void setIncumbentCallback(incumbent_callback callback) {
+        pm.setIncumbentCallback(callback);
+    }
+
     std::pair<std::vector<NodeID>, size_t> find_multiterminal_cut(
         problemPointer problem) {
         std::vector<NodeID> sol;
         size_t numTerminals = problem->terminals.size();
         if (mpi_rank == 0) {
-            mf.maximumIsolatingFlow(problem, 0, /* parallel */ true);
+            mf.maximumIsolatingFlow(problem, 0, /* parallel */ !local);
             sol = msm.getSolution(problem);
             pm.addProblem(problem, 0, false);
             pm.updateBound(problem->upper_bound);
         }
 
+        if (local) {
+            updateBestSolution(&sol, numTerminals);
+            pollWork(0);
+            std::vector<NodeID> best_solution = pm.getBestSolution();
+            FlowType total_weight = msm.flowValue(false, best_solution);
+            lower_bound = std::min(pm.globalLowerBound(), total_weight);
+            return std::make_pair(best_solution, total_weight);
+        }
+
         std::vector<std::thread> threads;
         for (size_t i = 0; i < num_threads; ++i) {
             threads.emplace_back(
@@ -179,6 +210,16 @@ class branch_multicut {
         total_weight = msm.flowValue(false, best_solution);
         VIECUT_ASSERT_LEQ(total_weight, pm.bestCut());
 
+        FlowType local_lower = pm.globalLowerBound();
+        MPI_Allreduce(&local_lower, &lower_bound, 1, MPI_LONG,
+                      MPI_MIN, MPI_COMM_WORLD);
+        lower_bound = std::min(lower_bound, total_weight);
+        LOG1 << "Cut " << total_weight << ", lower bound " << lower_bound;
+        if (configuration::getConfig()->transposition_table_size > 0) {
+            LOG1 << "Pruned " << pm.prunedDuplicates()
+                 << " duplicate problems";
+        }
+
         return std::make_pair(best_solution, total_weight);
     }
 
@@ -210,7 +251,11 @@ class branch_multicut {
                     // forget this problem if it was sent to another worker
                     mpic.sendProblem(problem.value(), sending.value());
                 } else {
+                    pm.startProblem(thread_id, problem.value());
                     solveProblem(problem.value(), thread_id);
+                    // after timeout or memory out, the problem and its
+                    // subproblems are not solved to the end
+                    pm.finishProblem(thread_id, finished);
                 }
             } else {
                 if (!im_idle) {
@@ -292,20 +337,78 @@ class branch_multicut {
         }
     }
 
-    bool outOfMemory() {
+    // memory in use, allocated bytes if built with tcmalloc and resident set
+    // size otherwise. Allocated bytes do not include memory of freed problems
+    // that tcmalloc keeps in its heap, which can be reused for new problems.
+    static size_t usedMemory() {
 #ifdef USE_TCMALLOC
-        uint64_t heapsize = 0;
+        size_t bytes = 0;
         MallocExtension::instance()->GetNumericProperty(
-            "generic.heap_size", &heapsize);
+            "generic.current_allocated_bytes", &bytes);
+        return bytes;
+#else
+        size_t pages = 0;
+        size_t resident = 0;
+        std::ifstream statm("/proc/self/statm");
+        statm >> pages >> resident;
+        return resident * sysconf(_SC_PAGESIZE);
+#endif
+    }
 
-        uint64_t max_size = 32UL * 1024UL * 1024UL * 1024UL;
-        if (heapsize > max_size) {
-            LOG1 << "Memoryout!";
-            finished = true;
-            return true;
-        }
+    static void releaseFreeMemory() {
+#ifdef USE_TCMALLOC
+        MallocExtension::instance()->ReleaseFreeMemory();
+#elif defined(__GLIBC__)
+        malloc_trim(0);
 #endif
-        return false;
+    }
+
+    // when the memory budget is exceeded, the worst open problems are moved
+    // to disk. Only if there is nothing left to move, the search ends.
+    // Memory is only measured every memory_check_interval calls, as the
+    // resident set size is read from /proc. After spilling, problems are
+    // only spilled again once memory use grew by another tenth of the
+    // budget, as freed memory is not always returned to the system. Falling
+    // below 90% of the budget resets this.
+    bool outOfMemory() {
+        auto cfg = configuration::getConfig();
+        size_t budget = cfg->memory_budget * 1024UL * 1024UL;
+        if (budget == 0 || memory_checks++ % memory_check_interval != 0) {
+            return false;
+        }
+
+        size_t used = usedMemory();
+        if (used < budget / 10 * 9) {
+            used_after_spill = 0;
+            return false;
+        }
+
+        if (used <= budget
+            || (used_after_spill > 0
+                && used <= used_after_spill + budget / 10)) {
+            return false;
+        }
+
+        std::unique_lock<std::mutex> lock(spill_mutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            // another thread is spilling problems
+            return false;
+        }
+
+        if (!cfg->disable_spilling) {
+            size_t spilled = pm.spillProblems();
+            if (spilled > 0) {
+                LOG1 << "Memory budget exceeded, moved " << spilled
+                     << " problems to disk";
+                releaseFreeMemory();
+                used_after_spill = std::max(usedMemory(), budget);
+                return false;
+            }
+        }
+
+        LOG1 << "Memoryout!";
+        finished = true;
+        return true;
     }
 
     void solveProblem(problemPointer problem,
@@ -346,6 +449,7 @@ class branch_multicut {
                           << " lower:" << problem->lower_bound
                           << " upper:" << problem->upper_bound
                           << " global_upper:" << pm.bestCut()
+                          << " global_lower:" << pm.globalLowerBound()
                           << " queue.size:" << pm.numProblems();
         }
 
@@ -354,7 +458,7 @@ class branch_multicut {
             for (size_t i = 0; i < problem->graph->getOriginalNodes(); ++i) {
                 map->emplace_back(problem->graph->getCurrentPosition(i));
             }
-            problem->mappings.emplace_back(map);
+            problem->addMapping(map);
             problem->graph = problem->graph->simplify();
         }
         graph_contraction::setTerminals(problem, original_terminals);
@@ -562,7 +666,7 @@ class branch_multicut {
     void nonBranchingContraction(problemPointer problem) {
         auto pe = kc.kernelization(problem, pm.bestCut(),
                                    pm.numProblems() == 0
-                                   && configuration::getConfig()->threads > 1);
+                                   && num_threads > 1);
         if (pe.has_value()) {
             problem->priority_edge = *pe;
         }
@@ -614,6 +718,8 @@ class branch_multicut {
     timer total_time;
     std::pair<NodeID, EdgeID> priority_edge;
 
+    bool local;
+
     // parallel
     std::vector<std::mutex> q_mutex;
     size_t num_threads;
@@ -626,6 +732,13 @@ class branch_multicut {
     FlowType last_sent_flow;
     std::atomic<double> log_timer;
     bool finished;
+    FlowType lower_bound = 0;
+
+    // memory budget
+    static constexpr size_t memory_check_interval = 64;
+    std::atomic<size_t> memory_checks = 0;
+    std::atomic<size_t> used_after_spill = 0;
+    std::mutex spill_mutex;
 
 #ifdef USE_GUROBI
     ilp_model ilp;
@@ -13,6 +13,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -24,9 +25,11 @@
 #include "algorithms/misc/find_articulation_points.h"
 #include "algorithms/misc/find_bridges.h"
 #include "algorithms/misc/maximal_clique.h"
+#include "algorithms/misc/parallel_biconnectivity.h"
 #include "algorithms/multicut/graph_contraction.h"
 #include "algorithms/multicut/maximum_flow.h"
 #include "algorithms/multicut/multicut_problem.h"
+#include "data_structure/sorted_adjacency.h"
 #include "data_structure/union_find.h"
 #include "tlx/logger.hpp"
 #include "tlx/math.hpp"
@@ -86,17 +89,28 @@ class kernelization_criteria {
             auto uf_noi = noi.modified_capforest(problem->graph, noi_limit);
             contractIfImproved(&uf_noi, problem, "noi", &active_n);
 
-            find_articulation_points find_aps(problem->graph);
-            if (find_aps.findAllArticulationPoints()) {
-                auto uf = find_aps.terminalsOnBothSides(problem->terminals);
-                if (uf.has_value()) {
-                    contractIfImproved(
-                        &uf.value(), problem, "aps", &active_n);
+            std::optional<union_find> uf_aps;
+            if (parallel) {
+                parallel_biconnectivity<mutableGraphPtr> bcc(
+                    problem->graph, configuration::getConfig()->threads);
+                if (bcc.findAllArticulationPoints()) {
+                    uf_aps = bcc.terminalsOnBothSidesOfArticulationPoints(
+                        problem->terminals);
                 }
+            } else {
+                find_articulation_points find_aps(problem->graph);
+                if (find_aps.findAllArticulationPoints()) {
+                    uf_aps = find_aps.terminalsOnBothSides(
+                        problem->terminals);
+                }
+            }
+            if (uf_aps.has_value()) {
+                contractIfImproved(&uf_aps.value(), problem, "aps", &active_n);
             }
 
             equal_neighborhood en;
-            union_find uf_en = en.findEqualNeighborhoods(problem, active_c);
+            union_find uf_en = en.findEqualNeighborhoods(problem, active_c,
+                                                         parallel);
             contractIfImproved(&uf_en, problem, "equal_nbrhd", &active_n);
 
             auto uf_mf = mf.nonTerminalFlow(problem, parallel, active_c);
@@ -290,9 +304,42 @@ class kernelization_criteria {
             terminals[p.position] = true;
         }
 
-        std::vector<EdgeID> marked(problem->graph->n(), UNDEFINED_EDGE);
+        // with sorted adjacency lists, the triangles of an edge are found by
+        // intersecting the neighborhoods of its vertices instead of marking
+        std::optional<sorted_adjacency> sorted;
+        if (sorted_adjacency::enabled()) {
+            sorted.emplace(graph);
+        }
+        std::vector<EdgeID> marked(sorted ? 0 : problem->graph->n(),
+                                   UNDEFINED_EDGE);
         std::vector<bool> done(problem->graph->n(), false);
 
+        // triangle v1 - v2 - v3 with edges e1 = {v1, v2}, e2 = {v2, v3}
+        // and e3 = {v1, v3}
+        auto triangle = [&](NodeID v1, NodeID v2, NodeID v3,
+                            EdgeWeight weight_e1, EdgeWeight weight_e2,
+                            EdgeWeight weight_e3) {
+            EdgeWeight weight_v1 = graph->getWeightedNodeDegree(v1);
+            EdgeWeight weight_v2 = graph->getWeightedNodeDegree(v2);
+            EdgeWeight weight_v3 = graph->getWeightedNodeDegree(v3);
+
+            bool heavy_v1 = ((weight_v1 <= (weight_e1 + weight_e3) * 2)
+                             && (uf.Find(v1) == v1));
+            bool heavy_v2 = ((weight_v2 <= (weight_e1 + weight_e2) * 2)
+                             && (uf.Find(v2) == v2));
+            bool heavy_v3 = ((weight_v3 <= (weight_e2 + weight_e3) * 2)
+                             && (uf.Find(v3) == v3));
+
+            if (heavy_v1 && heavy_v2)
+                uf.Union(v1, v2);
+
+            if (heavy_v1 && heavy_v3)
+                uf.Union(v1, v3);
+
+            if (heavy_v2 && heavy_v3)
+                uf.Union(v2, v3);
+        };
+
         for (NodeID v1 : graph->nodes()) {
             NodeID in = graph->containedVertices(v1)[0];
             if (!active[in]) {
@@ -304,7 +351,7 @@ class kernelization_criteria {
                 for (EdgeID e : graph->edges_of(v1)) {
                     NodeID tgt = graph->getEdgeTarget(v1, e);
                     EdgeWeight wgt = graph->getEdgeWeight(v1, e);
-                    if (tgt > v1) {
+                    if (tgt > v1 && !sorted) {
                         marked[tgt] = e;
                     }
 
@@ -317,7 +364,9 @@ class kernelization_criteria {
                 if (maxwgt * 4 < graph->getWeightedNodeDegree(v1)) {
                     for (EdgeID e : graph->edges_of(v1)) {
                         NodeID tgt = graph->getEdgeTarget(v1, e);
-                        marked[tgt] = UNDEFINED_EDGE;
+                        if (!sorted) {
+                            marked[tgt] = UNDEFINED_EDGE;
+                        }
                     }
                     continue;
                 }
@@ -325,47 +374,29 @@ class kernelization_criteria {
                 for (EdgeID e1 : graph->edges_of(v1)) {
                     NodeID v2 = graph->getEdgeTarget(v1, e1);
                     if (v2 > v1 && !terminals[v2] && !done[v2]) {
+                        EdgeWeight weight_e1 = graph->getEdgeWeight(v1, e1);
+                        if (sorted) {
+                            sorted->intersect(
+                                v1, v2, [&](NodeID v3, EdgeWeight weight_e3,
+                                            EdgeWeight weight_e2) {
+                                    if (v3 > v2 && !terminals[v3]
+                                        && !done[v3]) {
+                                        triangle(v1, v2, v3, weight_e1,
+                                                 weight_e2, weight_e3);
+                                    }
+                                });
+                            continue;
+                        }
+
                         for (EdgeID e2 : graph->edges_of(v2)) {
                             NodeID v3 = graph->getEdgeTarget(v2, e2);
                             if (v3 > v2 && marked[v3] != UNDEFINED_EDGE
                                 && !terminals[v3] && !done[v3]) {
                                 EdgeID e3 = marked[v3];
                                 if (graph->getEdgeTarget(v1, e3) == v3) {
-                                    EdgeWeight weight_v1 =
-                                        graph->getWeightedNodeDegree(v1);
-                                    EdgeWeight weight_v2 =
-                                        graph->getWeightedNodeDegree(v2);
-                                    EdgeWeight weight_v3 =
-                                        graph->getWeightedNodeDegree(v3);
-
-                                    EdgeWeight weight_e1 =
-                                        graph->getEdgeWeight(v1, e1);
-                                    EdgeWeight weight_e2 =
-                                        graph->getEdgeWeight(v2, e2);
-                                    EdgeWeight weight_e3 =
-                                        graph->getEdgeWeight(v1, e3);
-
-                                    bool heavy_v1 =
-                                        ((weight_v1 <=
-                                          (weight_e1 + weight_e3) * 2)
-                                         && (uf.Find(v1) == v1));
-                                    bool heavy_v2 =
-                                        ((weight_v2 <=
-                                          (weight_e1 + weight_e2) * 2)
-                                         && (uf.Find(v2) == v2));
-                                    bool heavy_v3 =
-                                        ((weight_v3 <=
-                                          (weight_e2 + weight_e3) * 2)
-                                         && (uf.Find(v3) == v3));
-
-                                    if (heavy_v1 && heavy_v2)
-                                        uf.Union(v1, v2);
-
-                                    if (heavy_v1 && heavy_v3)
-                                        uf.Union(v1, v3);
-
-                                    if (heavy_v2 && heavy_v3)
-                                        uf.Union(v2, v3);
+                                    triangle(v1, v2, v3, weight_e1,
+                                             graph->getEdgeWeight(v2, e2),
+                                             graph->getEdgeWeight(v1, e3));
                                 } else {
                                     LOG1 << "Graph corrupted!";
                                     exit(1);
@@ -11,6 +11,9 @@
 
 #pragma once
 
+#include <omp.h>
+
+#include <algorithm>
 #include <memory>
 #include <tuple>
 #include <unordered_map>
@@ -21,6 +24,11 @@
 #include "common/configuration.h"
 #include "common/definitions.h"
 
+// Local search on a multiterminal cut solution: moves of single vertices or
+// pairs of vertices with positive gain and maximum flows between pairs of
+// neighboring blocks. With local_search_threads > 1, the vertex moves are
+// computed in synchronous label propagation rounds and flows between
+// disjoint pairs of blocks are computed concurrently.
 class local_search {
  private:
     const mutable_graph& original_graph;
@@ -29,7 +37,10 @@ class local_search {
     std::vector<NodeID>* sol;
     std::unordered_map<NodeID, NodeID> movedToNewBlock;
     std::vector<std::vector<FlowType> > previousConnectivity;
-    std::vector<NodeID> noImprovement;
+    size_t num_threads;
+    // per thread: block weights of a vertex and mapping to the flow graph
+    std::vector<std::vector<EdgeWeight> > blockwgt_buffer;
+    std::vector<std::vector<NodeID> > mapping_buffer;
 
  public:
     local_search(const mutable_graph& original_graph,
@@ -40,26 +51,53 @@ class local_search {
           original_terminals(original_terminals),
           fixed_vertex(fixed_vertex),
           sol(sol),
-          previousConnectivity(original_terminals.size()) {
+          previousConnectivity(original_terminals.size()),
+          num_threads(std::max(static_cast<size_t>(1),
+                               configuration::getConfig()
+                               ->local_search_threads)),
+          blockwgt_buffer(num_threads),
+          mapping_buffer(num_threads) {
         for (auto& pc : previousConnectivity) {
             pc.resize(original_terminals.size(), 0);
         }
     }
 
  private:
-    std::tuple<EdgeWeight, FlowType> flowBetweenBlocks(NodeID term1,
-                                                       NodeID term2) {
+    std::vector<EdgeWeight>& blockWeights(size_t thread_id) {
+        auto& blockwgt = blockwgt_buffer[thread_id];
+        if (blockwgt.empty()) {
+            blockwgt.resize(configuration::getConfig()->num_terminals, 0);
+        }
+        return blockwgt;
+    }
+
+    std::vector<NodeID>& flowMapping(size_t thread_id) {
+        auto& mapping = mapping_buffer[thread_id];
+        if (mapping.empty()) {
+            mapping.resize(original_graph.n(), UNDEFINED_NODE);
+        }
+        return mapping;
+    }
+
+    // maximum flow between blocks term1 and term2, where (*blocks)[term1]
+    // and (*blocks)[term2] contain their vertices. Only reads and writes
+    // the solution of these vertices, thus flows between disjoint pairs of
+    // blocks can run concurrently.
+    std::tuple<EdgeWeight, FlowType> flowBetweenBlocks(
+        NodeID term1, NodeID term2,
+        std::vector<std::vector<NodeID> >* blocks, size_t thread_id) {
         std::vector<NodeID>& solution = *sol;
-        std::vector<NodeID> mapping(original_graph.n(), UNDEFINED_NODE);
+        std::vector<NodeID>& mapping = flowMapping(thread_id);
         auto G = std::make_shared<mutable_graph>();
         FlowType sol_weight = 0;
         timer t;
 
-        NodeID id = 2;
-        for (NodeID n : original_graph.nodes()) {
-            if (solution[n] != term1 && solution[n] != term2)
-                continue;
+        std::vector<NodeID> vertices = (*blocks)[term1];
+        vertices.insert(vertices.end(), (*blocks)[term2].begin(),
+                        (*blocks)[term2].end());
 
+        NodeID id = 2;
+        for (NodeID n : vertices) {
             if (fixed_vertex[n]) {
                 mapping[n] = (solution[n] == term1 ? 0 : 1);
             } else {
@@ -68,88 +106,68 @@ class local_search {
             }
         }
         G->start_construction(id);
-        std::unordered_map<NodeID, EdgeWeight> edgesToFixed0;
-        std::unordered_map<NodeID, EdgeWeight> edgesToFixed1;
-        std::vector<std::pair<NodeID, NodeID> > edgesOnOriginal;
-
-        for (NodeID n : original_graph.nodes()) {
-            if (solution[n] != term1 && solution[n] != term2)
-                continue;
+        std::vector<EdgeWeight> edgesToFixed0(id, 0);
+        std::vector<EdgeWeight> edgesToFixed1(id, 0);
 
+        for (NodeID n : vertices) {
             NodeID m_n = mapping[n];
             for (EdgeID e : original_graph.edges_of(n)) {
                 auto [t, w] = original_graph.getEdge(n, e);
                 NodeID m_t = mapping[t];
-                if ((solution[t] != term1 && solution[t] != term2)
-                    || m_n >= m_t || m_t < 2)
+                // vertices of other blocks are not mapped
+                if (m_t == UNDEFINED_NODE || m_n >= m_t || m_t < 2)
                     continue;
 
                 if (solution[t] != solution[n]) {
                     sol_weight += w;
-                    edgesOnOriginal.emplace_back(n, t);
                 }
 
                 if (m_n < 2) {
                     if (m_n == 0) {
-                        if (edgesToFixed0.count(m_t) > 0) {
-                            edgesToFixed0[m_t] += w;
-                        } else {
-                            edgesToFixed0[m_t] = w;
-                        }
+                        edgesToFixed0[m_t] += w;
                     } else {
-                        if (edgesToFixed1.count(m_t) > 0) {
-                            edgesToFixed1[m_t] += w;
-                        } else {
-                            edgesToFixed1[m_t] = w;
-                        }
+                        edgesToFixed1[m_t] += w;
                     }
                 } else {
                     G->new_edge_order(m_n, m_t, w);
                 }
             }
         }
-        for (auto [n, w] : edgesToFixed0) {
-            G->new_edge_order(n, 0, w);
-        }
-        for (auto [n, w] : edgesToFixed1) {
-            G->new_edge_order(n, 1, w);
+        for (NodeID n = 2; n < id; ++n) {
+            if (edgesToFixed0[n] > 0)
+                G->new_edge_order(n, 0, edgesToFixed0[n]);
+            if (edgesToFixed1[n] > 0)
+                G->new_edge_order(n, 1, edgesToFixed1[n]);
         }
 
         std::vector<NodeID> terminals = { 0, 1 };
         push_relabel pr;
         LOG0 << "build " << t.elapsed();
         auto [f, s] = pr.solve_max_flow_min_cut(G, terminals, 0, true);
-        std::unordered_set<NodeID> zero;
+        std::vector<bool> zero(id, false);
         sLOG0 << "flow " << t.elapsed() << term1 << term2;
         for (NodeID v : s) {
-            zero.insert(v);
+            zero[v] = true;
         }
 
         if (f < sol_weight) {
             LOG0 << term1 << "-" << term2 << ": "
                  << sol_weight << " to " << f;
-        } else {
-            noImprovement.emplace_back(f);
         }
         size_t improvement = (sol_weight - f);
-        std::vector<NodeID> movedVertices;
-        for (NodeID n : original_graph.nodes()) {
-            if (solution[n] == term1 || solution[n] == term2) {
-                if (fixed_vertex[n]) {
-                    if (zero.count(mapping[n]) != (solution[n] == term1)) {
-                        LOG1 << "DIFFERENT";
-                        exit(1);
-                    }
-                }
-
-                NodeID map = mapping[n];
-
-                if (zero.count(map) > 0) {
-                    solution[n] = term1;
-                } else {
-                    solution[n] = term2;
+        (*blocks)[term1].clear();
+        (*blocks)[term2].clear();
+        for (NodeID n : vertices) {
+            if (fixed_vertex[n]) {
+                if (zero[mapping[n]] != (solution[n] == term1)) {
+                    LOG1 << "DIFFERENT";
+                    exit(1);
                 }
             }
+
+            solution[n] = zero[mapping[n]] ? term1 : term2;
+            (*blocks)[solution[n]].push_back(n);
+            mapping[n] = UNDEFINED_NODE;
         }
 
         LOG0 << "done " << t.elapsed() << " improvement " << improvement
@@ -166,6 +184,7 @@ class local_search {
         std::vector<NodeID>& solution = *sol;
         std::vector<std::vector<FlowType> >
         blockConnectivity(original_terminals.size());
+        std::vector<std::vector<NodeID> > blocks(original_terminals.size());
         EdgeWeight improvement = 0;
 
         std::vector<std::tuple<NodeID, NodeID, FlowType> > neighboringBlocks;
@@ -176,6 +195,7 @@ class local_search {
 
         for (NodeID n : original_graph.nodes()) {
             NodeID blockn = solution[n];
+            blocks[blockn].push_back(n);
             for (EdgeID e : original_graph.edges_of(n)) {
                 auto [t, w] = original_graph.getEdge(n, e);
                 if (solution[t] > blockn) {
@@ -203,16 +223,45 @@ class local_search {
                 return std::get<2>(n1) > std::get<2>(n2);
             });*/
 
-        for (auto [a, b, c] : neighboringBlocks) {
+        // pairs of blocks are processed in batches of pairwise disjoint
+        // pairs, every batch is solved concurrently
+        while (!neighboringBlocks.empty()) {
             if (t.elapsed() > timeoutSecs) {
                 break;
             }
-            auto [impr, connect] = flowBetweenBlocks(a, b);
-            improvement += impr;
-            sLOG0 << "out" << a << b << c << impr << connect;
-            previousConnectivity[a][b] = connect;
+            std::vector<bool> used(original_terminals.size(), false);
+            std::vector<std::tuple<NodeID, NodeID, FlowType> > batch;
+            std::vector<std::tuple<NodeID, NodeID, FlowType> > remaining;
+            for (auto pair : neighboringBlocks) {
+                auto [a, b, c] = pair;
+                if (batch.size() < num_threads && !used[a] && !used[b]) {
+                    used[a] = true;
+                    used[b] = true;
+                    batch.push_back(pair);
+                } else {
+                    remaining.push_back(pair);
+                }
+            }
+
+            std::vector<std::tuple<EdgeWeight, FlowType> > results(
+                batch.size());
+            size_t batch_threads = batch.size();
+#pragma omp parallel for schedule(dynamic, 1) num_threads(batch_threads)
+            for (size_t i = 0; i < batch.size(); ++i) {
+                auto [a, b, c] = batch[i];
+                results[i] = flowBetweenBlocks(a, b, &blocks,
+                                               omp_get_thread_num());
+            }
+
+            for (size_t i = 0; i < batch.size(); ++i) {
+                auto [a, b, c] = batch[i];
+                auto [impr, connect] = results[i];
+                improvement += impr;
+                sLOG0 << "out" << a << b << c << impr << connect;
+                previousConnectivity[a][b] = connect;
+            }
+            neighboringBlocks.swap(remaining);
         }
-        noImprovement.clear();
 
         return improvement;
     }
@@ -226,6 +275,8 @@ class local_search {
         std::vector<std::pair<NodeID, int64_t> > nextBest(
             original_graph.n(), { UNDEFINED_NODE, 0 });
 
+        std::vector<EdgeWeight>& blockwgt = blockWeights(0);
+
         random_functions::permutate_vector_good(&permute, true);
 
         for (NodeID v : original_graph.nodes()) {
@@ -233,8 +284,6 @@ class local_search {
             if (fixed_vertex[n] || !inBoundary[n])
                 continue;
 
-            std::vector<EdgeWeight> blockwgt(
-                configuration::getConfig()->num_terminals, 0);
             NodeID ownBlockID = current_solution[n];
             for (EdgeID e : original_graph.edges_of(n)) {
                 auto [t, w] = original_graph.getEdge(n, e);
@@ -254,6 +303,11 @@ class local_search {
                 }
             }
 
+            for (EdgeID e : original_graph.edges_of(n)) {
+                blockwgt[current_solution[original_graph.getEdgeTarget(n, e)]]
+                    = 0;
+            }
+
             if (maxBlockWgt) {
                 inBoundary[n] = false;
             }
@@ -315,6 +369,142 @@ class local_search {
         return improvement;
     }
 
+    // priority of a move of vertex n with gain, ties are broken by a hash
+    // of the vertex id and then by the id itself
+    static std::tuple<int64_t, uint64_t, NodeID> movePriority(NodeID n,
+                                                             int64_t gain) {
+        uint64_t z = (static_cast<uint64_t>(n) + 1) * 0x9e3779b97f4a7c15;
+        z = (z ^ (z >> 31)) * 0xbf58476d1ce4e5b9;
+        return std::make_tuple(gain, z ^ (z >> 29), n);
+    }
+
+    // parallel version of gainLocalSearch in synchronous rounds. Every active
+    // vertex computes its best move with respect to the solution at the
+    // beginning of the round. A vertex with positive gain moves if no
+    // neighbor has a move with higher priority, thus the moved vertices are
+    // independent and the improvement is exactly the sum of their gains.
+    // The neighbors of moved vertices and vertices that lost against a
+    // neighbor are active in the next round. Does not move pairs of vertices.
+    EdgeWeight parallelGainLocalSearch() {
+        std::vector<NodeID>& current_solution = *sol;
+        NodeID n = original_graph.n();
+        FlowType improvement = 0;
+        std::vector<NodeID> target(n, UNDEFINED_NODE);
+        std::vector<int64_t> gain(n, 0);
+        std::vector<uint8_t> active_next(n, false);
+
+        std::vector<NodeID> active;
+        for (NodeID v : original_graph.nodes()) {
+            if (!fixed_vertex[v])
+                active.push_back(v);
+        }
+
+        while (!active.empty()) {
+            FlowType round_improvement = 0;
+            std::vector<NodeID> next;
+#pragma omp parallel num_threads(num_threads)
+            {
+                std::vector<EdgeWeight>& blockwgt =
+                    blockWeights(omp_get_thread_num());
+#pragma omp for schedule(dynamic, 256)
+                for (size_t i = 0; i < active.size(); ++i) {
+                    NodeID v = active[i];
+                    NodeID ownBlockID = current_solution[v];
+                    for (EdgeID e : original_graph.edges_of(v)) {
+                        auto [t, w] = original_graph.getEdge(v, e);
+                        blockwgt[current_solution[t]] += w;
+                    }
+
+                    NodeID maxBlockID = UNDEFINED_NODE;
+                    EdgeWeight maxBlockWgt = 0;
+                    for (EdgeID e : original_graph.edges_of(v)) {
+                        NodeID b = current_solution[
+                            original_graph.getEdgeTarget(v, e)];
+                        if (b != ownBlockID && (blockwgt[b] > maxBlockWgt
+                                                || (blockwgt[b] == maxBlockWgt
+                                                    && b < maxBlockID))) {
+                            maxBlockID = b;
+                            maxBlockWgt = blockwgt[b];
+                        }
+                    }
+
+                    int64_t g = static_cast<int64_t>(maxBlockWgt)
+                                - static_cast<int64_t>(blockwgt[ownBlockID]);
+                    for (EdgeID e : original_graph.edges_of(v)) {
+                        blockwgt[current_solution[
+                                     original_graph.getEdgeTarget(v, e)]] = 0;
+                    }
+
+                    if (maxBlockWgt > 0 && g > 0) {
+                        target[v] = maxBlockID;
+                        gain[v] = g;
+                    } else {
+                        target[v] = UNDEFINED_NODE;
+                    }
+                }
+
+                // target is not written in this loop and current_solution is
+                // only written for vertices that no other thread looks at
+                std::vector<NodeID> local_next;
+#pragma omp for schedule(dynamic, 256) reduction(+ : round_improvement)
+                for (size_t i = 0; i < active.size(); ++i) {
+                    NodeID v = active[i];
+                    if (target[v] == UNDEFINED_NODE)
+                        continue;
+
+                    auto prio = movePriority(v, gain[v]);
+                    bool wins = true;
+                    for (EdgeID e : original_graph.edges_of(v)) {
+                        NodeID t = original_graph.getEdgeTarget(v, e);
+                        if (target[t] != UNDEFINED_NODE
+                            && movePriority(t, gain[t]) > prio) {
+                            wins = false;
+                            break;
+                        }
+                    }
+
+                    if (!wins) {
+                        if (__sync_bool_compare_and_swap(
+                                &active_next[v], false, true))
+                            local_next.push_back(v);
+                        continue;
+                    }
+
+                    current_solution[v] = target[v];
+                    round_improvement += gain[v];
+                    for (EdgeID e : original_graph.edges_of(v)) {
+                        NodeID t = original_graph.getEdgeTarget(v, e);
+                        if (!fixed_vertex[t]
+                            && __sync_bool_compare_and_swap(
+                                &active_next[t], false, true)) {
+                            local_next.push_back(t);
+                        }
+                    }
+                }
+#pragma omp critical
+                next.insert(next.end(), local_next.begin(), local_next.end());
+            }
+
+            for (NodeID v : active) {
+                target[v] = UNDEFINED_NODE;
+            }
+            for (NodeID v : next) {
+                active_next[v] = false;
+            }
+            improvement += round_improvement;
+            active.swap(next);
+        }
+        return improvement;
+    }
+
+    EdgeWeight gainRefinement() {
+        if (num_threads > 1) {
+            return parallelGainLocalSearch();
+        } else {
+            return gainLocalSearch();
+        }
+    }
+
  public:
     FlowType improveSolution(const timer& time) {
         FlowType total_improvement = 0;
@@ -322,7 +512,7 @@ class local_search {
         while (change_found) {
             timer t;
             change_found = false;
-            auto impGain = gainLocalSearch();
+            auto impGain = gainRefinement();
             total_improvement += impGain;
             LOG0 << "gain " << t.elapsed() << "s impro " << impGain;
 
@@ -349,7 +539,7 @@ class local_search {
         while (change_found) {
             timer t;
             change_found = false;
-            auto impGain = gainLocalSearch();
+            auto impGain = gainRefinement();
             total_improvement += impGain;
             LOG0 << "gain " << t.elapsed() << "s impro " << impGain;
 
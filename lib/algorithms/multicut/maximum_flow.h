@@ -25,9 +25,11 @@
 
 class maximum_flow {
  public:
-    explicit maximum_flow(std::vector<NodeID> o)
+    explicit maximum_flow(
+        std::vector<NodeID> o,
+        size_t num_threads = configuration::getConfig()->threads)
         : original_terminals(o),
-          num_threads(configuration::getConfig()->threads) { }
+          num_threads(num_threads) { }
 
     void maximumSTFlow(problemPointer problem) {
         push_relabel pr;
@@ -214,7 +216,7 @@ class maximum_flow {
         std::vector<std::future<std::vector<NodeID> > > futures;
         // so futures don't lose their object :)
         std::vector<push_relabel<false, true> > prs(problem->terminals.size());
-        if (parallel) {
+        if (parallel && num_threads > 1) {
             // in the beginning when we don't have many problems
             // already (but big graphs), we can start a thread per flow.
             // later on, we have a problem for each processor to work on,
@@ -24,15 +24,22 @@ class mpi_communication {
  public:
     static const bool debug = false;
 
-    mpi_communication() : bestSolutionLocal(false),
-                          best_solution(UNDEFINED_NODE) {
-        MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
-        MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+    // a local instance behaves like a single process and does not call MPI,
+    // thus it can be used outside of the main thread
+    explicit mpi_communication(bool local = false)
+        : mpi_size(1),
+          mpi_rank(0),
+          bestSolutionLocal(false),
+          best_solution(UNDEFINED_NODE) {
+        if (!local) {
+            MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+            MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+        }
         req.resize(mpi_size);
     }
 
     FlowType getGlobalBestSolution() {
-        int result = 1;
+        int result = (mpi_size > 1);
         while (result > 0) {
             MPI_Status status;
             MPI_Iprobe(MPI_ANY_SOURCE, 15123, MPI_COMM_WORLD, &result, &status);
@@ -71,29 +78,7 @@ class mpi_communication {
 
     void sendProblem(problemPointer problem, size_t tgt) {
         LOG1 << mpi_rank << " sends problem to " << tgt;
-        std::vector<uint64_t> data;
-        data.emplace_back(problem->lower_bound);
-        data.emplace_back(problem->upper_bound);
-        data.emplace_back(problem->deleted_weight);
-        data.emplace_back(problem->terminals.size());
-
-        for (const auto& [t, o, b] : problem->terminals) {
-            (void)b;
-            data.emplace_back(t);
-            data.emplace_back(o);
-        }
-
-        data.emplace_back(problem->mappings.size());
-        for (size_t i = 0; i < problem->mappings.size(); ++i) {
-            data.emplace_back(problem->mappings[i]->size());
-            data.insert(data.end(), problem->mappings[i]->begin(),
-                        problem->mappings[i]->end());
-        }
-
-        auto serial = problem->graph->serialize();
-        data.emplace_back(serial.size());
-        data.insert(data.end(), serial.begin(), serial.end());
-
+        std::vector<uint64_t> data = problem->serialize();
         size_t datasize = data.size();
         MPI_Send(&datasize, 1, MPI_LONG, tgt, 1010, MPI_COMM_WORLD);
         MPI_Send(&data.front(), datasize, MPI_LONG, tgt, 1020, MPI_COMM_WORLD);
@@ -107,35 +92,7 @@ class mpi_communication {
         MPI_Recv(&data.front(), datasize, MPI_LONG, src, 1020,
                  MPI_COMM_WORLD, MPI_STATUS_IGNORE);
 
-        auto problem = std::make_shared<multicut_problem>();
-        problem->lower_bound = data[0];
-        problem->upper_bound = data[1];
-        problem->deleted_weight = data[2];
-        size_t num_terminals = data[3];
-        size_t next_index = 4;
-        for (size_t i = 0; i < num_terminals; ++i) {
-            NodeID t = data[next_index++];
-            NodeID o = data[next_index++];
-            problem->terminals.emplace_back(t, o, true);
-        }
-
-        size_t num_mappings = data[next_index++];
-        for (size_t i = 0; i < num_mappings; ++i) {
-            size_t map_size_i = data[next_index++];
-            problem->mappings.emplace_back(
-                std::make_shared<std::vector<NodeID> >());
-            problem->mappings[i]->insert(problem->mappings[i]->end(),
-                                         &data[next_index],
-                                         &data[next_index + map_size_i]);
-            next_index += map_size_i;
-        }
-
-        size_t serialsize = data[next_index++];
-        std::vector<uint64_t> serial;
-        serial.insert(serial.end(), &data[next_index],
-                      &data[next_index + serialsize]);
-
-        problem->graph = mutable_graph::deserialize(serial);
+        auto problem = multicut_problem::deserialize(data);
         LOG << mpi_rank << " returns new problem";
         return problem;
     }
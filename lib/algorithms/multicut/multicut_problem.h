@@ -12,6 +12,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <memory>
 #include <queue>
@@ -76,6 +77,26 @@ struct multicut_problem {
           priority_edge(prio),
           finished_blockpairs(finished_bp) { }
 
+    // maximum number of mappings before they are composed into one
+    static constexpr size_t max_mapping_chain = 4;
+
+    // appends the mapping from the vertices of the current graph to the
+    // vertices of its simplified version. Long chains are composed into a
+    // single mapping from the original vertices, so that mapped() only
+    // follows a few indirections in deep branches. As mappings are shared
+    // with all descendants of this problem, so is the composed mapping.
+    void addMapping(std::shared_ptr<std::vector<NodeID> > map) {
+        mappings.emplace_back(map);
+        if (mappings.size() > max_mapping_chain) {
+            auto composed = std::make_shared<std::vector<NodeID> >(
+                mappings.front()->size());
+            for (NodeID n = 0; n < composed->size(); ++n) {
+                (*composed)[n] = mapped(n);
+            }
+            mappings = { composed };
+        }
+    }
+
     NodeID mapped(NodeID n) const {
         NodeID n_coarse = n;
         for (const auto& map : mappings) {
@@ -84,6 +105,77 @@ struct multicut_problem {
         return n_coarse;
     }
 
+    // writes the problem into a flat array, used to send it to another MPI
+    // process or to move it to the spill file of the problem queue
+    std::vector<uint64_t> serialize() const {
+        std::vector<uint64_t> data;
+        data.emplace_back(lower_bound);
+        data.emplace_back(upper_bound);
+        data.emplace_back(deleted_weight);
+        data.emplace_back(terminals.size());
+
+        for (const auto& [t, o, b] : terminals) {
+            (void)b;
+            data.emplace_back(t);
+            data.emplace_back(o);
+        }
+
+        data.emplace_back(mappings.size());
+        for (size_t i = 0; i < mappings.size(); ++i) {
+            data.emplace_back(mappings[i]->size());
+            data.insert(data.end(), mappings[i]->begin(), mappings[i]->end());
+        }
+
+        data.emplace_back(priority_edge.first);
+        data.emplace_back(priority_edge.second);
+        data.emplace_back(finished_blockpairs.size());
+        data.insert(data.end(), finished_blockpairs.begin(),
+                    finished_blockpairs.end());
+
+        auto serial = graph->serialize();
+        data.emplace_back(serial.size());
+        data.insert(data.end(), serial.begin(), serial.end());
+        return data;
+    }
+
+    // reads a problem in the format of serialize(). As flows are not stored,
+    // they are recomputed for all terminals.
+    static problemPointer deserialize(const std::vector<uint64_t>& data) {
+        auto problem = std::make_shared<multicut_problem>();
+        problem->lower_bound = data[0];
+        problem->upper_bound = data[1];
+        problem->deleted_weight = data[2];
+        size_t num_terminals = data[3];
+        size_t next_index = 4;
+        for (size_t i = 0; i < num_terminals; ++i) {
+            NodeID t = data[next_index++];
+            NodeID o = data[next_index++];
+            problem->terminals.emplace_back(t, o, true);
+        }
+
+        size_t num_mappings = data[next_index++];
+        for (size_t i = 0; i < num_mappings; ++i) {
+            size_t map_size_i = data[next_index++];
+            problem->mappings.emplace_back(
+                std::make_shared<std::vector<NodeID> >(
+                    data.begin() + next_index,
+                    data.begin() + next_index + map_size_i));
+            next_index += map_size_i;
+        }
+
+        problem->priority_edge.first = data[next_index++];
+        problem->priority_edge.second = data[next_index++];
+        size_t num_finished = data[next_index++];
+        problem->finished_blockpairs.insert(
+            data.begin() + next_index,
+            data.begin() + next_index + num_finished);
+        next_index += num_finished;
+
+        next_index++;  // size of serialized graph
+        problem->graph = mutable_graph::deserialize(data.data() + next_index);
+        return problem;
+    }
+
     void addFinishedPair(NodeID a, NodeID b, NodeID numOriginalTerminals) {
         if (a == b) {
             LOG1 << "Error. Pair between " << a << " and itself!";
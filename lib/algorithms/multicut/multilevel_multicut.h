@@ -0,0 +1,221 @@
+/******************************************************************************
+ * multilevel_multicut.h
+ *
+ * Source of VieCut
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#pragma once
+
+#include <omp.h>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "algorithms/multicut/branch_multicut.h"
+#include "algorithms/multicut/local_search.h"
+#include "algorithms/multicut/measurements.h"
+#include "algorithms/multicut/multicut_problem.h"
+#include "algorithms/multicut/problem_management.h"
+#include "coarsening/contract_graph.h"
+#include "common/configuration.h"
+#include "common/definitions.h"
+#include "data_structure/mutable_graph.h"
+#include "parallel/coarsening/label_propagation.h"
+#include "tlx/logger.hpp"
+#include "tools/timer.h"
+
+// Multilevel heuristic for the multiterminal cut problem (--solver
+// multilevel). The problem graph is coarsened by contracting the clusters
+// found by label propagation. Terminals in a cluster with other terminals
+// are split off, so that all terminals stay separate. The coarsest graph is
+// solved by branch_multicut, then the solution is projected to the finer
+// levels and improved by local search on every level. As every coarse cut is
+// also a cut in the finer graphs, the result is a feasible multiterminal
+// cut, but it is not necessarily minimal.
+class multilevel_multicut {
+ public:
+    static constexpr bool debug = false;
+
+    // stop coarsening if a level removes less than this fraction of vertices
+    static constexpr double min_shrink = 0.05;
+
+    multilevel_multicut(const mutable_graph& original_graph,
+                        std::vector<NodeID> original_terminals,
+                        std::vector<bool> fixed_vertex,
+                        bool local = false)
+        : original_graph(original_graph),
+          original_terminals(original_terminals),
+          fixed_vertex(fixed_vertex),
+          local(local),
+          msm(this->original_graph, this->original_terminals) { }
+
+    std::pair<std::vector<NodeID>, FlowType> find_multiterminal_cut(
+        problemPointer problem) {
+        auto cfg = configuration::getConfig();
+        timer t;
+        // restored before returning, as the caller might use more threads
+        int previous_threads = omp_get_max_threads();
+        omp_set_num_threads(local ? 1 : cfg->threads);
+
+        // level 0 is the problem graph, where the terminal blocks are
+        // already contracted into single vertices
+        std::vector<mutableGraphPtr> graphs = { problem->graph };
+        std::vector<std::vector<NodeID> > terminals(1);
+        for (NodeID t : original_terminals) {
+            terminals[0].emplace_back(problem->graph->getCurrentPosition(
+                problem->mapped(t)));
+        }
+
+        // mappings[l][v] is the vertex of level l + 1 that contains vertex v
+        // of level l
+        std::vector<std::vector<NodeID> > mappings;
+        while (graphs.back()->n() > cfg->multilevel_coarsest_size) {
+            mutableGraphPtr G = graphs.back();
+            auto [mapping, reverse_mapping] =
+                clusterSeparatingTerminals(G, terminals.back());
+            if (reverse_mapping.size() > (1.0 - min_shrink) * G->n()) {
+                break;
+            }
+
+            graphs.emplace_back(contraction::contractGraphSparse(
+                                    G, mapping, reverse_mapping));
+            terminals.emplace_back();
+            for (NodeID t : terminals[terminals.size() - 2]) {
+                terminals.back().emplace_back(mapping[t]);
+            }
+            mappings.emplace_back(std::move(mapping));
+            LOG1 << "Level " << mappings.size() << ": " << graphs.back()->n()
+                 << " vertices, " << graphs.back()->m() / 2 << " edges after "
+                 << t.elapsed() << "s";
+        }
+
+        std::vector<NodeID> solution = solveCoarsest(graphs.back(),
+                                                     terminals.back());
+        LOG1 << "Coarsest level solved after " << t.elapsed() << "s";
+        FlowType coarsest_cut = UNDEFINED_FLOW;
+        if (on_improvement) {
+            std::vector<NodeID> projected(original_graph.n());
+            for (NodeID v = 0; v < projected.size(); ++v) {
+                NodeID coarse = problem->graph->getCurrentPosition(
+                    problem->mapped(v));
+                for (const auto& mapping : mappings) {
+                    coarse = mapping[coarse];
+                }
+                projected[v] = solution[coarse];
+            }
+            coarsest_cut = msm.flowValue(false, projected);
+            on_improvement(coarsest_cut, projected);
+        }
+
+        for (size_t l = mappings.size(); l-- > 0; ) {
+            std::vector<NodeID> fine_solution(graphs[l]->n());
+            for (NodeID v = 0; v < fine_solution.size(); ++v) {
+                fine_solution[v] = solution[mappings[l][v]];
+            }
+            solution.swap(fine_solution);
+
+            std::vector<bool> fixed(graphs[l]->n(), false);
+            for (NodeID t : terminals[l]) {
+                fixed[t] = true;
+            }
+            local_search ls(*graphs[l], terminals[l], fixed, &solution);
+            FlowType improvement = ls.improveSolution(t);
+            LOG << "Level " << l << ": local search improved by "
+                << improvement << " after " << t.elapsed() << "s";
+        }
+
+        std::vector<NodeID> original_solution(original_graph.n());
+        for (NodeID v = 0; v < original_solution.size(); ++v) {
+            original_solution[v] =
+                solution[problem->graph->getCurrentPosition(
+                    problem->mapped(v))];
+        }
+        local_search ls(original_graph, original_terminals,
+                        fixed_vertex, &original_solution);
+        ls.improveSolution(t);
+
+        FlowType cut = msm.flowValue(false, original_solution);
+        if (on_improvement && cut < coarsest_cut) {
+            on_improvement(cut, original_solution);
+        }
+        omp_set_num_threads(previous_threads);
+        return std::make_pair(original_solution, cut);
+    }
+
+    // the heuristic does not give a lower bound
+    FlowType lowerBound() const {
+        return 0;
+    }
+
+    void setIncumbentCallback(incumbent_callback callback) {
+        on_improvement = callback;
+    }
+
+    // clusters found by label propagation, remapped to consecutive ids.
+    // In clusters with more than one terminal, the terminals are split off
+    // as single vertices and the other vertices stay together.
+    static std::pair<std::vector<NodeID>, std::vector<std::vector<NodeID> > >
+    clusterSeparatingTerminals(mutableGraphPtr G,
+                               const std::vector<NodeID>& terminals) {
+        label_propagation<mutableGraphPtr> lp;
+        std::vector<NodeID> cluster = lp.propagate_labels(G);
+
+        std::vector<NodeID> terminals_in_cluster(G->n(), 0);
+        std::vector<bool> is_terminal(G->n(), false);
+        for (NodeID t : terminals) {
+            terminals_in_cluster[cluster[t]]++;
+            is_terminal[t] = true;
+        }
+
+        std::vector<NodeID> mapping(G->n());
+        std::vector<NodeID> cluster_id(G->n(), UNDEFINED_NODE);
+        std::vector<std::vector<NodeID> > reverse_mapping;
+        for (NodeID v = 0; v < G->n(); ++v) {
+            NodeID c = cluster[v];
+            if (terminals_in_cluster[c] > 1 && is_terminal[v]) {
+                mapping[v] = reverse_mapping.size();
+                reverse_mapping.emplace_back(1, v);
+                continue;
+            }
+
+            if (cluster_id[c] == UNDEFINED_NODE) {
+                cluster_id[c] = reverse_mapping.size();
+                reverse_mapping.emplace_back();
+            }
+            mapping[v] = cluster_id[c];
+            reverse_mapping[cluster_id[c]].emplace_back(v);
+        }
+        return std::make_pair(mapping, reverse_mapping);
+    }
+
+ private:
+    // exact solution of the coarsest graph, only uses the calling thread
+    std::vector<NodeID> solveCoarsest(mutableGraphPtr G,
+                                      const std::vector<NodeID>& terminals) {
+        std::vector<bool> fixed(G->n(), false);
+        std::vector<terminal> problem_terminals;
+        for (size_t i = 0; i < terminals.size(); ++i) {
+            fixed[terminals[i]] = true;
+            problem_terminals.emplace_back(terminals[i], i);
+        }
+
+        branch_multicut bmc(*G, terminals, fixed, /* local */ true);
+        auto problem = std::make_shared<multicut_problem>(
+            std::make_shared<mutable_graph>(*G), problem_terminals);
+        return bmc.find_multiterminal_cut(problem).first;
+    }
+
+    const mutable_graph& original_graph;
+    std::vector<NodeID> original_terminals;
+    std::vector<bool> fixed_vertex;
+    bool local;
+    measurements msm;
+    incumbent_callback on_improvement;
+};
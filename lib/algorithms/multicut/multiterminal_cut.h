@@ -14,24 +14,45 @@
 #include <mpi.h>
 
 #include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <queue>
+#include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
-#include "algorithms/misc/strongly_connected_components.h"
+#include "algorithms/misc/connected_components.h"
 #include "algorithms/multicut/branch_multicut.h"
+#include "algorithms/multicut/multilevel_multicut.h"
 #include "data_structure/graph_access.h"
 #include "data_structure/mutable_graph.h"
 #include "io/graph_io.h"
 #include "tlx/string/split.hpp"
+#include "tools/timer.h"
 
 class multiterminal_cut {
  public:
     static constexpr bool debug = false;
-    multiterminal_cut() { }
+    multiterminal_cut() : lower_bound(0) { }
+
+    // called with the time since the start of multicut, the index of the
+    // connected component and its new best cut whenever that improves
+    void setIncumbentCallback(
+        std::function<void(double, size_t, FlowType)> callback) {
+        on_improvement = callback;
+    }
+
+    // lower bound on the optimal cut after multicut, equal to the returned
+    // cut unless the search was stopped early or a relative gap was allowed
+    FlowType lowerBound() const {
+        return lower_bound;
+    }
 
     std::vector<NodeID> setOriginalTerminals(mutableGraphPtr G) {
         auto config = configuration::getConfig();
@@ -93,39 +114,86 @@ class multiterminal_cut {
                     std::vector<NodeID> terminals, NodeID num_terminals) {
         auto cfg = configuration::getConfig();
         cfg->num_terminals = num_terminals;
+        timer t;
+
+        // every improvement is written to the incumbent file as a line
+        // "<seconds> <component> <cut>", one file per MPI process
+        std::mutex incumbent_mutex;
+        std::ofstream incumbent_file;
+        if (!cfg->incumbent_file.empty()) {
+            int mpi_rank = 0;
+            int mpi_size = 1;
+            MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+            MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+            std::string path = cfg->incumbent_file;
+            if (mpi_size > 1) {
+                path += "." + std::to_string(mpi_rank);
+            }
+            incumbent_file.open(path);
+        }
+
+        auto report = [&](size_t p, FlowType cut) {
+            std::lock_guard<std::mutex> lock(incumbent_mutex);
+            double time = t.elapsed();
+            if (incumbent_file.is_open()) {
+                incumbent_file << time << " " << p << " " << cut << std::endl;
+            }
+            if (on_improvement) {
+                on_improvement(time, p, cut);
+            }
+        };
 
         auto [problems, originalGraphs, nodeProblemMapping, positionInProblem,
               globalTerminalIndex, fixedVertex, connectedComponent, oneTermID]
             = splitConnectedComponents(G, terminals);
 
-        std::vector<std::vector<NodeID> > solutions;
+        std::vector<std::vector<NodeID> > solutions(problems.size());
+        std::vector<FlowType> flows(problems.size(), 0);
+        std::vector<FlowType> lower_bounds(problems.size(), 0);
         std::vector<NodeID> globalSolution;
 
-        FlowType flow_sum = 0;
+        std::vector<size_t> small_problems;
+        std::vector<size_t> large_problems;
         for (size_t p = 0; p < problems.size(); ++p) {
-            auto& problem = problems[p];
             if (debug) {
-                graph_algorithms::checkGraphValidity(problem.graph);
+                graph_algorithms::checkGraphValidity(problems[p].graph);
             }
-
-            std::vector<NodeID> p_terminals;
-            for (size_t i = 0; i < problem.terminals.size(); ++i) {
-                p_terminals.emplace_back(problem.terminals[i].position);
+            if (estimatedSize(problems[p]) <= cfg->small_component_size) {
+                small_problems.push_back(p);
+            } else {
+                large_problems.push_back(p);
             }
+        }
+
+        solveSmallComponents(problems, originalGraphs, fixedVertex,
+                             small_problems, report,
+                             &solutions, &flows, &lower_bounds);
 
+        for (size_t p : large_problems) {
+            auto& problem = problems[p];
             configuration::getConfig()->orign = problems[p].graph->n();
             configuration::getConfig()->origm = problems[p].graph->m();
 
-            branch_multicut bmc(originalGraphs[p], p_terminals, fixedVertex[p]);
-            auto p_pointer = std::make_shared<multicut_problem>(problem);
-            auto [sol, flow] = bmc.find_multiterminal_cut(p_pointer);
-            flow_sum += flow;
+            auto [sol, flow, lower] = solveComponent(
+                problem, originalGraphs[p], fixedVertex[p], /* local */ false,
+                [&report, p](FlowType cut, const std::vector<NodeID>&) {
+                    report(p, cut);
+                });
+            flows[p] = flow;
+            lower_bounds[p] = lower;
 
             if (cfg->write_solution || cfg->inexact) {
-                solutions.emplace_back(sol);
+                solutions[p] = sol;
             }
         }
 
+        FlowType flow_sum = 0;
+        lower_bound = 0;
+        for (size_t p = 0; p < problems.size(); ++p) {
+            flow_sum += flows[p];
+            lower_bound += lower_bounds[p];
+        }
+
         if (cfg->write_solution) {
             std::vector<NodeID> blocksize(cfg->num_terminals, 0);
             for (NodeID i = 0; i < G->n(); ++i) {
@@ -156,6 +224,98 @@ class multiterminal_cut {
     }
 
  private:
+    static size_t estimatedSize(const multicut_problem& problem) {
+        return problem.graph->n() + problem.graph->m();
+    }
+
+    static std::vector<NodeID> problemTerminals(
+        const multicut_problem& problem) {
+        std::vector<NodeID> p_terminals;
+        for (size_t i = 0; i < problem.terminals.size(); ++i) {
+            p_terminals.emplace_back(problem.terminals[i].position);
+        }
+        return p_terminals;
+    }
+
+    // solves a connected component with the solver set in the configuration,
+    // returns solution, cut and lower bound
+    static std::tuple<std::vector<NodeID>, FlowType, FlowType> solveComponent(
+        const multicut_problem& problem, const mutable_graph& original_graph,
+        const std::vector<bool>& fixed_vertex, bool local,
+        incumbent_callback on_component_improvement) {
+        auto p_pointer = std::make_shared<multicut_problem>(problem);
+        if (configuration::getConfig()->multicut_solver == "multilevel") {
+            multilevel_multicut mlm(original_graph, problemTerminals(problem),
+                                    fixed_vertex, local);
+            mlm.setIncumbentCallback(on_component_improvement);
+            auto [sol, flow] = mlm.find_multiterminal_cut(p_pointer);
+            return std::make_tuple(sol, flow, mlm.lowerBound());
+        }
+
+        branch_multicut bmc(original_graph, problemTerminals(problem),
+                            fixed_vertex, local);
+        bmc.setIncumbentCallback(on_component_improvement);
+        auto [sol, flow] = bmc.find_multiterminal_cut(p_pointer);
+        return std::make_tuple(sol, flow, bmc.lowerBound());
+    }
+
+    // components that are not larger than small_component_size can not use
+    // the whole thread pool of branch_multicut efficiently. Each of them is
+    // solved by a single thread without MPI communication, concurrently with
+    // the other small components. They are handed out largest first, so that
+    // all threads finish at roughly the same time. Every MPI process solves
+    // all small components, thus no communication is necessary.
+    void solveSmallComponents(
+        const std::vector<multicut_problem>& problems,
+        const std::vector<mutable_graph>& originalGraphs,
+        const std::vector<std::vector<bool> >& fixedVertex,
+        std::vector<size_t> small_problems,
+        const std::function<void(size_t, FlowType)>& report,
+        std::vector<std::vector<NodeID> >* solutions,
+        std::vector<FlowType>* flows,
+        std::vector<FlowType>* lower_bounds) {
+        auto cfg = configuration::getConfig();
+        std::sort(small_problems.begin(), small_problems.end(),
+                  [&problems](size_t a, size_t b) {
+                      return estimatedSize(problems[a])
+                             > estimatedSize(problems[b]);
+                  });
+
+        std::atomic<size_t> next_problem = 0;
+        auto solveNext = [&]() {
+            for (size_t i = next_problem++; i < small_problems.size();
+                 i = next_problem++) {
+                size_t p = small_problems[i];
+                auto [sol, flow, lower] = solveComponent(
+                    problems[p], originalGraphs[p], fixedVertex[p],
+                    /* local */ true,
+                    [&report, p](FlowType cut, const std::vector<NodeID>&) {
+                        report(p, cut);
+                    });
+                (*flows)[p] = flow;
+                (*lower_bounds)[p] = lower;
+
+                if (cfg->write_solution || cfg->inexact) {
+                    (*solutions)[p] = sol;
+                }
+            }
+        };
+
+        size_t num_threads = std::min(cfg->threads, small_problems.size());
+        if (num_threads <= 1) {
+            solveNext();
+        } else {
+            std::vector<std::thread> threads;
+            for (size_t i = 0; i < num_threads; ++i) {
+                threads.emplace_back(solveNext);
+            }
+            for (auto& t : threads) {
+                t.join();
+            }
+        }
+        LOG << "solved " << small_problems.size() << " small components";
+    }
+
     static std::vector<NodeID> addSurroundingAreaToTerminals(
         mutableGraphPtr graph,
         std::vector<NodeID> terminals) {
@@ -207,11 +367,11 @@ class multiterminal_cut {
         std::vector<mutable_graph> originalGraphs;
         std::vector<std::vector<bool> > fixedVertex;
         std::vector<int> t_comp;
-        strongly_connected_components cc;
 
         auto config = configuration::getConfig();
 
-        auto [components, num_comp, blocksizes] = cc.strong_components(G);
+        auto [components, num_comp, blocksizes] =
+            connected_components::components(G);
         (void)blocksizes;
 
         std::vector<NodeID> nodeProblemMapping(G->n(), UNDEFINED_NODE);
@@ -412,4 +572,7 @@ class multiterminal_cut {
 
         return terminalMapping;
     }
+
+    std::function<void(double, size_t, FlowType)> on_improvement;
+    FlowType lower_bound;
 };
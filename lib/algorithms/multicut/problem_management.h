@@ -11,7 +11,10 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <unordered_set>
@@ -21,11 +24,17 @@
 #include "algorithms/multicut/multicut_problem.h"
 #include "algorithms/multicut/problem_queues/per_thread_problem_queue.h"
 #include "algorithms/multicut/problem_queues/single_problem_queue.h"
+#include "algorithms/multicut/transposition_table.h"
 #include "common/configuration.h"
 #include "data_structure/mutable_graph.h"
 
 using namespace std::chrono_literals;
 
+// called with the cut value and the solution (block of every vertex of the
+// original graph) whenever the best known solution improves
+typedef std::function<void(FlowType, const std::vector<NodeID>&)>
+    incumbent_callback;
+
 class problem_management {
  private:
     static const bool testing = false;
@@ -53,6 +62,15 @@ class problem_management {
 
     std::vector<NodeID> best_solution;
     bool bestSolutionInitialized;
+    incumbent_callback on_improvement;
+    // lower bound of the problem every thread is working on
+    std::vector<std::atomic<FlowType> > running_lower_bound;
+    // minimum lower bound of problems that were not solved to the end, as
+    // the search was stopped by timeout or memory limit
+    std::atomic<FlowType> abandoned_lower_bound;
+    // problems that were already seen, disabled for local instances as they
+    // only solve small components
+    transposition_table seen_problems;
     measurements msm;
     timer t;
     int mpi_size;
@@ -61,26 +79,38 @@ class problem_management {
  public:
     problem_management(const mutable_graph& original_graph,
                        const std::vector<NodeID>& original_terminals,
-                       const std::vector<bool>& fixed_vertex)
+                       const std::vector<bool>& fixed_vertex,
+                       size_t threads = configuration::getConfig()->threads,
+                       bool local = false)
         : original_terminals(original_terminals),
           original_graph(original_graph),
           fixed_vertex(fixed_vertex),
-          problems(configuration::getConfig()->threads,
-                   configuration::getConfig()->queue_type),
-          mf(original_terminals),
-          num_threads(configuration::getConfig()->threads),
-          q_mutex(configuration::getConfig()->threads),
-          q_cv(configuration::getConfig()->threads),
+          problems(threads, configuration::getConfig()->queue_type),
+          mf(original_terminals, threads),
+          num_threads(threads),
+          q_mutex(threads),
+          q_cv(threads),
           is_finished(false),
           idle_threads(0),
           global_upper_bound(UNDEFINED_FLOW),
           terminalGUB(original_terminals.size() + 1, UNDEFINED_FLOW),
           beforeLSGUB(original_terminals.size() + 1, UNDEFINED_FLOW),
           bestSolutionInitialized(false),
-          msm(this->original_graph, this->original_terminals) {
-        MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
-        MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+          running_lower_bound(threads),
+          abandoned_lower_bound(UNDEFINED_FLOW),
+          seen_problems(local ? 0 : configuration::getConfig()
+                        ->transposition_table_size << 20),
+          msm(this->original_graph, this->original_terminals),
+          mpi_size(1),
+          mpi_rank(0) {
+        if (!local) {
+            MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+            MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+        }
         best_solution.resize(original_graph.number_of_nodes());
+        for (auto& lb : running_lower_bound) {
+            lb = UNDEFINED_FLOW;
+        }
     }
 
     bool degreeThreeContraction(problemPointer problem,
@@ -221,6 +251,12 @@ class problem_management {
             return findBestSolution(&sol, numTerminals);
         }
 
+        if (seen_problems.enabled() && seen_problems.checkAndInsert(
+                transposition_table::problemHash(new_p, original_graph.n()),
+                new_p->lower_bound)) {
+            return std::nullopt;
+        }
+
         if (numTerminals == 2) {
             mf.maximumSTFlow(new_p);
             if (runLocalSearch(new_p)) {
@@ -271,12 +307,7 @@ class problem_management {
             global_upper_bound = prev_gub;
             LOG1 << "Improvement after " << t.elapsed()
                  << " to " << prev_gub << " (beforehand)";
-            bestsol_mutex.lock();
-            for (size_t i = 0; i < current_solution->size(); ++i) {
-                best_solution[i] = (*current_solution)[i];
-            }
-            initalizeBestSolution();
-            bestsol_mutex.unlock();
+            setBestSolution(*current_solution, prev_gub);
         }
         FlowType total_improvement = ls.improveSolution(t);
         FlowType ls_bound = prev_gub - total_improvement;
@@ -289,18 +320,25 @@ class problem_management {
         if (ls_bound < global_upper_bound || !bestSolutionInitialized) {
             global_upper_bound = ls_bound;
             LOG1 << "Improvement after " << t.elapsed() << " to " << ls_bound;
-
-            bestsol_mutex.lock();
-            for (size_t i = 0; i < current_solution->size(); ++i) {
-                best_solution[i] = (*current_solution)[i];
-            }
-            initalizeBestSolution();
-            bestsol_mutex.unlock();
+            setBestSolution(*current_solution, ls_bound);
             return ls_bound;
         }
         return std::nullopt;
     }
 
+    void setBestSolution(const std::vector<NodeID>& solution,
+                         FlowType value) {
+        bestsol_mutex.lock();
+        for (size_t i = 0; i < solution.size(); ++i) {
+            best_solution[i] = solution[i];
+        }
+        initalizeBestSolution();
+        if (on_improvement) {
+            on_improvement(value, best_solution);
+        }
+        bestsol_mutex.unlock();
+    }
+
     void singleBranch(problemPointer problem,
                       size_t thread_id) {
         auto [b_vtx, b_edge] = findEdgeSingleBranch(problem);
@@ -367,8 +405,12 @@ class problem_management {
         return problems.size();
     }
 
+    size_t spillProblems() {
+        return problems.spillProblems();
+    }
+
     void prepareQueue(size_t thread_id) {
-        problems.prepareQueue(thread_id, global_upper_bound);
+        problems.prepareQueue(thread_id, pruneBound());
     }
 
     void addProblem(problemPointer p,
@@ -377,7 +419,54 @@ class problem_management {
     }
 
     bool checkProblem(problemPointer problem) {
-        return problem->lower_bound < global_upper_bound;
+        return problem->lower_bound < pruneBound();
+    }
+
+    // problems with a lower bound of at least this value are discarded. With
+    // a relative gap g > 0, this also discards problems that can improve the
+    // best solution by at most g * global_upper_bound. As the upper bound
+    // only decreases, the final solution is within that gap of the optimum.
+    FlowType pruneBound() {
+        FlowType upper = global_upper_bound;
+        double gap = configuration::getConfig()->gap;
+        if (gap <= 0 || upper == UNDEFINED_FLOW) {
+            return upper;
+        }
+        return upper - static_cast<FlowType>(
+            std::floor(gap * static_cast<double>(upper)));
+    }
+
+    // lower bound on the optimum: minimum lower bound of all open problems,
+    // including the ones that are currently solved or were abandoned when
+    // the search was stopped. As problems are only discarded if they are not
+    // below pruneBound, the optimum is also at least that.
+    FlowType globalLowerBound() {
+        FlowType lower = std::min(pruneBound(), problems.lowerBound());
+        lower = std::min(lower, abandoned_lower_bound.load());
+        for (const auto& lb : running_lower_bound) {
+            lower = std::min(lower, lb.load());
+        }
+        return lower;
+    }
+
+    void startProblem(size_t thread_id, problemPointer problem) {
+        running_lower_bound[thread_id] = problem->lower_bound;
+    }
+
+    void finishProblem(size_t thread_id, bool abandoned) {
+        FlowType lower = running_lower_bound[thread_id];
+        FlowType prev = abandoned_lower_bound;
+        while (abandoned && lower < prev
+               && !abandoned_lower_bound.compare_exchange_weak(prev, lower)) { }
+        running_lower_bound[thread_id] = UNDEFINED_FLOW;
+    }
+
+    void setIncumbentCallback(incumbent_callback callback) {
+        on_improvement = callback;
+    }
+
+    size_t prunedDuplicates() {
+        return seen_problems.prunedProblems();
     }
 
     bool runLocalSearch(problemPointer problem) {
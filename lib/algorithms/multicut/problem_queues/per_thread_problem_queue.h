@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "algorithms/multicut/multicut_problem.h"
+#include "algorithms/multicut/problem_queues/problem_spill_file.h"
 #include "common/configuration.h"
 
 class per_thread_problem_queue {
@@ -31,7 +32,10 @@ class per_thread_problem_queue {
           haveSendProblem(false),
           sendProblemWeight(UNDEFINED_FLOW),
           pop_mutex(threads),
-          sizes(threads) {
+          sizes(threads),
+          spill(configuration::getConfig()->spill_directory),
+          spilled_problems(spilled_lower_bound),
+          num_spilled(0) {
         for (size_t i = 0; i < num_threads; ++i) {
             sizes[i].second = false;
 
@@ -92,7 +96,40 @@ class per_thread_problem_queue {
                 break;
             }
         }
+        bool drained = (pq[local_id].size() == 0);
         pop_mutex[local_id].unlock();
+
+        if (drained && num_spilled > 0) {
+            reloadProblem(local_id, global_upper_bound);
+        }
+    }
+
+    // moves the worse half of every queue to the spill file, only stubs with
+    // their bounds stay in memory. Returns the number of problems moved.
+    size_t spillProblems() {
+        std::lock_guard<std::mutex> spill_lock(spill_mutex);
+        size_t spilled = 0;
+        for (size_t i = 0; i < num_threads; ++i) {
+            std::lock_guard<std::mutex> pop_lock(pop_mutex[i]);
+            std::vector<problemPointer> problems;
+            while (pq[i].size() > 0) {
+                problems.emplace_back(pq[i].top());
+                pq[i].pop();
+            }
+
+            size_t keep = (problems.size() + 1) / 2;
+            for (size_t j = 0; j < problems.size(); ++j) {
+                if (j < keep) {
+                    pq[i].push(problems[j]);
+                } else {
+                    spilled_problems.push(spill.store(problems[j]));
+                }
+            }
+            sizes[i].first -= problems.size() - keep;
+            spilled += problems.size() - keep;
+        }
+        num_spilled += spilled;
+        return spilled;
     }
 
     std::optional<problemPointer> pullProblem(size_t local_id, bool sending) {
@@ -211,7 +248,31 @@ class per_thread_problem_queue {
                 return std::make_pair(e1.first + e2.first, true);
             }).first;
         size_t sendProblemSize = haveSendProblem ? 1 : 0;
-        return sum_queue + sendProblemSize;
+        return sum_queue + sendProblemSize + num_spilled;
+    }
+
+    // minimum lower bound of all queued and spilled problems
+    FlowType lowerBound() {
+        FlowType lower = UNDEFINED_FLOW;
+        for (size_t i = 0; i < num_threads; ++i) {
+            std::lock_guard<std::mutex> pop_lock(pop_mutex[i]);
+            for (const auto& p : pq[i].elements()) {
+                lower = std::min(lower, p->lower_bound);
+            }
+        }
+
+        send_problem_mutex.lock();
+        if (haveSendProblem) {
+            lower = std::min(lower, sendProblem->lower_bound);
+        }
+        send_problem_mutex.unlock();
+
+        spill_mutex.lock();
+        if (spilled_problems.size() > 0) {
+            lower = std::min(lower, spilled_problems.top().lower_bound);
+        }
+        spill_mutex.unlock();
+        return lower;
     }
 
     bool haveASendProblem() {
@@ -223,6 +284,41 @@ class per_thread_problem_queue {
     }
 
  private:
+    // loads the spilled problem with the lowest lower bound into queue
+    // local_id. Spilled problems that can not improve on the global upper
+    // bound are dropped without loading them.
+    void reloadProblem(size_t local_id, FlowType global_upper_bound) {
+        problemPointer problem;
+        spill_mutex.lock();
+        while (spilled_problems.size() > 0 && problem == nullptr) {
+            problem_spill_file::stub s = spilled_problems.top();
+            spilled_problems.pop();
+            num_spilled--;
+            if (s.lower_bound < global_upper_bound) {
+                problem = spill.load(s);
+            } else {
+                spill.release(s);
+            }
+        }
+        if (spilled_problems.size() == 0) {
+            spill.clear();
+        }
+        spill_mutex.unlock();
+
+        if (problem != nullptr) {
+            pop_mutex[local_id].lock();
+            pq[local_id].push(problem);
+            sizes[local_id].first += 1;
+            pop_mutex[local_id].unlock();
+        }
+    }
+
+    constexpr static auto spilled_lower_bound =
+        [](const problem_spill_file::stub& s1,
+           const problem_spill_file::stub& s2) {
+            return s1.lower_bound > s2.lower_bound;
+        };
+
     constexpr static auto small_graph =
         [](const problemPointer& p1, const problemPointer& p2) {
             return p1->graph->n() > p2->graph->n();
@@ -280,11 +376,23 @@ class per_thread_problem_queue {
 
     size_t num_threads;
 
-    std::vector<std::priority_queue<problemPointer,
-                                    std::vector<problemPointer>,
-                                    std::function<
-                                        bool(const problemPointer&,
-                                             const problemPointer&)> > > pq;
+    typedef std::priority_queue<problemPointer,
+                                std::vector<problemPointer>,
+                                std::function<
+                                    bool(const problemPointer&,
+                                         const problemPointer&)> > problem_pq;
+
+    // priority queue that allows to scan all its elements
+    class problem_heap : public problem_pq {
+     public:
+        using problem_pq::problem_pq;
+
+        const std::vector<problemPointer>& elements() const {
+            return this->c;
+        }
+    };
+
+    std::vector<problem_heap> pq;
 
     problemPointer sendProblem;
     bool haveSendProblem;
@@ -293,4 +401,14 @@ class per_thread_problem_queue {
     std::vector<std::mutex> pop_mutex;
     std::mutex send_problem_mutex;
     std::vector<std::pair<std::atomic<size_t>, bool> > sizes;
+
+    problem_spill_file spill;
+    std::priority_queue<problem_spill_file::stub,
+                        std::vector<problem_spill_file::stub>,
+                        std::function<
+                            bool(const problem_spill_file::stub&,
+                                 const problem_spill_file::stub&)> >
+    spilled_problems;
+    std::mutex spill_mutex;
+    std::atomic<size_t> num_spilled;
 };
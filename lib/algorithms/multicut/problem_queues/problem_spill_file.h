@@ -0,0 +1,174 @@
+/******************************************************************************
+ * problem_spill_file.h
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#pragma once
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "algorithms/multicut/multicut_problem.h"
+#include "common/definitions.h"
+#include "tlx/logger.hpp"
+
+// Open problems of the branch and bound that were moved out of memory. They
+// are appended to a temporary file, which is unlinked right after creation
+// and thus removed when it is closed. Only a stub with the bounds of the
+// problem and its position in the file stays in memory. The space of loaded
+// or dropped problems is reused for later problems. Not thread-safe.
+class problem_spill_file {
+ public:
+    static constexpr bool debug = false;
+
+    struct stub {
+        FlowType lower_bound;
+        FlowType upper_bound;
+        // position and length in number of uint64_t
+        size_t   offset;
+        size_t   size;
+    };
+
+    explicit problem_spill_file(const std::string& directory)
+        : directory(directory),
+          fd(-1),
+          end(0) { }
+
+    ~problem_spill_file() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    problem_spill_file(const problem_spill_file&) = delete;
+    problem_spill_file& operator = (const problem_spill_file&) = delete;
+
+    stub store(problemPointer problem) {
+        open();
+        std::vector<uint64_t> data = problem->serialize();
+        stub s { problem->lower_bound, problem->upper_bound, end, data.size() };
+        // first free extent that is large enough
+        for (auto it = free_extents.begin(); it != free_extents.end(); ++it) {
+            if (it->second >= data.size()) {
+                s.offset = it->first;
+                if (it->second > data.size()) {
+                    free_extents[it->first + data.size()] =
+                        it->second - data.size();
+                }
+                free_extents.erase(it);
+                break;
+            }
+        }
+        transfer(data.data(), s, /* write */ true);
+        end = std::max(end, s.offset + data.size());
+        return s;
+    }
+
+    problemPointer load(const stub& s) {
+        std::vector<uint64_t> data(s.size);
+        transfer(data.data(), s, /* write */ false);
+        release(s);
+        return multicut_problem::deserialize(data);
+    }
+
+    // the problem of stub s is not needed anymore, its space can be reused
+    void release(const stub& s) {
+        auto it = free_extents.emplace(s.offset, s.size).first;
+        auto next = std::next(it);
+        if (next != free_extents.end()
+            && it->first + it->second == next->first) {
+            it->second += next->second;
+            free_extents.erase(next);
+        }
+        if (it != free_extents.begin()) {
+            auto prev = std::prev(it);
+            if (prev->first + prev->second == it->first) {
+                prev->second += it->second;
+                free_extents.erase(it);
+                it = prev;
+            }
+        }
+        // free space at the end of the file is returned to the file system
+        if (it->first + it->second == end) {
+            end = it->first;
+            free_extents.erase(it);
+            truncate();
+        }
+    }
+
+    // all stubs were loaded, the space in the file can be reused
+    void clear() {
+        free_extents.clear();
+        end = 0;
+        truncate();
+    }
+
+    // size of the file in number of uint64_t
+    size_t fileSize() const {
+        return end;
+    }
+
+ private:
+    void open() {
+        if (fd >= 0)
+            return;
+
+        std::string dir = directory;
+        if (dir.empty()) {
+            const char* tmpdir = getenv("TMPDIR");
+            dir = tmpdir ? tmpdir : "/tmp";
+        }
+        std::string path = dir + "/viecut_spill_XXXXXX";
+        fd = mkstemp(path.data());
+        if (fd < 0) {
+            LOG1 << "Error: could not create spill file in " << dir;
+            exit(1);
+        }
+        unlink(path.c_str());
+        LOG << "created spill file " << path;
+    }
+
+    void truncate() {
+        if (fd >= 0 && ftruncate(fd, end * sizeof(uint64_t)) != 0) {
+            LOG1 << "Error: could not truncate spill file";
+            exit(1);
+        }
+    }
+
+    void transfer(uint64_t* data, const stub& s, bool write) {
+        char* ptr = reinterpret_cast<char*>(data);
+        size_t bytes = s.size * sizeof(uint64_t);
+        off_t position = s.offset * sizeof(uint64_t);
+        while (bytes > 0) {
+            ssize_t done = write ? pwrite(fd, ptr, bytes, position)
+                                 : pread(fd, ptr, bytes, position);
+            if (done <= 0) {
+                LOG1 << "Error: could not " << (write ? "write" : "read")
+                     << " spill file";
+                exit(1);
+            }
+            ptr += done;
+            bytes -= done;
+            position += done;
+        }
+    }
+
+    std::string directory;
+    int fd;
+    size_t end;
+    // offset and length of unused space before end
+    std::map<size_t, size_t> free_extents;
+};
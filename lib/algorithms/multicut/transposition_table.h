@@ -0,0 +1,148 @@
+/******************************************************************************
+ * transposition_table.h
+ *
+ * Source of VieCut
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "algorithms/multicut/multicut_problem.h"
+#include "common/definitions.h"
+#include "data_structure/mutable_graph.h"
+#include "tlx/logger.hpp"
+#include "tools/hash.h"
+
+// Hash table of the branch and bound problems that were already seen, as
+// different branching orders can result in the same problem. A problem is
+// identified by a 64 bit hash of the partition of the original vertices into
+// the vertices of the problem graph, the position of every terminal, the
+// edges of the problem graph and the deleted weight. The edges are needed as
+// branches that delete different edges of the same weight have the same
+// partition and deleted weight. The table has a fixed number of slots and is
+// filled with
+// lock-free compare-and-swap. If all slots in the probe window of a problem
+// are taken, it is not stored.
+class transposition_table {
+ public:
+    static constexpr bool debug = false;
+
+    // number of slots that are checked for a key
+    static constexpr size_t max_probes = 8;
+
+    explicit transposition_table(size_t bytes)
+        : num_slots(bytes / sizeof(slot)),
+          slots(num_slots),
+          num_pruned(0) { }
+
+    bool enabled() const {
+        return num_slots > 0;
+    }
+
+    // hash of the current state of problem. Every vertex of the problem graph
+    // is identified by the smallest original vertex it contains, so that the
+    // hash does not depend on the vertex ids in the problem graph. Edges are
+    // sorted by their endpoints in this numbering, as the order of edges
+    // also depends on the order of contractions.
+    static uint64_t problemHash(problemPointer problem, NodeID original_n) {
+        mutableGraphPtr G = problem->graph;
+        std::vector<NodeID> smallest(G->n(), UNDEFINED_NODE);
+        std::vector<uint64_t> state;
+        state.reserve(original_n + 2 * problem->terminals.size()
+                      + G->m() + 2);
+        for (NodeID n = 0; n < original_n; ++n) {
+            NodeID v = G->getCurrentPosition(problem->mapped(n));
+            if (smallest[v] == UNDEFINED_NODE) {
+                smallest[v] = n;
+            }
+            state.emplace_back(smallest[v]);
+        }
+
+        for (const auto& t : problem->terminals) {
+            state.emplace_back(t.original_id);
+            state.emplace_back(smallest[t.position]);
+        }
+
+        // (endpoints, weight) of every edge in one direction
+        std::vector<std::pair<uint64_t, uint64_t> > edges;
+        edges.reserve(G->m() / 2);
+        for (NodeID v : G->nodes()) {
+            for (EdgeID e : G->edges_of(v)) {
+                NodeID t = G->getEdgeTarget(v, e);
+                if (smallest[v] < smallest[t]) {
+                    uint64_t endpoints = (static_cast<uint64_t>(smallest[v])
+                                          << 32) | smallest[t];
+                    edges.emplace_back(endpoints, G->getEdgeWeight(v, e));
+                }
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        state.emplace_back(edges.size());
+        for (const auto& [endpoints, weight] : edges) {
+            state.emplace_back(endpoints);
+            state.emplace_back(weight);
+        }
+        state.emplace_back(problem->deleted_weight);
+
+        uint64_t hash = XXH64(state.data(), state.size() * sizeof(uint64_t),
+                              0);
+        // 0 marks an empty slot
+        return hash == 0 ? 1 : hash;
+    }
+
+    // returns true if a problem with the same hash and a lower bound of at
+    // most lower_bound was already inserted. Otherwise, the problem is
+    // inserted or its stored lower bound is decreased.
+    bool checkAndInsert(uint64_t hash, FlowType lower_bound) {
+        for (size_t i = 0; i < max_probes; ++i) {
+            slot& s = slots[(hash + i) % num_slots];
+            uint64_t key = s.key.load(std::memory_order_acquire);
+            if (key == 0) {
+                if (!s.key.compare_exchange_strong(
+                        key, hash, std::memory_order_acq_rel)) {
+                    // another thread claimed the slot, check its key
+                    if (key != hash) {
+                        continue;
+                    }
+                }
+            } else if (key != hash) {
+                continue;
+            }
+
+            FlowType stored = s.lower_bound.load(std::memory_order_acquire);
+            while (lower_bound < stored) {
+                if (s.lower_bound.compare_exchange_weak(
+                        stored, lower_bound, std::memory_order_acq_rel)) {
+                    return false;
+                }
+            }
+            ++num_pruned;
+            return true;
+        }
+        return false;
+    }
+
+    size_t prunedProblems() const {
+        return num_pruned;
+    }
+
+ private:
+    struct slot {
+        std::atomic<uint64_t> key = 0;
+        std::atomic<FlowType> lower_bound = UNDEFINED_FLOW;
+    };
+
+    size_t num_slots;
+    std::vector<slot> slots;
+    std::atomic<size_t> num_pruned;
+};
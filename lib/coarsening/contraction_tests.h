@@ -15,11 +15,13 @@
 #include <cstdint>
 #include <cstdlib>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
 #include "common/definitions.h"
 #include "data_structure/graph_access.h"
+#include "data_structure/sorted_adjacency.h"
 #include "data_structure/union_find.h"
 #include "tlx/logger.hpp"
 
@@ -100,8 +102,14 @@ class tests {
                                 EdgeWeight weight_limit,
                                 bool find_all_cuts = false) {
         union_find uf(G->number_of_nodes());
+        // with sorted adjacency lists, the triangles of an edge are found by
+        // intersecting the neighborhoods of its vertices instead of marking
+        std::optional<sorted_adjacency> sorted;
+        if (sorted_adjacency::enabled()) {
+            sorted.emplace(G);
+        }
         std::vector<std::pair<NodeID, EdgeID> > marked(
-            G->number_of_nodes(),
+            sorted ? 0 : G->number_of_nodes(),
             std::make_pair(UNDEFINED_NODE, UNDEFINED_EDGE));
         std::vector<bool> finished(G->number_of_nodes(), false);
         std::vector<bool> contracted(G->number_of_nodes(), false);
@@ -113,7 +121,7 @@ class tests {
             finished[n] = true;
             for (EdgeID e : G->edges_of(n)) {
                 NodeID tgt = G->getEdgeTarget(n, e);
-                if (tgt > n) {
+                if (tgt > n && !sorted) {
                     marked[tgt] = std::make_pair(n, e);
                 }
             }
@@ -123,51 +131,66 @@ class tests {
                 NodeID tgt = G->getEdgeTarget(n, e1);
                 EdgeWeight deg_tgt = G->getWeightedNodeDegree(tgt);
                 if (finished[tgt]) {
-                    marked[tgt] =
-                        std::make_pair(UNDEFINED_NODE, UNDEFINED_EDGE);
+                    if (!sorted) {
+                        marked[tgt] =
+                            std::make_pair(UNDEFINED_NODE, UNDEFINED_EDGE);
+                    }
                     continue;
                 }
 
                 EdgeWeight w1 = G->getEdgeWeight(n, e1);
                 finished[tgt] = true;
                 EdgeWeight wgt_sum = w1;
+                // triangle n - tgt - tgt2 with w2 = w(tgt, tgt2) and
+                // w3 = w(n, tgt2)
+                auto triangle = [&](EdgeWeight w2, EdgeWeight w3) {
+                    wgt_sum += std::min(w2, w3);
+
+                    bool contractible_one_cut =
+                        !find_all_cuts && 2 * (w1 + w3) >= deg_n
+                        && 2 * (w1 + w2) >= deg_tgt;
+
+                    // if we want to find all cuts
+                    // we are not allowed to contract an edge
+                    // when an incident vertex has degree mincut
+                    // (as the singleton cut might be important)
+                    // also the triangle having exactly half the weight
+                    // of n or tgt ir not enough any more
+                    bool contractible_all_cuts =
+                        find_all_cuts
+                        && 2 * (w1 + w3) > deg_n && 2 * (w1 + w2) > deg_tgt
+                        && deg_n >= weight_limit && deg_tgt >= weight_limit;
+
+                    if ((contractible_one_cut || contractible_all_cuts)
+                        && !contracted[n] && !contracted[tgt]) {
+                        uf.Union(n, tgt);
+                        contracted[n] = true;
+                        contracted[tgt] = true;
+                    }
+                };
+
                 if (tgt > n) {
-                    for (EdgeID e2 : G->edges_of(tgt)) {
-                        NodeID tgt2 = G->getEdgeTarget(tgt, e2);
-                        if (marked[tgt2].second == UNDEFINED_EDGE)
-                            continue;
+                    if (sorted) {
+                        sorted->intersect(n, tgt, [&](NodeID, EdgeWeight w3,
+                                                      EdgeWeight w2) {
+                                              triangle(w2, w3);
+                                          });
+                    } else {
+                        for (EdgeID e2 : G->edges_of(tgt)) {
+                            NodeID tgt2 = G->getEdgeTarget(tgt, e2);
+                            if (marked[tgt2].second == UNDEFINED_EDGE)
+                                continue;
 
-                        if (marked[tgt2].first != n) {
-                            continue;
-                        }
+                            if (marked[tgt2].first != n) {
+                                continue;
+                            }
 
-                        EdgeWeight w2 = G->getEdgeWeight(tgt, e2);
-                        EdgeWeight w3 =
-                            G->getEdgeWeight(n, marked[tgt2].second);
-
-                        wgt_sum += std::min(w2, w3);
-
-                        bool contractible_one_cut =
-                            !find_all_cuts && 2 * (w1 + w3) >= deg_n
-                            && 2 * (w1 + w2) >= deg_tgt;
-
-                        // if we want to find all cuts
-                        // we are not allowed to contract an edge
-                        // when an incident vertex has degree mincut
-                        // (as the singleton cut might be important)
-                        // also the triangle having exactly half the weight
-                        // of n or tgt ir not enough any more
-                        bool contractible_all_cuts =
-                            find_all_cuts
-                            && 2 * (w1 + w3) > deg_n && 2 * (w1 + w2) > deg_tgt
-                            && deg_n >= weight_limit && deg_tgt >= weight_limit;
-
-                        if ((contractible_one_cut || contractible_all_cuts)
-                            && !contracted[n] && !contracted[tgt]) {
-                            uf.Union(n, tgt);
-                            contracted[n] = true;
-                            contracted[tgt] = true;
+                            triangle(G->getEdgeWeight(tgt, e2),
+                                     G->getEdgeWeight(
+                                         n, marked[tgt2].second));
                         }
+                        marked[tgt] =
+                            std::make_pair(UNDEFINED_NODE, UNDEFINED_EDGE);
                     }
 
                     if (wgt_sum >= weight_limit) {
@@ -175,8 +198,6 @@ class tests {
                         contracted[n] = true;
                         contracted[tgt] = true;
                     }
-                    marked[tgt] =
-                        std::make_pair(UNDEFINED_NODE, UNDEFINED_EDGE);
                 }
             }
         }
@@ -19,10 +19,13 @@
 #include <utility>
 #include <vector>
 
+#include "common/configuration.h"
 #include "common/definitions.h"
 #include "data_structure/graph_access.h"
+#include "data_structure/sparse_accumulator.h"
 #include "tlx/logger.hpp"
 #include "tools/random_functions.h"
+#include "tools/timer.h"
 
 template <class GraphPtr>
 class label_propagation {
@@ -32,58 +35,91 @@ class label_propagation {
     label_propagation() { }
     virtual ~label_propagation() { }
 
+    // Label propagation with an active vertex set: the first round visits
+    // all vertices in random order, later rounds only visit vertices that
+    // have a neighbor which changed its label in the previous round. Stops
+    // after lp_iterations rounds or when at most a fraction lp_convergence
+    // of the vertices changed their label. A vertex only joins a cluster
+    // with less than lp_cluster_size vertices (if set).
     std::vector<NodeID> propagate_labels(GraphPtr G) {
         timer t;
-        std::vector<NodeID> cluster_id(G->number_of_nodes());
-        std::vector<NodeID> permutation(G->number_of_nodes());
-        bool timing = configuration::getConfig()->verbose;
-
-        // use this vector to store connection strengths to blocks.
-        // in order to only reset elements
-        // that are actually written in we store (in second)
-        // which vertex last used this element.
-        std::vector<std::pair<EdgeWeight, NodeID> > hash_vec(
-            G->number_of_nodes(), std::make_pair(0, 0));
+        auto cfg = configuration::getConfig();
+        bool timing = cfg->verbose;
+        NodeID num_nodes = G->number_of_nodes();
+        NodeID max_size = cfg->lp_cluster_size;
+        std::vector<NodeID> cluster_id(num_nodes);
+        std::vector<NodeID> cluster_size(max_size > 0 ? num_nodes : 0, 1);
+        std::vector<NodeID> active(num_nodes);
+        std::vector<NodeID> next_active;
+        std::vector<bool> in_next(num_nodes, false);
+        sparse_accumulator connection;
 
         for (size_t i = 0; i < cluster_id.size(); ++i) {
             cluster_id[i] = i;
         }
 
-        random_functions::permutate_vector_local(&permutation, true);
-
-        size_t iterations = 2;
+        random_functions::permutate_vector_local(&active, true);
 
-        LOG << "Number of iterations: " << iterations;
+        LOG << "Maximum number of iterations: " << cfg->lp_iterations;
 
-        // size_t change = G.number_of_nodes();
-        for (size_t j = 0; j < iterations; j++) {
-            for (NodeID node : G->nodes()) {
-                NodeID n = permutation[node];
-                PartitionID max_block = cluster_id[n];
+        for (size_t j = 0; j < cfg->lp_iterations && !active.empty(); j++) {
+            size_t changed = 0;
+            for (NodeID n : active) {
+                PartitionID old_block = cluster_id[n];
+                PartitionID max_block = old_block;
                 EdgeWeight max_value = 0;
+                connection.reset(G->getUnweightedNodeDegree(n));
                 for (EdgeID e : G->edges_of(n)) {
                     NodeID target = G->getEdgeTarget(n, e);
                     PartitionID block = cluster_id[target];
-                    // we want to store connection of vertex n to block 'block'
-                    // thus reset now that we look at outgoing edges from n
-                    if (hash_vec[block].second != n) {
-                        hash_vec[block].first = 0;
-                        hash_vec[block].second = n;
+                    if (max_size > 0 && block != old_block
+                        && cluster_size[block] >= max_size) {
+                        continue;
                     }
-                    hash_vec[block].first += G->getEdgeWeight(n, e);
+                    EdgeWeight value =
+                        connection.add(block, G->getEdgeWeight(n, e));
                     // set strongest connected block if higher
                     // connection strength, random if equal
-                    if (hash_vec[block].first > max_value ||
-                        (hash_vec[block].first == max_value &&
-                         random_functions::next() % 2)) {
-                        max_value = hash_vec[block].first;
+                    if (value > max_value ||
+                        (value == max_value && random_functions::next() % 2)) {
+                        max_value = value;
                         max_block = block;
                     }
                 }
+
+                // stay in current block if it is one of the strongest, so
+                // that ties do not keep the vertex and its neighbors active
+                if (max_block == old_block
+                    || connection.get(old_block) == max_value) {
+                    continue;
+                }
+
                 cluster_id[n] = max_block;
+                if (max_size > 0) {
+                    --cluster_size[old_block];
+                    ++cluster_size[max_block];
+                }
+                ++changed;
+                for (EdgeID e : G->edges_of(n)) {
+                    NodeID target = G->getEdgeTarget(n, e);
+                    if (!in_next[target]) {
+                        in_next[target] = true;
+                        next_active.emplace_back(target);
+                    }
+                }
             }
-            LOGC(timing) << "LP: Iteration " << j
-                         << " -  Timer: " << t.elapsedToZero();
+
+            LOGC(timing) << "LP: Iteration " << j << " - " << changed
+                         << " changes, Timer: " << t.elapsedToZero();
+
+            for (NodeID n : next_active) {
+                in_next[n] = false;
+            }
+            active.swap(next_active);
+            next_active.clear();
+
+            if (changed <= cfg->lp_convergence * num_nodes)
+                break;
         }
 
         return cluster_id;
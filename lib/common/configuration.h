@@ -59,8 +59,30 @@ class configuration {
     size_t maximumBranchingFactor = 5;
     bool multibranch = true;
     bool inexact = false;
+    // "exact" branch and bound or "multilevel" heuristic, which coarsens the
+    // graph until it has at most multilevel_coarsest_size vertices
+    std::string multicut_solver = "exact";
+    size_t multilevel_coarsest_size = 1000;
     bool runLocalSearch = true;
+    size_t local_search_threads = 1;
+    // connected components with at most this many vertices plus edges are
+    // solved concurrently, one thread each
+    size_t small_component_size = 10000;
+    // memory budget of the branch and bound in MiB (0 for unlimited). When it
+    // is exceeded, the open problems with the worst bounds are moved to a
+    // spill file in spill_directory ($TMPDIR or /tmp if empty). Without
+    // spilling, the search ends once the budget is exceeded.
+    size_t memory_budget = 32768;
+    bool disable_spilling = false;
+    std::string spill_directory = "";
+    // size of the table of seen branch and bound problems in MiB, duplicate
+    // problems are discarded (0 to disable)
+    size_t transposition_table_size = 0;
     size_t timeoutSeconds = 600;
+    // stop once the best solution is within this relative gap of the optimum
+    double gap = 0.0;
+    // file to which every improvement of the best solution is written
+    std::string incumbent_file = "";
     double ilpTime = 60.0;
     NodeID orign;
     EdgeID origm;
@@ -77,12 +99,40 @@ class configuration {
     bool find_lowest_conductance = false;
     bool blacklist = true;
     bool set_node_in_cut = false;
+    // viecut starts with the lightest bridge as upper bound if it is lighter
+    // than the minimum degree, see parallel_biconnectivity.h
+    bool bridge_cut = false;
+
+    // capforest of exact_parallel_minimum_cut: "partitioned" (every thread
+    // owns BFS regions, deterministic) or "shared" (shared visited array)
+    std::string parallel_capforest = "partitioned";
+
+    // NUMA-aware memory placement and thread pinning, see numa_tools.h
+    bool numa = false;
+
+    // triangle and neighborhood reductions intersect sorted copies of the
+    // adjacency lists (see sorted_adjacency.h) instead of marking arrays
+    bool sorted_adjacency = false;
+
+    // approximation guarantee of the approximate minimum cut algorithm
+    double approximation_epsilon = 0.1;
+
+    // label propagation: maximum number of rounds, fraction of vertices
+    // that need to change their label to start another round and maximum
+    // cluster size (0 for unlimited)
+    size_t lp_iterations = 10;
+    double lp_convergence = 0.01;
+    size_t lp_cluster_size = 0;
 
     // cactus graph output
     std::string cactus_filename = "";
 
     // dynamic minimum cut
     size_t depthOfPartialRelabeling = 1;
+    size_t cactus_cache_bytes = static_cast<size_t>(1) << 30;
+    size_t cactus_cache_inserts = 1000;
+    bool compact_cactus_cache = false;
+    bool cactus_snapshots = false;
 
     // karger-stein:
     size_t optimal = 0;
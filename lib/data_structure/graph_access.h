@@ -26,6 +26,7 @@
 
 #include "common/definitions.h"
 #include "tlx/logger.hpp"
+#include "tools/numa_tools.h"
 
 struct Node {
     EdgeID firstEdge;
@@ -91,14 +92,20 @@ class basicGraph {
         // resizes property arrays
         m_nodes.resize(n + 1);
         m_refinement_node_props.resize(n + 1);
-        m_edges.reserve(m);
+        // edges of the graph are read by all threads
+        numa_tools::interleavedReserve(&m_edges, m);
         // m_coarsening_edge_props.resize(m);
 
         m_nodes[node].firstEdge = e;
     }
 
-    void resize_m(EdgeID m) {
-        m_edges.resize(m, Edge(0));
+    void resize_m(EdgeID m, bool initialize) {
+        if (initialize) {
+            m_edges.resize(m, Edge(0));
+        } else {
+            // Edge() does not write, so the pages stay untouched
+            m_edges.resize(m);
+        }
     }
 
     NodeID new_node_hacky(EdgeID edge) {
@@ -363,8 +370,15 @@ class graph_access {
         return graphref->new_node_hacky(edge);
     }
 
-    void resize_m(EdgeID m) {
-        graphref->resize_m(m);
+    // with initialize = false, the edges are not written yet and
+    // first_touch_edges has to be called by all threads of the team
+    void resize_m(EdgeID m, bool initialize = true) {
+        graphref->resize_m(m, initialize);
+    }
+
+    void first_touch_edges() {
+        numa_tools::firstTouch(&graphref->m_edges, 0,
+                               graphref->m_edges.size(), Edge(0));
     }
 
     void finish_construction() {
@@ -447,8 +447,11 @@ class mutable_graph {
         EdgeWeight e_weight = getEdgeWeight(target, ed);
         EdgeID del_rev = getReverseEdge(target, ed);
         bool edge_found = false;
+        // a parallel edge between node and target becomes a self-loop,
+        // which is removed by removeSelfLoops after the contraction
         for (EdgeID src_edge : edges_of(node)) {
-            if (getEdgeTarget(node, src_edge) == e_target) {
+            if (e_target != node
+                && getEdgeTarget(node, src_edge) == e_target) {
                 EdgeID rev = getReverseEdge(node, src_edge);
                 vertices[node][src_edge].weight += e_weight;
                 vertices[e_target][rev].weight += e_weight;
@@ -481,6 +484,7 @@ class mutable_graph {
         for (EdgeID ed : edges_of(target)) {
             mergeEdgeSparse(node, target, ed);
         }
+        removeSelfLoops(node);
 
         for (NodeID n : contained_in_this[target]) {
             contained_in_this[node].emplace_back(n);
@@ -543,6 +547,7 @@ class mutable_graph {
         internalDeleteEdge(node, edge);
         num_edges -= 2;
         weighted_degree[node] -= e.weight;
+        removeSelfLoops(node);
 
         vertices[target] = std::move(vertices.back());
         weighted_degree[target] = std::move(weighted_degree.back());
@@ -599,8 +604,12 @@ class mutable_graph {
                 NodeID e_target = getEdgeTarget(target, ed);
                 // neighbour of 'target' also in neighbourhood of 'node'
                 if (map.count(e_target) > 0) {
-                    // sum up edge weights
-                    auto [tgt, rev, ed2] = map[e_target];
+                    // sum up edge weights. the reverse edge is read from the
+                    // edge itself, as it moves if a parallel edge of
+                    // 'target' to the same vertex was deleted before
+                    EdgeID ed2 = std::get<2>(map[e_target]);
+                    NodeID tgt = vertices[node][ed2].target;
+                    EdgeID rev = vertices[node][ed2].reverse_edge;
                     vertices[node][ed2].weight += del_edge.weight;
                     vertices[tgt][rev].weight += del_edge.weight;
 
@@ -653,6 +662,7 @@ class mutable_graph {
         internalDeleteEdge(node, del_id);
         num_edges -= 2;
         weighted_degree[node] -= del_wgt;
+        removeSelfLoops(node);
 
         return target;
     }
@@ -839,27 +849,26 @@ class mutable_graph {
         return G;
     }
 
-    static mutableGraphPtr deserialize(std::vector<uint64_t> v) {
+    static mutableGraphPtr deserialize(const std::vector<uint64_t>& v) {
+        return deserialize(v.data());
+    }
+
+    // reads a graph in the format of serialize() from memory, e.g. from a
+    // memory-mapped file
+    static mutableGraphPtr deserialize(const uint64_t* v) {
         mutableGraphPtr G = std::make_shared<mutable_graph>();
         uint64_t num_nodes = v[0];
-        size_t num_edges = v[1];
         uint64_t original_nodes = v[3];
         G->start_construction(num_nodes);
         G->set_partition_count(v[2]);
         G->setOriginalNodes(original_nodes);
-        size_t n = 0;
         size_t deserial = 4;
-        while (n < num_nodes) {
-            uint64_t next = v[deserial++];
-            if (next >= num_edges) {
-                if (next == UNDEFINED_EDGE) {
-                    break;
-                }
-                n = next - num_edges;
-                continue;
+        for (size_t n = 0; n < num_nodes; ++n) {
+            uint64_t degree = v[deserial++];
+            for (uint64_t i = 0; i < degree; ++i) {
+                G->new_edge(n, v[deserial], v[deserial + 1]);
+                deserial += 2;
             }
-            uint64_t wgt = v[deserial++];
-            G->new_edge(n, next, wgt);
         }
 
         for (size_t i = 0; i < num_nodes; ++i) {
@@ -878,8 +887,12 @@ class mutable_graph {
         return G;
     }
 
+    // header of n, m, partition count and number of original vertices,
+    // followed by the number of edges to higher vertex ids and the (target,
+    // weight) pairs of these edges for every vertex, the partition indices
+    // and the current positions of the original vertices
     std::vector<uint64_t> serialize() {
-        std::vector<uint64_t> serial(5 + 2 * n() + m() + original_nodes);
+        std::vector<uint64_t> serial(4 + 2 * n() + m() + original_nodes);
         serial[0] = static_cast<uint64_t>(vertices.size());
         serial[1] = static_cast<uint64_t>(num_edges);
         serial[2] = static_cast<uint64_t>(partition_count);
@@ -887,7 +900,7 @@ class mutable_graph {
         size_t next = 4;
 
         for (NodeID n : nodes()) {
-            serial[next++] = static_cast<uint64_t>(num_edges + n);
+            size_t degree_pos = next++;
             for (const auto& [t, w, r, f, l] : vertices[n]) {
                 // I am deeply sorry for this ugly code, but structured bindings
                 // seem to not work in combination with maybe_unused to suppress
@@ -900,10 +913,9 @@ class mutable_graph {
                     serial[next++] = static_cast<uint64_t>(w);
                 }
             }
+            serial[degree_pos] = (next - degree_pos - 1) / 2;
         }
 
-        serial[next++] = UNDEFINED_EDGE;
-
         for (const auto& p : partition_index) {
             serial[next++] = static_cast<uint64_t>(p);
         }
@@ -915,6 +927,22 @@ class mutable_graph {
         return serial;
     }
 
+    // approximate number of bytes allocated by this graph
+    size_t memoryUsage() const {
+        size_t bytes = sizeof(mutable_graph);
+        bytes += partition_index.capacity() * sizeof(PartitionID);
+        bytes += weighted_degree.capacity() * sizeof(EdgeWeight);
+        bytes += node_in_cut.capacity() / 8;
+        bytes += current_position.capacity() * sizeof(NodeID);
+        for (const auto& v : vertices) {
+            bytes += sizeof(v) + v.capacity() * sizeof(RevEdge);
+        }
+        for (const auto& c : contained_in_this) {
+            bytes += sizeof(c) + c.capacity() * sizeof(NodeID);
+        }
+        return bytes;
+    }
+
     mutableGraphPtr simplify() {
         mutableGraphPtr G = std::make_shared<mutable_graph>();
         G->start_construction(number_of_nodes());
@@ -938,6 +966,33 @@ class mutable_graph {
     }
 
  private:
+    // contracting one of multiple parallel edges turns the others into
+    // self-loops, both directions of which are in the edge list of n
+    void removeSelfLoops(NodeID n) {
+        bool has_loop = false;
+        for (EdgeID e : edges_of(n)) {
+            if (vertices[n][e].target == n) {
+                has_loop = true;
+                break;
+            }
+        }
+        if (!has_loop)
+            return;
+
+        std::vector<RevEdge> kept;
+        for (EdgeID e : edges_of(n)) {
+            if (vertices[n][e].target == n) {
+                weighted_degree[n] -= vertices[n][e].weight;
+                num_edges--;
+            } else {
+                kept.emplace_back(vertices[n][e]);
+                vertices[kept.back().target][kept.back().reverse_edge]
+                .reverse_edge = kept.size() - 1;
+            }
+        }
+        vertices[n].swap(kept);
+    }
+
     void internalDeleteEdge(NodeID n, EdgeID e) {
         if (vertices[n].size() > e + 1) {
             vertices[n][e] = std::move(vertices[n][vertices[n].size() - 1]);
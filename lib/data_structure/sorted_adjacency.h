@@ -0,0 +1,109 @@
+/******************************************************************************
+ * sorted_adjacency.h
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "common/configuration.h"
+#include "common/definitions.h"
+#include "tools/simd_intersection.h"
+
+// Snapshot of the adjacency lists of a graph_access or mutable_graph, sorted
+// by target. Targets and weights are stored in separate arrays, so that the
+// targets of a vertex can be intersected with simd_intersection. The edge ids
+// of the graph are not changed, thus the snapshot is only valid until the
+// graph is modified. Used by the triangle based reductions, when enabled
+// with configuration::sorted_adjacency.
+class sorted_adjacency {
+ public:
+    struct common_neighbor {
+        NodeID     vertex;
+        EdgeWeight weight_u;
+        EdgeWeight weight_v;
+    };
+
+    static bool enabled() {
+        return configuration::getConfig()->sorted_adjacency;
+    }
+
+    // if parallel, the adjacency lists are sorted by all OpenMP threads
+    template <class GraphPtr>
+    explicit sorted_adjacency(GraphPtr G, bool parallel = false)
+        : first_edge(G->n() + 1, 0) {
+        for (NodeID n = 0; n < G->n(); ++n) {
+            first_edge[n + 1] = first_edge[n] + G->get_first_invalid_edge(n)
+                                - G->get_first_edge(n);
+        }
+        targets.resize(first_edge.back());
+        weights.resize(first_edge.back());
+
+#pragma omp parallel if (parallel)
+        {
+            std::vector<std::pair<NodeID, EdgeWeight> > edges;
+#pragma omp for schedule(dynamic, 1024)
+            for (NodeID n = 0; n < G->n(); ++n) {
+                edges.clear();
+                for (EdgeID e : G->edges_of(n)) {
+                    edges.emplace_back(G->getEdgeTarget(n, e),
+                                       G->getEdgeWeight(n, e));
+                }
+                std::sort(edges.begin(), edges.end());
+                for (size_t i = 0; i < edges.size(); ++i) {
+                    targets[first_edge[n] + i] = edges[i].first;
+                    weights[first_edge[n] + i] = edges[i].second;
+                }
+            }
+        }
+    }
+
+    size_t degree(NodeID n) const {
+        return first_edge[n + 1] - first_edge[n];
+    }
+
+    // the degree(n) targets of n in increasing order
+    const NodeID* neighbors(NodeID n) const {
+        return targets.data() + first_edge[n];
+    }
+
+    const EdgeWeight* neighborWeights(NodeID n) const {
+        return weights.data() + first_edge[n];
+    }
+
+    // calls on_match(vertex, weight of {u, vertex}, weight of {v, vertex})
+    // for every common neighbor of u and v in increasing order
+    template <class F>
+    void intersect(NodeID u, NodeID v, F on_match) const {
+        const EdgeWeight* weights_u = neighborWeights(u);
+        const EdgeWeight* weights_v = neighborWeights(v);
+        const NodeID* targets_u = neighbors(u);
+        simd_intersection::intersect(
+            targets_u, degree(u), neighbors(v), degree(v),
+            [&](size_t i, size_t j) {
+                on_match(targets_u[i], weights_u[i], weights_v[j]);
+            });
+    }
+
+    std::vector<common_neighbor> commonNeighbors(NodeID u, NodeID v) const {
+        std::vector<common_neighbor> common;
+        intersect(u, v, [&common](NodeID w, EdgeWeight wu, EdgeWeight wv) {
+                      common.push_back({ w, wu, wv });
+                  });
+        return common;
+    }
+
+ private:
+    std::vector<EdgeID> first_edge;
+    std::vector<NodeID> targets;
+    std::vector<EdgeWeight> weights;
+};
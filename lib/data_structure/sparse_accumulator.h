@@ -0,0 +1,92 @@
+/******************************************************************************
+ * sparse_accumulator.h
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "common/definitions.h"
+
+// Open addressing table that sums up edge weights per key, e.g. the
+// connection strength of a vertex to the clusters of its neighbors.
+// The table is sized by the number of distinct keys of the current vertex
+// (i.e. its degree) instead of the number of vertices in the graph, and
+// reset() only clears the slots that were used since the last reset.
+class sparse_accumulator {
+ public:
+    sparse_accumulator() : mask(0), shift(64) { }
+
+    // prepares the table for at most max_keys distinct keys
+    void reset(size_t max_keys) {
+        for (size_t slot : used) {
+            table[slot].first = UNDEFINED_NODE;
+        }
+        used.clear();
+
+        size_t bits = 4;
+        while ((static_cast<size_t>(1) << bits) < 2 * max_keys) {
+            ++bits;
+        }
+        size_t capacity = static_cast<size_t>(1) << bits;
+        if (table.size() < capacity) {
+            table.resize(capacity, std::make_pair(UNDEFINED_NODE, 0));
+        }
+        mask = capacity - 1;
+        shift = 64 - bits;
+    }
+
+    // adds weight to key and returns the new sum of key
+    EdgeWeight add(NodeID key, EdgeWeight weight) {
+        size_t slot = find(key);
+        if (table[slot].first != key) {
+            table[slot] = std::make_pair(key, 0);
+            used.emplace_back(slot);
+        }
+        table[slot].second += weight;
+        return table[slot].second;
+    }
+
+    EdgeWeight get(NodeID key) const {
+        size_t slot = find(key);
+        return table[slot].first == key ? table[slot].second : 0;
+    }
+
+    // calls f(key, sum) for every key added since the last reset, in the
+    // order in which the keys were first added
+    template <class F>
+    void forEach(F f) const {
+        for (size_t slot : used) {
+            f(table[slot].first, table[slot].second);
+        }
+    }
+
+    // number of distinct keys added since the last reset
+    size_t size() const {
+        return used.size();
+    }
+
+ private:
+    size_t find(NodeID key) const {
+        size_t slot = (key * UINT64_C(0x9E3779B97F4A7C15)) >> shift;
+        while (table[slot].first != key
+               && table[slot].first != UNDEFINED_NODE) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    std::vector<std::pair<NodeID, EdgeWeight> > table;
+    std::vector<size_t> used;
+    size_t mask;
+    size_t shift;
+};
@@ -0,0 +1,405 @@
+/******************************************************************************
+ * temporal_edge_stream.h
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#pragma once
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "common/definitions.h"
+#include "tlx/logger.hpp"
+
+// Reads a list of edge updates in the format of graph_io::readTemporalGraph
+// from a memory-mapped file and returns them in order of their timestamps,
+// either one by one or in batches of equal timestamp. Updates with equal
+// timestamp keep their order in the file.
+//
+// The constructor scans the file once to find the number of vertices and to
+// check whether the timestamps are already sorted. In that case, updates are
+// parsed directly from the mapped file. Otherwise, the file is split into
+// runs of run_size updates, which are sorted and written to temporary files
+// in tmp_dir. The runs are merged while the stream is read. Thus, memory
+// usage is independent of the length of the stream.
+class temporal_edge_stream {
+ public:
+    static constexpr bool debug = false;
+
+    typedef std::tuple<NodeID, NodeID, int64_t, uint64_t> update;
+
+    explicit temporal_edge_stream(const std::string& file,
+                                  size_t run_size = (1 << 22),
+                                  const std::string& tmp_dir = "")
+        : file(file),
+          run_size(std::max(run_size, static_cast<size_t>(1))),
+          tmp_dir(tmp_dir),
+          num_vertices(0),
+          num_updates(0),
+          is_sorted(true),
+          dimacs(false),
+          dimacs_counter(1),
+          has_peeked(false) {
+        int fd = open(file.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0) {
+            LOG1 << "Error opening " << file;
+            exit(1);
+        }
+        length = st.st_size;
+        begin = nullptr;
+        if (length > 0) {
+            void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                LOG1 << "Error: could not map " << file;
+                exit(1);
+            }
+            madvise(mapped, length, MADV_SEQUENTIAL);
+            begin = static_cast<const char*>(mapped);
+        }
+        close(fd);
+
+        scan();
+        if (!is_sorted) {
+            createRuns();
+        }
+        rewind();
+    }
+
+    ~temporal_edge_stream() {
+        for (run& r : runs) {
+            fclose(r.f);
+        }
+        if (begin != nullptr) {
+            munmap(const_cast<char*>(begin), length);
+        }
+    }
+
+    temporal_edge_stream(const temporal_edge_stream&) = delete;
+    temporal_edge_stream& operator = (const temporal_edge_stream&) = delete;
+
+    NodeID numVertices() const {
+        return num_vertices;
+    }
+
+    size_t numUpdates() const {
+        return num_updates;
+    }
+
+    // whether the timestamps in the file were already sorted
+    bool sorted() const {
+        return is_sorted;
+    }
+
+    // returns false if all updates were read
+    bool next(update* u) {
+        if (has_peeked) {
+            has_peeked = false;
+            *u = peeked;
+            return true;
+        }
+        return is_sorted ? parseNext(&pos, u) : mergeNext(u);
+    }
+
+    // replaces the content of batch with the next updates of equal
+    // timestamp. returns false if all updates were read
+    bool nextBatch(std::vector<update>* batch) {
+        batch->clear();
+        update u;
+        if (!next(&u))
+            return false;
+
+        batch->emplace_back(u);
+        while (next(&u)) {
+            if (std::get<3>(u) != std::get<3>(batch->front())) {
+                peeked = u;
+                has_peeked = true;
+                break;
+            }
+            batch->emplace_back(u);
+        }
+        return true;
+    }
+
+    // restarts the stream at the update with the smallest timestamp
+    void rewind() {
+        pos = begin;
+        dimacs_counter = 1;
+        has_peeked = false;
+        if (!is_sorted) {
+            heap = decltype(heap)();
+            for (size_t i = 0; i < runs.size(); ++i) {
+                fseek(runs[i].f, 0, SEEK_SET);
+                runs[i].remaining = runs[i].size;
+                runs[i].buffer.clear();
+                runs[i].buffer_pos = 0;
+                pushHead(i);
+            }
+        }
+    }
+
+ private:
+    // fixed-size record of an update in a sorted run
+    struct record {
+        NodeID source;
+        NodeID target;
+        int64_t weight;
+        uint64_t timestamp;
+    };
+
+    struct run {
+        FILE* f;
+        size_t size;
+        size_t remaining;
+        std::vector<record> buffer;
+        size_t buffer_pos;
+    };
+
+    static constexpr size_t merge_buffer = 4096;
+
+    // returns the current line and moves p to the start of the next line
+    std::pair<const char*, const char*> nextLine(const char** p) {
+        const char* end = begin + length;
+        const char* line = *p;
+        const char* eol = static_cast<const char*>(
+            memchr(line, '\n', end - line));
+        if (eol == nullptr)
+            eol = end;
+        *p = (eol == end) ? end : eol + 1;
+        return std::make_pair(line, eol);
+    }
+
+    // same parsing as graph_io::fast_atoi
+    static uint64_t fast_atoi(const char** p, const char* end) {
+        uint64_t x = 0;
+        while (*p < end && **p >= '0' && **p <= '9') {
+            x = (x * 10) + (**p - '0');
+            ++(*p);
+        }
+        ++(*p);
+        return x;
+    }
+
+    // parses the next update starting at *p, skipping comments
+    bool parseNext(const char** p, update* u) {
+        const char* end = begin + length;
+        while (*p < end) {
+            auto [line, eol] = nextLine(p);
+            if (line == eol || *line == '%')
+                continue;
+
+            if (dimacs) {
+                if (*line != 'e')
+                    continue;
+                const char* ptr = line + 2;
+                NodeID source = fast_atoi(&ptr, eol) - 1;
+                NodeID target = fast_atoi(&ptr, eol) - 1;
+                if (target > source) {
+                    *u = std::make_tuple(source, target, 1, dimacs_counter++);
+                    return true;
+                }
+                continue;
+            }
+
+            const char* ptr = line;
+            // remove leading whitespaces
+            while (ptr < eol && *ptr == ' ')
+                ++ptr;
+
+            NodeID source = fast_atoi(&ptr, eol) - 1;
+            NodeID target = fast_atoi(&ptr, eol) - 1;
+            int64_t wgt;
+            uint64_t timestamp;
+
+            // remove additional whitespaces inbetween
+            while (ptr < eol && (*ptr == ' ' || *ptr == '\t'))
+                ++ptr;
+
+            if (ptr < eol && (*ptr == '+' || *ptr == '-')) {
+                bool isNegative = *ptr == '-';
+                ++ptr;
+                wgt = fast_atoi(&ptr, eol);
+                if (isNegative) {
+                    wgt = (-1) * wgt;
+                }
+                timestamp = fast_atoi(&ptr, eol);
+            } else {
+                wgt = 1;
+                timestamp = fast_atoi(&ptr, eol);
+                if (ptr < eol) {
+                    wgt = timestamp;
+                    timestamp = fast_atoi(&ptr, eol);
+                }
+            }
+            *u = std::make_tuple(source, target, wgt, timestamp);
+            return true;
+        }
+        return false;
+    }
+
+    // finds number of vertices and checks whether timestamps are sorted
+    void scan() {
+        const char* p = begin;
+        const char* end = begin + length;
+        // a DIMACS header before the first edge switches to DIMACS format
+        while (p < end) {
+            const char* line = p;
+            auto [l, eol] = nextLine(&p);
+            if (l == eol || *l == '%')
+                continue;
+            if (*l == 'p') {
+                dimacs = true;
+                const char* ptr = l + 2;
+                num_vertices = fast_atoi(&ptr, eol);
+            }
+            p = line;
+            break;
+        }
+
+        if (dimacs) {
+            // timestamps are given by the order in the file
+            update u;
+            while (parseNext(&p, &u)) {
+                num_updates++;
+            }
+            return;
+        }
+
+        update u;
+        uint64_t previous = 0;
+        while (parseNext(&p, &u)) {
+            auto [source, target, wgt, timestamp] = u;
+            num_vertices = std::max(num_vertices,
+                                    std::max(source, target) + 1);
+            if (timestamp < previous) {
+                is_sorted = false;
+            }
+            previous = timestamp;
+            num_updates++;
+        }
+        LOG << "scanned " << file << ": " << num_updates << " updates, "
+            << num_vertices << " vertices, sorted: " << is_sorted;
+    }
+
+    // external merge sort, phase one: sorted runs of at most run_size updates
+    void createRuns() {
+        std::vector<record> records;
+        records.reserve(std::min(run_size, num_updates));
+        const char* p = begin;
+        update u;
+        bool more = true;
+        while (more) {
+            more = parseNext(&p, &u);
+            if (more) {
+                auto [source, target, wgt, timestamp] = u;
+                records.push_back({ source, target, wgt, timestamp });
+            }
+
+            if (records.size() == run_size || (!more && !records.empty())) {
+                std::stable_sort(records.begin(), records.end(),
+                                 [](const record& r1, const record& r2) {
+                                     return r1.timestamp < r2.timestamp;
+                                 });
+                FILE* f = createTemporaryFile();
+                if (fwrite(records.data(), sizeof(record), records.size(), f)
+                    != records.size()) {
+                    LOG1 << "Error: could not write sorted run";
+                    exit(1);
+                }
+                runs.push_back({ f, records.size(), 0, { }, 0 });
+                records.clear();
+            }
+        }
+        LOG << "sorted " << num_updates << " updates in " << runs.size()
+            << " runs";
+    }
+
+    FILE* createTemporaryFile() {
+        std::string dir = tmp_dir;
+        if (dir == "") {
+            const char* env = getenv("TMPDIR");
+            dir = (env != nullptr) ? env : "/tmp";
+        }
+        std::string path = dir + "/viecut_run_XXXXXX";
+        int fd = mkstemp(&path[0]);
+        FILE* f = (fd < 0) ? nullptr : fdopen(fd, "w+b");
+        if (f == nullptr) {
+            LOG1 << "Error: could not create temporary file in " << dir;
+            exit(1);
+        }
+        // file is deleted as soon as it is closed
+        unlink(path.c_str());
+        return f;
+    }
+
+    // moves the next update of run i to the merge heap
+    void pushHead(size_t i) {
+        run& r = runs[i];
+        if (r.buffer_pos == r.buffer.size()) {
+            if (r.remaining == 0)
+                return;
+            r.buffer.resize(std::min(merge_buffer, r.remaining));
+            if (fread(r.buffer.data(), sizeof(record), r.buffer.size(), r.f)
+                != r.buffer.size()) {
+                LOG1 << "Error: could not read sorted run";
+                exit(1);
+            }
+            r.remaining -= r.buffer.size();
+            r.buffer_pos = 0;
+        }
+        heap.emplace(r.buffer[r.buffer_pos].timestamp, i);
+    }
+
+    // external merge sort, phase two: merge runs, ties by run index
+    bool mergeNext(update* u) {
+        if (heap.empty())
+            return false;
+        size_t i = heap.top().second;
+        heap.pop();
+        run& r = runs[i];
+        const record& rec = r.buffer[r.buffer_pos++];
+        *u = std::make_tuple(rec.source, rec.target, rec.weight, rec.timestamp);
+        pushHead(i);
+        return true;
+    }
+
+    std::string file;
+    size_t run_size;
+    std::string tmp_dir;
+    const char* begin;
+    size_t length;
+
+    NodeID num_vertices;
+    size_t num_updates;
+    bool is_sorted;
+    bool dimacs;
+
+    const char* pos;
+    uint64_t dimacs_counter;
+    std::vector<run> runs;
+    std::priority_queue<std::pair<uint64_t, size_t>,
+                        std::vector<std::pair<uint64_t, size_t> >,
+                        std::greater<std::pair<uint64_t, size_t> > > heap;
+
+    update peeked;
+    bool has_peeked;
+};
@@ -29,6 +29,7 @@
 #include "data_structure/priority_queues/fifo_node_bucket_pq.h"
 #include "data_structure/priority_queues/maxNodeHeap.h"
 #include "data_structure/priority_queues/node_bucket_pq.h"
+#include "tools/numa_tools.h"
 #include "tools/random_functions.h"
 #include "tools/timer.h"
 
@@ -54,6 +55,12 @@ class exact_parallel_minimum_cut : public minimum_cut {
     ~exact_parallel_minimum_cut() { }
 
     static constexpr bool debug = false;
+    // partitioned capforest: regions per thread, rounds of label
+    // propagation on the BFS regions and maximum size of a region relative
+    // to the average region size
+    static constexpr size_t regions_per_thread = 1;
+    static constexpr size_t region_refinement_rounds = 3;
+    static constexpr double region_imbalance = 1.2;
     bool timing = configuration::getConfig()->verbose;
 
     EdgeWeight perform_minimum_cut(GraphPtr G) {
@@ -62,6 +69,20 @@ class exact_parallel_minimum_cut : public minimum_cut {
 
     EdgeWeight perform_minimum_cut(GraphPtr G,
                                    bool indirect) {
+        return perform_minimum_cut(G, indirect, UNDEFINED_EDGE);
+    }
+
+    EdgeWeight perform_minimum_cut_threshold(GraphPtr G, EdgeWeight k) {
+        if (!G) {
+            return -1;
+        }
+        return std::min(perform_minimum_cut(G, false, k), k);
+    }
+
+    // stops as soon as a cut smaller than threshold is found, see
+    // noi_minimum_cut. threshold UNDEFINED_EDGE computes the minimum cut
+    EdgeWeight perform_minimum_cut(GraphPtr G, bool indirect,
+                                   EdgeWeight threshold) {
         if (!G) {
             return -1;
         }
@@ -69,9 +90,10 @@ class exact_parallel_minimum_cut : public minimum_cut {
         std::vector<GraphPtr> graphs;
         timer t;
         EdgeWeight mincut = G->getMinDegree();
+        bool exact = (threshold == UNDEFINED_EDGE);
 #ifdef PARALLEL
         viecut<GraphPtr> heuristic_mc;
-        mincut = heuristic_mc.perform_minimum_cut(G, true);
+        mincut = heuristic_mc.perform_minimum_cut(G, true, threshold);
         LOGC(timing) << "VieCut found cut " << mincut
                      << " [Time: " << t.elapsed() << "s]";
 #endif
@@ -84,16 +106,21 @@ class exact_parallel_minimum_cut : public minimum_cut {
         minimum_cut_helpers<GraphPtr>::setInitialCutValues(graphs);
 #endif
 
-        while (graphs.back()->number_of_nodes() > 2 && mincut > 0) {
+        while (graphs.back()->number_of_nodes() > 2 && mincut > 0
+               && (exact || mincut >= threshold)) {
             GraphPtr curr_g = graphs.back();
+            EdgeWeight limit = std::min(mincut, threshold);
             timer ts;
 #ifdef PARALLEL
 
             noi_minimum_cut<GraphPtr> noi;
 
-            auto uf = parallel_modified_capforest(curr_g, mincut);
+            auto uf = (configuration::getConfig()->parallel_capforest
+                       == "shared")
+                      ? parallel_modified_capforest(curr_g, limit)
+                      : partitioned_capforest(curr_g, limit);
             if (uf.n() == curr_g->number_of_nodes()) {
-                uf = noi.modified_capforest(curr_g, mincut);
+                uf = noi.modified_capforest(curr_g, limit);
                 LOGC(timing) << "seq capforest needed";
             }
 
@@ -102,7 +129,7 @@ class exact_parallel_minimum_cut : public minimum_cut {
                  << " Using normal noi_minimum_cut instead!";
 
             noi_minimum_cut noi;
-            auto uf = noi.modified_capforest(curr_g, mincut);
+            auto uf = noi.modified_capforest(curr_g, limit);
 #endif
 
             if (uf.n() > 1) {
@@ -165,6 +192,241 @@ class exact_parallel_minimum_cut : public minimum_cut {
         return start_nodes;
     }
 
+    // priority of region r for vertex v, ties between regions are broken by
+    // a hash instead of the region id, which would favor small region ids
+    static uint64_t regionPriority(NodeID v, NodeID r) {
+        uint64_t z = ((static_cast<uint64_t>(v) << 32) | r)
+                     * 0x9e3779b97f4a7c15;
+        z = (z ^ (z >> 29)) * 0xbf58476d1ce4e5b9;
+        return ((z ^ (z >> 32)) << 32) | r;
+    }
+
+    // assigns every vertex to one of num_regions regions. The regions are
+    // grown by a level-synchronous BFS from random seed vertices, a vertex
+    // that is reached in a level joins the reaching region of smallest
+    // regionPriority. Thus, the result only depends on the seed vertices and
+    // not on the schedule of the threads. Vertices that are not reachable
+    // from any seed are distributed round robin. Afterwards, the regions are
+    // refined by refineRegions.
+    std::vector<NodeID> bfsRegions(GraphPtr G, NodeID num_regions) {
+        NodeID n = G->number_of_nodes();
+        std::vector<uint64_t> claim(n, UNDEFINED_EDGE);
+        std::vector<NodeID> level(n, UNDEFINED_NODE);
+        std::vector<NodeID> frontier;
+
+        for (NodeID r = 0; r < num_regions; ++r) {
+            NodeID seed = random_functions::next() % n;
+            if (level[seed] == UNDEFINED_NODE) {
+                claim[seed] = r;
+                level[seed] = 0;
+                frontier.push_back(seed);
+            }
+        }
+
+        for (NodeID l = 1; !frontier.empty(); ++l) {
+            std::vector<NodeID> next;
+#pragma omp parallel
+            {
+                std::vector<NodeID> reached;
+#pragma omp for schedule(dynamic, 256)
+                for (size_t i = 0; i < frontier.size(); ++i) {
+                    NodeID v = frontier[i];
+                    NodeID r = static_cast<NodeID>(claim[v]);
+                    for (EdgeID e : G->edges_of(v)) {
+                        NodeID tgt = G->getEdgeTarget(v, e);
+                        if (level[tgt] == UNDEFINED_NODE
+                            && __sync_bool_compare_and_swap(
+                                &level[tgt], UNDEFINED_NODE, l)) {
+                            reached.push_back(tgt);
+                        }
+
+                        if (level[tgt] == l) {
+                            uint64_t prio = regionPriority(tgt, r);
+                            uint64_t old = claim[tgt];
+                            while (prio < old
+                                   && !__sync_bool_compare_and_swap(
+                                       &claim[tgt], old, prio)) {
+                                old = claim[tgt];
+                            }
+                        }
+                    }
+                }
+#pragma omp critical
+                next.insert(next.end(), reached.begin(), reached.end());
+            }
+            frontier.swap(next);
+        }
+
+        std::vector<NodeID> region(n);
+#pragma omp parallel for schedule(static)
+        for (NodeID v = 0; v < n; ++v) {
+            region[v] = (level[v] == UNDEFINED_NODE)
+                        ? v % num_regions : static_cast<NodeID>(claim[v]);
+        }
+
+        refineRegions(G, &region, num_regions);
+        return region;
+    }
+
+    // BFS regions of small-world graphs consist of many small pieces, as
+    // a few levels already reach most of the graph. A few synchronous rounds
+    // of label propagation move every vertex to the region it is most
+    // strongly connected to, as long as that region is not larger than
+    // region_imbalance times the average region size. All decisions of a
+    // round only depend on the result of the previous round.
+    void refineRegions(GraphPtr G, std::vector<NodeID>* region,
+                       NodeID num_regions) {
+        NodeID n = G->number_of_nodes();
+        const size_t max_size = region_imbalance * n / num_regions + 1;
+        std::vector<NodeID> refined(n);
+
+        for (size_t round = 0; round < region_refinement_rounds; ++round) {
+            std::vector<size_t> size(num_regions, 0);
+            for (NodeID v = 0; v < n; ++v) {
+                size[(*region)[v]]++;
+            }
+
+#pragma omp parallel
+            {
+                std::vector<EdgeWeight> conn(num_regions, 0);
+                std::vector<NodeID> adjacent;
+#pragma omp for schedule(dynamic, 1024)
+                for (NodeID v = 0; v < n; ++v) {
+                    for (EdgeID e : G->edges_of(v)) {
+                        auto [tgt, wgt] = G->getEdge(v, e);
+                        NodeID r = (*region)[tgt];
+                        if (conn[r] == 0)
+                            adjacent.push_back(r);
+                        conn[r] += wgt;
+                    }
+
+                    NodeID best = (*region)[v];
+                    for (NodeID r : adjacent) {
+                        if (size[r] < max_size
+                            && (conn[r] > conn[best]
+                                || (conn[r] == conn[best]
+                                    && regionPriority(v, r)
+                                    < regionPriority(v, best)))) {
+                            best = r;
+                        }
+                    }
+
+                    for (NodeID r : adjacent) {
+                        conn[r] = 0;
+                    }
+                    adjacent.clear();
+                    refined[v] = best;
+                }
+            }
+            region->swap(refined);
+        }
+    }
+
+    // capforest where every region of bfsRegions is owned by one thread,
+    // which replaces the shared visited array of parallel_modified_capforest.
+    // The owner scans its region in modified capforest order. Vertices of
+    // other regions are inserted into the priority queue and may be
+    // contracted with the scanned vertex like in the shared variant, but
+    // when they are dequeued they are blacklisted instead of scanned. This
+    // is exactly what parallel_modified_capforest does for vertices visited
+    // by another thread, but does not depend on the timing of other threads.
+    // Thus the contracted edges only depend on the seed and the number of
+    // regions (regions_per_thread times number of threads).
+    union_find partitioned_capforest(GraphPtr G, const EdgeWeight mincut) {
+        NodeID n = G->number_of_nodes();
+        union_find uf(n);
+        timer t;
+
+        NodeID num_regions = std::min(
+            static_cast<NodeID>(regions_per_thread * omp_get_max_threads()),
+            n);
+        std::vector<NodeID> region = bfsRegions(G, num_regions);
+
+        // vertices of every region in increasing order
+        std::vector<NodeID> region_begin(num_regions + 1, 0);
+        std::vector<NodeID> region_vertices(n);
+        for (NodeID v = 0; v < n; ++v) {
+            region_begin[region[v] + 1]++;
+        }
+        for (NodeID r = 0; r < num_regions; ++r) {
+            region_begin[r + 1] += region_begin[r];
+        }
+        std::vector<NodeID> pos(region_begin.begin(), region_begin.end() - 1);
+        for (NodeID v = 0; v < n; ++v) {
+            region_vertices[pos[region[v]]++] = v;
+        }
+        LOGC(timing) << "BFS regions: " << num_regions << " in "
+                     << t.elapsedToZero() << "s";
+
+#pragma omp parallel
+        {
+            fifo_node_bucket_pq pq(n, mincut + 1);
+            std::vector<EdgeWeight> r_v(n, 0);
+            std::vector<bool> visited(n, false);
+            std::vector<NodeID> touched;
+            std::vector<NodeID> updated;
+
+#pragma omp for schedule(dynamic, 1)
+            for (NodeID r = 0; r < num_regions; ++r) {
+                for (NodeID i = region_begin[r]; i < region_begin[r + 1];
+                     ++i) {
+                    NodeID start = region_vertices[i];
+                    if (visited[start])
+                        continue;
+
+                    pq.insert(start, 0);
+                    while (!pq.empty()) {
+                        NodeID current_node = pq.deleteMax();
+                        visited[current_node] = true;
+                        touched.push_back(current_node);
+                        // vertices of other regions are blacklisted
+                        if (region[current_node] != r)
+                            continue;
+
+                        for (EdgeID e : G->edges_of(current_node)) {
+                            auto [tgt, wgt] = G->getEdge(current_node, e);
+                            if (visited[tgt] || r_v[tgt] >= mincut)
+                                continue;
+
+                            if ((r_v[tgt] + wgt) >= mincut) {
+                                uf.Union(current_node, tgt);
+                            }
+
+                            r_v[tgt] = std::min(r_v[tgt] + wgt, mincut);
+                            updated.push_back(tgt);
+                        }
+
+                        // the order of edges in a contracted graph depends on
+                        // the timing of the contraction threads. Updating the
+                        // queue in vertex order keeps the ties in the buckets
+                        // independent of it
+                        std::sort(updated.begin(), updated.end());
+                        for (NodeID tgt : updated) {
+                            if (pq.contains(tgt)) {
+                                pq.increaseKey(tgt, r_v[tgt]);
+                            } else {
+                                pq.insert(tgt, r_v[tgt]);
+                            }
+                        }
+                        updated.clear();
+                    }
+                }
+
+                for (NodeID v : touched) {
+                    r_v[v] = 0;
+                    visited[v] = false;
+                }
+                touched.clear();
+            }
+        }
+        LOGC(timing) << "partitioned capforest: " << n << " -> " << uf.n()
+                     << " in " << t.elapsed() << "s";
+        return uf;
+    }
+
+    // capforest with one scan per thread from random start vertices, which
+    // coordinate through a shared visited array. Used by parallel_cactus,
+    // which disables the blacklist
     union_find parallel_modified_capforest(
         GraphPtr G,
         const EdgeWeight mincut,
@@ -176,8 +438,10 @@ class exact_parallel_minimum_cut : public minimum_cut {
         std::vector<NodeID> start_nodes = randomStartNodes(G);
 
         // std::vector<bool> would be bad for thread-safety
-        std::vector<uint8_t> visited(G->number_of_nodes(), false);
-        std::vector<size_t> times(G->number_of_nodes(), 0);
+        std::vector<uint8_t> visited =
+            numa_tools::interleavedVector<uint8_t>(G->number_of_nodes(), false);
+        std::vector<size_t> times =
+            numa_tools::interleavedVector<size_t>(G->number_of_nodes(), 0);
 
 #pragma omp parallel for
         for (int i = 0; i < omp_get_num_threads(); ++i) {
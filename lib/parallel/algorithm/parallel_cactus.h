@@ -34,8 +34,8 @@
 #include "data_structure/priority_queues/maxNodeHeap.h"
 #include "data_structure/priority_queues/node_bucket_pq.h"
 #include "io/graph_io.h"
+#include "tools/instrumentation.h"
 #include "tools/random_functions.h"
-#include "tools/timer.h"
 
 #ifdef PARALLEL
 #include "parallel/algorithm/exact_parallel_minimum_cut.h"
@@ -58,7 +58,6 @@ class parallel_cactus : public minimum_cut {
     ~parallel_cactus() { }
 
     static constexpr bool debug = false;
-    bool timing = configuration::getConfig()->verbose;
 
     EdgeWeight perform_minimum_cut(GraphPtr G) {
         // compatibility with min cut interface
@@ -81,7 +80,7 @@ class parallel_cactus : public minimum_cut {
             return std::make_tuple(
                 -1, empty, std::vector<std::pair<NodeID, EdgeID> > { });
         }
-        timer t;
+        phase_timer t;
         EdgeWeight mincut = graphs.back()->getMinDegree();
         recursive_cactus<GraphPtr> rc;
         exact_parallel_minimum_cut<GraphPtr> mc;
@@ -90,8 +89,7 @@ class parallel_cactus : public minimum_cut {
             viecut<GraphPtr> heuristic_mc;
             auto G2 = graphs.back();
             mincut = heuristic_mc.perform_minimum_cut(G2, true);
-            LOGC(timing) << "VieCut found cut " << mincut
-                         << " [Time: " << t.elapsed() << "s]";
+            t.lap("parallel cactus/viecut");
 #endif
         } else {
             mincut = known_mincut;
@@ -112,9 +110,8 @@ class parallel_cactus : public minimum_cut {
         while (graphs.back()->number_of_nodes() * 1.01 < previous_size) {
             mincut = minimum_cut_helpers<GraphPtr>::updateCut(graphs, mincut);
             previous_size = graphs.back()->number_of_nodes();
-            LOGC(timing) << "t " << t.elapsed() << " n "
-                         << graphs.back()->number_of_nodes()
-                         << " m " << graphs.back()->number_of_edges();
+            instrumentation::addLevel("parallel cactus", graphs.size() - 1,
+                                      graphs.back()->n(), graphs.back()->m());
 
 #ifdef PARALLEL
             // all runs after first disable blacklist so that every thread
@@ -145,9 +142,7 @@ class parallel_cactus : public minimum_cut {
                     }
                 }
             }
-            LOGC(timing) << "t " << t.elapsed() << " contract "
-                         << graphs.back()->number_of_nodes()
-                         << " to " << uf.n();
+            t.lap("parallel cactus/capforest");
             if (uf.n() < graphs.back()->number_of_nodes()) {
                 auto g_new = contraction::fromUnionFind(
                     graphs.back(), &uf, true);
@@ -155,11 +150,10 @@ class parallel_cactus : public minimum_cut {
                 mincut = minimum_cut_helpers<GraphPtr>::updateCut(
                     graphs, mincut);
             }
+            t.lap("parallel cactus/contraction");
 
             auto uf12 = tests::prTests12(graphs.back(), mincut + 1, true);
-            LOGC(timing) << "t12 " << t.elapsed() << " contract "
-                         << graphs.back()->number_of_nodes()
-                         << " to " << uf12.n();
+            t.lap("parallel cactus/padberg-rinaldi tests 1-2");
             if (uf12.n() < graphs.back()->number_of_nodes()) {
                 auto g12 = contraction::fromUnionFind(
                     graphs.back(), &uf12, true);
@@ -167,11 +161,10 @@ class parallel_cactus : public minimum_cut {
                 mincut = minimum_cut_helpers<GraphPtr>::updateCut(
                     graphs, mincut);
             }
+            t.lap("parallel cactus/contraction");
 
             auto uf34 = tests::prTests34(graphs.back(), mincut + 1, true);
-            LOGC(timing) << "t34 " << t.elapsed() << " contract "
-                         << graphs.back()->number_of_nodes()
-                         << " to " << uf34.n();
+            t.lap("parallel cactus/padberg-rinaldi tests 3-4");
             if (uf34.n() < graphs.back()->number_of_nodes()) {
                 auto g34 = contraction::fromUnionFind(
                     graphs.back(), &uf34, true);
@@ -179,6 +172,7 @@ class parallel_cactus : public minimum_cut {
                 mincut = minimum_cut_helpers<GraphPtr>::updateCut(
                     graphs, mincut);
             }
+            t.lap("parallel cactus/contraction");
 
             if (current_mincut > mincut) {
                 // mincut has improved, so all the edges that
@@ -194,15 +188,17 @@ class parallel_cactus : public minimum_cut {
             mincut = std::min(mincut,
                               mc.perform_minimum_cut(graphs.back(), true));
         }
+        t.lap("parallel cactus/exact algorithm");
 
         rc.setMincut(mincut);
         auto out_graph = rc.flowMincut(graphs);
+        t.lap("parallel cactus/recursive cactus");
 
         minimum_cut_helpers<GraphPtr>::setVertexLocations(
             out_graph, graphs, ge_ids, guaranteed_edges, mincut);
-
-        LOGC(timing) << "t " << t.elapsed() << " unpacked - n "
-                     << out_graph->n() << " m " << out_graph->m();
+        t.lap("parallel cactus/unpacking");
+        instrumentation::addCounter("cactus/vertices", out_graph->n());
+        instrumentation::addCounter("cactus/edges", out_graph->m());
 
         std::vector<std::pair<NodeID, EdgeID> > mb_edges;
         if (configuration::getConfig()->find_most_balanced_cut) {
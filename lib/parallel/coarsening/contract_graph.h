@@ -26,6 +26,7 @@
 #include "parallel/data_structure/union_find.h"
 #include "tlx/logger.hpp"
 #include "tools/hash.h"
+#include "tools/numa_tools.h"
 #include "tools/timer.h"
 
 class contraction {
@@ -404,7 +405,15 @@ class contraction {
                         num_edges += degrees[i];
                         coarser->new_node_hacky(num_edges);
                     }
-                    coarser->resize_m(num_edges);
+                    coarser->resize_m(num_edges, !numa_tools::enabled());
+                }
+                if (numa_tools::enabled()) {
+                    // spreads the pages of the edge array over the nodes of
+                    // all threads of the team instead of placing all of them
+                    // on the node of the allocating thread. Edges are
+                    // written below by the thread that holds their key, which
+                    // is unrelated to the page owner.
+                    coarser->first_touch_edges();
                 }
 
                 for (auto edge_uint : my_keys) {
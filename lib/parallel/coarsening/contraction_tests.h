@@ -14,11 +14,13 @@
 #include <algorithm>
 #include <atomic>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
 #include "common/definitions.h"
 #include "data_structure/graph_access.h"
+#include "data_structure/sorted_adjacency.h"
 #include "tlx/logger.hpp"
 
 #ifdef PARALLEL
@@ -118,10 +120,16 @@ class tests {
         G->computeDegrees();
         std::vector<uint8_t> finished(G->number_of_nodes(), false);
         std::vector<uint8_t> contracted(G->number_of_nodes(), 0);
+        // with sorted adjacency lists, the triangles of an edge are found by
+        // intersecting the neighborhoods of its vertices instead of marking
+        std::optional<sorted_adjacency> sorted;
+        if (sorted_adjacency::enabled()) {
+            sorted.emplace(G, /* parallel */ true);
+        }
 #pragma omp parallel
         {
             std::vector<std::pair<NodeID, EdgeID> > marked(
-                G->number_of_nodes(),
+                sorted ? 0 : G->number_of_nodes(),
                 std::make_pair(UNDEFINED_NODE, UNDEFINED_EDGE));
 #pragma omp for schedule(dynamic, 100)
             for (NodeID n = 0; n < G->number_of_nodes(); ++n) {
@@ -132,7 +140,7 @@ class tests {
 
                 for (EdgeID e : G->edges_of(n)) {
                     NodeID tgt = G->getEdgeTarget(n, e);
-                    if (tgt > n) {
+                    if (tgt > n && !sorted) {
                         marked[tgt] = std::make_pair(n, e);
                     }
                 }
@@ -143,49 +151,67 @@ class tests {
                     NodeID deg_tgt = G->getWeightedNodeDegree(tgt);
                     finished[tgt] = true;
                     EdgeWeight wgt_sum = w1;
-                    if (tgt > n) {
-                        for (EdgeID e2 : G->edges_of(tgt)) {
-                            NodeID tgt2 = G->getEdgeTarget(tgt, e2);
-                            if (marked[tgt2].second == UNDEFINED_EDGE)
-                                continue;
+                    bool triangle_contracted = false;
+                    // triangle n - tgt - tgt2 with w2 = w(tgt, tgt2) and
+                    // w3 = w(n, tgt2)
+                    auto triangle = [&](EdgeWeight w2, EdgeWeight w3) {
+                        wgt_sum += std::min(w2, w3);
 
-                            if (marked[tgt2].first != n)
-                                continue;
+                        bool contractible_one_cut =
+                            !find_all_cuts
+                            && 2 * (w1 + w3) >= deg_n
+                            && 2 * (w1 + w2) >= deg_tgt;
 
-                            EdgeWeight w2 = G->getEdgeWeight(tgt, e2);
-                            EdgeWeight w3 = G->getEdgeWeight(
-                                n, marked[tgt2].second);
+                        bool contractible_all_cuts =
+                            find_all_cuts
+                            && 2 * (w1 + w3) > deg_n
+                            && 2 * (w1 + w2) > deg_tgt
+                            && deg_n >= weight_limit
+                            && deg_tgt >= weight_limit;
 
-                            wgt_sum += std::min(w2, w3);
+                        if (contractible_one_cut ||
+                            contractible_all_cuts) {
+                            // node degrees change when we contract edges.
+                            // thus, we only use PR 2 or 3 when the
+                            // incident vertices haven't been contracted yet
+                            // keeping a data structure with current
+                            // degrees would be too expensive in parallel
+                            if (__sync_bool_compare_and_swap(
+                                    &contracted[n], false, true)) {
+                                if (__sync_bool_compare_and_swap(
+                                        &contracted[tgt], false, true)) {
+                                    uf.Union(n, tgt);
+                                    triangle_contracted = true;
+                                }
+                            }
+                        }
+                    };
 
-                            bool contractible_one_cut =
-                                !find_all_cuts
-                                && 2 * (w1 + w3) >= deg_n
-                                && 2 * (w1 + w2) >= deg_tgt;
+                    if (tgt > n) {
+                        if (sorted) {
+                            sorted->intersect(
+                                n, tgt, [&](NodeID, EdgeWeight w3,
+                                            EdgeWeight w2) {
+                                    if (!triangle_contracted)
+                                        triangle(w2, w3);
+                                });
+                        } else {
+                            for (EdgeID e2 : G->edges_of(tgt)) {
+                                NodeID tgt2 = G->getEdgeTarget(tgt, e2);
+                                if (marked[tgt2].second == UNDEFINED_EDGE)
+                                    continue;
 
-                            bool contractible_all_cuts =
-                                find_all_cuts
-                                && 2 * (w1 + w3) > deg_n
-                                && 2 * (w1 + w2) > deg_tgt
-                                && deg_n >= weight_limit
-                                && deg_tgt >= weight_limit;
+                                if (marked[tgt2].first != n)
+                                    continue;
 
-                            if (contractible_one_cut ||
-                                contractible_all_cuts) {
-                                // node degrees change when we contract edges.
-                                // thus, we only use PR 2 or 3 when the
-                                // incident vertices haven't been contracted yet
-                                // keeping a data structure with current
-                                // degrees would be too expensive in parallel
-                                if (__sync_bool_compare_and_swap(
-                                        &contracted[n], false, true)) {
-                                    if (__sync_bool_compare_and_swap(
-                                            &contracted[tgt], false, true)) {
-                                        uf.Union(n, tgt);
-                                        break;
-                                    }
-                                }
+                                triangle(G->getEdgeWeight(tgt, e2),
+                                         G->getEdgeWeight(
+                                             n, marked[tgt2].second));
+                                if (triangle_contracted)
+                                    break;
                             }
+                            marked[tgt] = std::make_pair(UNDEFINED_NODE,
+                                                         UNDEFINED_EDGE);
                         }
 
                         if (wgt_sum >= weight_limit) {
@@ -193,8 +219,6 @@ class tests {
                             contracted[tgt] = true;
                             uf.Union(n, tgt);
                         }
-                        marked[tgt] = std::make_pair(UNDEFINED_NODE,
-                                                     UNDEFINED_EDGE);
                     }
                 }
             }
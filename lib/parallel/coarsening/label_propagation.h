@@ -23,9 +23,12 @@
 #include <utility>
 #include <vector>
 
+#include "common/configuration.h"
 #include "common/definitions.h"
 #include "data_structure/graph_access.h"
+#include "data_structure/sparse_accumulator.h"
 #include "tlx/logger.hpp"
+#include "tools/numa_tools.h"
 #include "tools/random_functions.h"
 #include "tools/string.h"
 #include "tools/timer.h"
@@ -39,25 +42,36 @@ class label_propagation {
     label_propagation() { }
     virtual ~label_propagation() { }
 
+    // Label propagation with an active vertex set: the first round visits
+    // all vertices in random order, later rounds only visit vertices that
+    // have a neighbor which changed its label in the previous round. Stops
+    // after lp_iterations rounds or when at most a fraction lp_convergence
+    // of the vertices changed their label. A vertex only joins a cluster
+    // with less than lp_cluster_size vertices (if set).
     std::vector<NodeID> propagate_labels(GraphPtr G) {
         timer t_start;
-        std::vector<uint32_t> cluster_mapping;
-
-        cluster_mapping.resize(G->number_of_nodes());
-        std::vector<NodeID> permutation(G->number_of_nodes());
-
-        random_functions::permutate_vector_local(&permutation, true);
+        auto cfg = configuration::getConfig();
+        NodeID num_nodes = G->number_of_nodes();
+        NodeID max_size = cfg->lp_cluster_size;
+        // labels are read by all threads
+        std::vector<NodeID> cluster_mapping =
+            numa_tools::interleavedVector<NodeID>(num_nodes, 0);
+        std::vector<NodeID> cluster_size(max_size > 0 ? num_nodes : 0, 1);
+        std::vector<NodeID> active(num_nodes);
+        std::vector<NodeID> next_active;
+        std::vector<uint8_t> in_next(num_nodes, 0);
+
+        random_functions::permutate_vector_local(&active, true);
 
         for (size_t i = 0; i < cluster_mapping.size(); ++i) {
             cluster_mapping[i] = i;
         }
 
-        int iterations = 2;
-
-        LOG << "Number of iterations: " << iterations;
+        LOG << "Maximum number of iterations: " << cfg->lp_iterations;
         LOGC(timing) << "start " << t_start.elapsed();
 
-        NodeID last_node = G->number_of_nodes();
+        size_t changed = 0;
+        bool converged = active.empty();
 
 #pragma omp parallel
         {
@@ -65,38 +79,83 @@ class label_propagation {
 
             m_mt.seed(random_functions::getSeed() + omp_get_thread_num());
 
-            std::vector<std::pair<NodeID, NodeID> > wgt(
-                G->number_of_nodes(), std::make_pair(0, 0));
+            sparse_accumulator connection;
+            std::vector<NodeID> local_next;
             timer t;
-            for (int j = 0; j < iterations; j++) {
-#pragma omp for schedule(dynamic, 64)
-                for (NodeID node = 0; node < last_node; ++node) {
-                    NodeID n = permutation[node];
-                    PartitionID max_block = cluster_mapping[n];
+            for (size_t j = 0; j < cfg->lp_iterations && !converged; j++) {
+#pragma omp for schedule(dynamic, 64) reduction(+ : changed)
+                for (size_t i = 0; i < active.size(); ++i) {
+                    NodeID n = active[i];
+                    PartitionID old_block = cluster_mapping[n];
+                    PartitionID max_block = old_block;
                     EdgeWeight max_value = 0;
+                    connection.reset(G->getUnweightedNodeDegree(n));
 
                     for (EdgeID e : G->edges_of(n)) {
                         NodeID target = G->getEdgeTarget(n, e);
                         PartitionID block = cluster_mapping[target];
+                        if (max_size > 0 && block != old_block
+                            && cluster_size[block] >= max_size) {
+                            continue;
+                        }
+                        EdgeWeight value =
+                            connection.add(block, G->getEdgeWeight(n, e));
 
-                        wgt[block].second =
-                            ((wgt[block].first == n) * wgt[block].second)
-                            + G->getEdgeWeight(n, e);
-                        wgt[block].first = n;
-
-                        if (wgt[block].second > max_value ||
-                            (wgt[block].second == max_value &&
-                             m_mt() % 2)) {
-                            max_value = wgt[block].second;
+                        if (value > max_value ||
+                            (value == max_value && m_mt() % 2)) {
+                            max_value = value;
                             max_block = block;
                         }
                     }
 
+                    // stay in current block if it is one of the strongest
+                    if (max_block == old_block
+                        || connection.get(old_block) == max_value) {
+                        continue;
+                    }
+
+                    if (max_size > 0) {
+                        // cluster might have filled up concurrently
+                        if (__sync_fetch_and_add(&cluster_size[max_block], 1)
+                            >= max_size) {
+                            __sync_fetch_and_sub(&cluster_size[max_block], 1);
+                            continue;
+                        }
+                        __sync_fetch_and_sub(&cluster_size[old_block], 1);
+                    }
+
                     cluster_mapping[n] = max_block;
+                    ++changed;
+                    for (EdgeID e : G->edges_of(n)) {
+                        NodeID target = G->getEdgeTarget(n, e);
+                        if (!in_next[target] &&
+                            __sync_bool_compare_and_swap(
+                                &in_next[target], 0, 1)) {
+                            local_next.emplace_back(target);
+                        }
+                    }
+                }
+
+#pragma omp critical
+                {
+                    next_active.insert(next_active.end(),
+                                       local_next.begin(), local_next.end());
+                }
+                local_next.clear();
+#pragma omp barrier
+#pragma omp single
+                {
+                    LOGC(timing) << "LP: Iteration " << j << " - " << changed
+                                 << " changes, Timer: " << t.elapsedToZero();
+                    for (NodeID n : next_active) {
+                        in_next[n] = 0;
+                    }
+                    active.swap(next_active);
+                    next_active.clear();
+                    converged = active.empty()
+                                || changed <= cfg->lp_convergence * num_nodes;
+                    changed = 0;
                 }
-                LOGC(timing && !omp_get_thread_num())
-                    << "LP: Iteration " << j
-                    << " -  Timer: " << t.elapsedToZero();
             }
         }
 
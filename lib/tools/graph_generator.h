@@ -0,0 +1,229 @@
+/******************************************************************************
+ * graph_generator.h
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2019-2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/definitions.h"
+#include "data_structure/graph_access.h"
+#include "data_structure/mutable_graph.h"
+#include "tlx/logger.hpp"
+#include "tools/random_functions.h"
+
+// Random graph families used by the generator apps and the benchmark suite.
+// All generators draw from random_functions, set its seed beforehand for
+// reproducible graphs.
+class graph_generator {
+ public:
+    static constexpr bool debug = false;
+
+    // blocks_per_dimension^2 gnp graphs with vertices_per_block vertices each,
+    // arranged in a torus. Neighboring blocks are connected by cut random
+    // edges, each vertex has approximately 8 * cut + 2 in-block edges.
+    static graphAccessPtr gnpTorus(size_t vertices_per_block,
+                                   size_t blocks_per_dimension,
+                                   size_t cut) {
+        graphAccessPtr G = std::make_shared<graph_access>();
+
+        size_t blocks = blocks_per_dimension * blocks_per_dimension;
+        size_t num_vertices = blocks * vertices_per_block;
+
+        LOG << "Generating inter-block edges...";
+
+        std::vector<std::vector<NodeID> > interblockedges(num_vertices);
+
+        for (size_t i = 0; i < blocks; ++i) {
+            NodeID my_start = vertices_per_block * i;
+            NodeID x = i % blocks_per_dimension;
+            NodeID y = i / blocks_per_dimension;
+            // right
+            for (size_t k = 0; k < cut; ++k) {
+                size_t r1 = random_functions::nextInt(0,
+                                                      vertices_per_block - 1);
+                size_t r2 = random_functions::nextInt(0,
+                                                      vertices_per_block - 1);
+                NodeID v1 = my_start + r1;
+                NodeID v2 = ((y * blocks_per_dimension)
+                             + ((x + 1) % blocks_per_dimension))
+                            * vertices_per_block + r2;
+
+                interblockedges[v1].emplace_back(v2);
+                interblockedges[v2].emplace_back(v1);
+            }
+
+            // down
+            for (size_t k = 0; k < cut; ++k) {
+                size_t r1 = random_functions::nextInt(0,
+                                                      vertices_per_block - 1);
+                size_t r2 = random_functions::nextInt(0,
+                                                      vertices_per_block - 1);
+                NodeID v1 = my_start + r1;
+                NodeID v2 = ((((y + 1) % blocks_per_dimension)
+                              * blocks_per_dimension) + x)
+                            * vertices_per_block + r2;
+
+                interblockedges[v1].emplace_back(v2);
+                interblockedges[v2].emplace_back(v1);
+            }
+        }
+
+        G->start_construction(num_vertices, num_vertices * 6 * cut);
+        std::vector<std::vector<EdgeWeight> > inblock(vertices_per_block);
+
+        for (auto& i : inblock) {
+            i.resize(vertices_per_block, 0);
+        }
+
+        for (size_t b = 0; b < blocks; ++b) {
+            LOG << "Generating edges for block " << b << "...";
+            NodeID my_start = b * vertices_per_block;
+            for (auto& i : inblock) {
+                for (auto& j : i) {
+                    j = 0;
+                }
+            }
+
+            for (size_t i = 0; i < inblock.size(); ++i) {
+                for (size_t m = 0; m < 4 * cut + 1; ++m) {
+                    size_t r = random_functions::nextInt(
+                        0, vertices_per_block - 1);
+                    inblock[i][r] += 1;
+                    inblock[r][i] += 1;
+                }
+            }
+
+            for (size_t i = 0; i < inblock.size(); ++i) {
+                G->new_node();
+                for (size_t j = 0; j < inblock[i].size(); ++j) {
+                    if (inblock[i][j] > 0)
+                        G->new_edge(i + my_start, j + my_start,
+                                    inblock[i][j]);
+                }
+
+                if (interblockedges[i + my_start].size() > 0) {
+                    std::map<size_t, size_t> intermap;
+                    std::for_each(interblockedges[i + my_start].begin(),
+                                  interblockedges[i + my_start].end(),
+                                  [&intermap](NodeID val) {
+                                      intermap[val]++;
+                                  });
+
+                    for (const auto& p : intermap) {
+                        G->new_edge(i + my_start, p.first, p.second);
+                    }
+                }
+            }
+        }
+
+        G->finish_construction();
+        return G;
+    }
+
+    // adds edges_per_vertex new unit weight edges to random other vertices
+    // to every vertex of G. Returns the added edges in random order, as
+    // used for decremental workloads.
+    static std::vector<std::pair<NodeID, NodeID> > overlayRandomEdges(
+        mutableGraphPtr G, size_t edges_per_vertex) {
+        std::vector<std::pair<NodeID, NodeID> > added_edges;
+
+        for (auto v : G->nodes()) {
+            size_t i = 0;
+            while (i < edges_per_vertex) {
+                NodeID r = random_functions::nextInt(0, G->n() - 1);
+                if (!existsEdge(G, v, r)) {
+                    G->new_edge_order(v, r, 1);
+                    added_edges.emplace_back(v, r);
+                    ++i;
+                }
+            }
+        }
+
+        random_functions::permutate_vector_good(&added_edges);
+        return added_edges;
+    }
+
+    // R-MAT graph of Chakrabarti et al.
+    // (https://doi.org/10.1137/1.9781611972740.43) with 2^scale vertices
+    // and edge_factor * 2^scale generated edges.
+    // Each edge recursively picks one of the four adjacency matrix quadrants
+    // with probabilities a, b, c and 1 - a - b - c. Self-loops are dropped
+    // and parallel edges are merged, so the resulting graph is unweighted.
+    // R-MAT graphs contain many isolated and low degree vertices.
+    static graphAccessPtr rmat(size_t scale, size_t edge_factor,
+                               double a = 0.57, double b = 0.19,
+                               double c = 0.19) {
+        NodeID n = static_cast<NodeID>(1) << scale;
+        EdgeID num_generated = static_cast<EdgeID>(edge_factor) * n;
+        std::vector<std::pair<NodeID, NodeID> > edges;
+        edges.reserve(2 * num_generated);
+
+        for (EdgeID e = 0; e < num_generated; ++e) {
+            NodeID src = 0;
+            NodeID tgt = 0;
+            for (size_t level = 0; level < scale; ++level) {
+                double r = random_functions::nextDouble(0, 1);
+                src <<= 1;
+                tgt <<= 1;
+                if (r < a) {
+                    continue;
+                } else if (r < a + b) {
+                    tgt |= 1;
+                } else if (r < a + b + c) {
+                    src |= 1;
+                } else {
+                    src |= 1;
+                    tgt |= 1;
+                }
+            }
+
+            if (src != tgt) {
+                edges.emplace_back(src, tgt);
+                edges.emplace_back(tgt, src);
+            }
+        }
+
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        graphAccessPtr G = std::make_shared<graph_access>();
+        G->start_construction(n, edges.size());
+        size_t pos = 0;
+        for (NodeID v = 0; v < n; ++v) {
+            G->new_node();
+            while (pos < edges.size() && edges[pos].first == v) {
+                G->new_edge(v, edges[pos].second, 1);
+                ++pos;
+            }
+        }
+        G->finish_construction();
+        return G;
+    }
+
+ private:
+    static bool existsEdge(mutableGraphPtr G, NodeID s, NodeID t) {
+        if (s == t) {
+            return true;
+        }
+
+        for (EdgeID e : G->edges_of(s)) {
+            NodeID tgt = G->getEdgeTarget(s, e);
+            if (tgt == t) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
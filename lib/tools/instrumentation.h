@@ -0,0 +1,206 @@
+/******************************************************************************
+ * instrumentation.h
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/configuration.h"
+#include "common/definitions.h"
+#include "tlx/cmdline_parser.hpp"
+#include "tlx/logger.hpp"
+#include "tools/timer.h"
+
+// Registry of phase timings, event counters and graph sizes per contraction
+// level. Everything is disabled unless an output file is set with the
+// --profile flag, in which case the registry is written as JSON or CSV
+// (depending on the file extension) when the program exits.
+//
+// Counters are accumulated in a separate map for every thread and merged on
+// output, so they can be incremented inside of parallel regions.
+class instrumentation {
+ public:
+    instrumentation(instrumentation const&) = delete;
+    void operator = (instrumentation const&) = delete;
+
+    static std::shared_ptr<instrumentation> getInstance() {
+        static std::shared_ptr<instrumentation> instance{ new instrumentation };
+        return instance;
+    }
+
+    ~instrumentation() {
+        if (!output_path.empty()) {
+            write(output_path);
+        }
+    }
+
+    static void addCmdlineFlag(tlx::CmdlineParser* cmdl) {
+        cmdl->add_string("profile", getInstance()->output_path,
+                         "write phase timings and counters to file "
+                         "(.json or .csv)");
+    }
+
+    static bool enabled() {
+        return !getInstance()->output_path.empty();
+    }
+
+    static void addPhase(const std::string& name, double seconds) {
+        if (!enabled())
+            return;
+        auto inst = getInstance();
+        std::lock_guard<std::mutex> lock(inst->mutex);
+        auto& [calls, time] = inst->phases[name];
+        ++calls;
+        time += seconds;
+    }
+
+    static void addCounter(const std::string& name, int64_t value = 1) {
+        if (!enabled())
+            return;
+        (*getInstance()->localCounters())[name] += value;
+    }
+
+    static void addLevel(const std::string& algorithm, size_t level,
+                         NodeID n, EdgeID m) {
+        if (!enabled())
+            return;
+        auto inst = getInstance();
+        std::lock_guard<std::mutex> lock(inst->mutex);
+        inst->levels.emplace_back(algorithm, level, n, m);
+    }
+
+    std::map<std::string, int64_t> mergedCounters() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::map<std::string, int64_t> merged;
+        for (const auto& local : thread_counters) {
+            for (const auto& [name, value] : *local) {
+                merged[name] += value;
+            }
+        }
+        return merged;
+    }
+
+    void write(const std::string& path) {
+        auto counters = mergedCounters();
+        std::ofstream f(path);
+        if (!f) {
+            std::cerr << "Could not open profile output " << path << std::endl;
+            return;
+        }
+
+        if (path.size() > 4 && path.substr(path.size() - 4) == ".csv") {
+            f << "type,name,level,n,m,calls,seconds,value" << std::endl;
+            for (const auto& [name, p] : phases) {
+                f << "phase," << name << ",,,," << p.first << ","
+                  << p.second << "," << std::endl;
+            }
+            for (const auto& [name, value] : counters) {
+                f << "counter," << name << ",,,,,," << value << std::endl;
+            }
+            for (const auto& [algorithm, level, n, m] : levels) {
+                f << "level," << algorithm << "," << level << "," << n << ","
+                  << m << ",,," << std::endl;
+            }
+        } else {
+            f << "{" << std::endl << "  \"phases\": [";
+            bool first = true;
+            for (const auto& [name, p] : phases) {
+                f << (first ? "" : ",") << std::endl
+                  << "    { \"name\": \"" << name << "\", \"calls\": "
+                  << p.first << ", \"seconds\": " << p.second << " }";
+                first = false;
+            }
+            f << std::endl << "  ]," << std::endl << "  \"counters\": {";
+            first = true;
+            for (const auto& [name, value] : counters) {
+                f << (first ? "" : ",") << std::endl
+                  << "    \"" << name << "\": " << value;
+                first = false;
+            }
+            f << std::endl << "  }," << std::endl << "  \"levels\": [";
+            first = true;
+            for (const auto& [algorithm, level, n, m] : levels) {
+                f << (first ? "" : ",") << std::endl
+                  << "    { \"algorithm\": \"" << algorithm
+                  << "\", \"level\": " << level << ", \"n\": " << n
+                  << ", \"m\": " << m << " }";
+                first = false;
+            }
+            f << std::endl << "  ]" << std::endl << "}" << std::endl;
+        }
+    }
+
+ private:
+    instrumentation() { }
+
+    std::unordered_map<std::string, int64_t>* localCounters() {
+        thread_local std::unordered_map<std::string, int64_t>* local = nullptr;
+        if (!local) {
+            std::lock_guard<std::mutex> lock(mutex);
+            thread_counters.emplace_back(
+                std::make_unique<std::unordered_map<std::string, int64_t> >());
+            local = thread_counters.back().get();
+        }
+        return local;
+    }
+
+    std::string output_path;
+    std::mutex mutex;
+    // name -> (number of calls, total time)
+    std::map<std::string, std::pair<size_t, double> > phases;
+    std::vector<std::unique_ptr<std::unordered_map<std::string, int64_t> > >
+    thread_counters;
+    std::vector<std::tuple<std::string, size_t, NodeID, EdgeID> > levels;
+};
+
+// Measures the time of consecutive phases. lap(name) records the time since
+// construction or the previous lap. If a name is given in the constructor,
+// the time until destruction is recorded as that phase. With verbose output
+// enabled, phase times are also logged.
+class phase_timer {
+ public:
+    phase_timer()
+        : phase_timer("") { }
+
+    explicit phase_timer(const std::string& scope_name)
+        : scope_name(scope_name),
+          active(configuration::getConfig()->verbose
+                 || instrumentation::enabled()) { }
+
+    ~phase_timer() {
+        if (!scope_name.empty()) {
+            lap(scope_name);
+        }
+    }
+
+    void lap(const std::string& name) {
+        if (!active)
+            return;
+        double elapsed = t.elapsedToZero();
+        LOGC(configuration::getConfig()->verbose) << name << ": " << elapsed;
+        instrumentation::addPhase(name, elapsed);
+    }
+
+ private:
+    std::string scope_name;
+    bool active;
+    timer t;
+};
@@ -0,0 +1,182 @@
+/******************************************************************************
+ * numa_tools.h
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#pragma once
+
+#include <omp.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#ifdef USE_NUMA
+#include <numa.h>
+#endif
+
+#include "common/configuration.h"
+#include "tlx/logger.hpp"
+
+// Helpers for the opt-in NUMA mode of the parallel programs (--numa).
+// Linux places a page on the NUMA node of the thread that first writes to
+// it. Thus, arrays that are initialized by a single thread all end up on
+// one socket and every other socket accesses them remotely. In NUMA mode,
+// arrays that are mostly accessed in vertex order are initialized in
+// parallel with static schedule and arrays that all threads access at
+// random are interleaved over all nodes. With libnuma (-DUSE_NUMA=ON),
+// OpenMP threads are also pinned to cores spread over all nodes, so that
+// the thread that touched a page keeps running on that node. Without
+// libnuma, the node of a core is unknown and threads are not pinned.
+class numa_tools {
+ public:
+    static constexpr bool debug = false;
+
+    static bool enabled() {
+        return configuration::getConfig()->numa;
+    }
+
+    // interleaves the pages of [ptr, ptr + bytes) over all NUMA nodes. Only
+    // affects pages that were not touched yet, i.e. call between allocation
+    // (e.g. std::vector::reserve) and initialization.
+    static void interleave([[maybe_unused]] void* ptr,
+                           [[maybe_unused]] size_t bytes) {
+#ifdef USE_NUMA
+        if (!enabled() || numa_available() < 0)
+            return;
+        // mbind needs page aligned memory, the partial pages at both ends
+        // keep the default policy
+        uintptr_t page = sysconf(_SC_PAGESIZE);
+        uintptr_t begin = (reinterpret_cast<uintptr_t>(ptr) + page - 1)
+                          & ~(page - 1);
+        uintptr_t end = (reinterpret_cast<uintptr_t>(ptr) + bytes)
+                        & ~(page - 1);
+        if (end > begin) {
+            numa_interleave_memory(reinterpret_cast<void*>(begin),
+                                   end - begin, numa_all_nodes_ptr);
+        }
+#endif
+    }
+
+    // reserves memory for n elements of v and interleaves it
+    template <class T>
+    static void interleavedReserve(std::vector<T>* v, size_t n) {
+        v->reserve(n);
+        interleave(v->data(), n * sizeof(T));
+    }
+
+    // vector of n copies of value with interleaved pages
+    template <class T>
+    static std::vector<T> interleavedVector(size_t n, const T& value) {
+        std::vector<T> v;
+        interleavedReserve(&v, n);
+        v.resize(n, value);
+        return v;
+    }
+
+    // sets v[begin, end) to value, split over the threads of the current
+    // team with static schedule, so that the pages are first touched by the
+    // threads that later work on these elements. All threads of the team
+    // need to call this, outside of a parallel region it is sequential.
+    template <class T>
+    static void firstTouch(std::vector<T>* v, size_t begin, size_t end,
+                           const T& value) {
+#pragma omp for schedule(static)
+        for (size_t i = begin; i < end; ++i) {
+            (*v)[i] = value;
+        }
+    }
+
+    // pins every OpenMP thread to one core. Consecutive threads are placed
+    // on different NUMA nodes (round robin), so that a run with t threads
+    // uses the memory bandwidth of all sockets. Needs libnuma.
+    static void bindThreads() {
+        if (!enabled())
+            return;
+
+        if (numNodes() < 2) {
+            LOG1 << "NUMA mode: no NUMA topology available, threads are not "
+                 << "pinned (needs more than one node and -DUSE_NUMA=ON)";
+            return;
+        }
+
+        std::vector<int> cpus = spreadCores();
+        if (cpus.empty())
+            return;
+
+#pragma omp parallel
+        {
+            int cpu = cpus[omp_get_thread_num() % cpus.size()];
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            sched_setaffinity(0, sizeof(cpu_set_t), &set);
+        }
+        LOG1 << "NUMA mode: pinned " << omp_get_max_threads()
+             << " threads to cores on " << numNodes() << " nodes";
+    }
+
+    static int numNodes() {
+#ifdef USE_NUMA
+        if (numa_available() >= 0)
+            return numa_num_configured_nodes();
+#endif
+        return 1;
+    }
+
+ private:
+    // cores available to this process. Read on the first call, as
+    // bindThreads pins the calling thread to a single core and later calls
+    // (e.g. with another number of threads) would only see that core.
+    static const cpu_set_t& processCores() {
+        static const cpu_set_t cores = [] {
+            cpu_set_t available;
+            CPU_ZERO(&available);
+            if (sched_getaffinity(0, sizeof(cpu_set_t), &available) != 0) {
+                LOG1 << "Warning: could not get CPU affinity, "
+                     << "threads not pinned";
+                CPU_ZERO(&available);
+            }
+            return available;
+        }();
+        return cores;
+    }
+
+    // cores available to this process, ordered round robin over the nodes
+    static std::vector<int> spreadCores() {
+        const cpu_set_t& available = processCores();
+        if (CPU_COUNT(&available) == 0) {
+            return { };
+        }
+
+        std::vector<std::vector<int> > cores_of_node(numNodes());
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (!CPU_ISSET(cpu, &available))
+                continue;
+            int node = 0;
+#ifdef USE_NUMA
+            if (numa_available() >= 0)
+                node = std::max(numa_node_of_cpu(cpu), 0);
+#endif
+            cores_of_node[node % cores_of_node.size()].push_back(cpu);
+        }
+
+        std::vector<int> cpus;
+        for (size_t i = 0; cpus.size() < static_cast<size_t>(
+                 CPU_COUNT(&available)); ++i) {
+            for (const auto& cores : cores_of_node) {
+                if (i < cores.size())
+                    cpus.push_back(cores[i]);
+            }
+        }
+        return cpus;
+    }
+};
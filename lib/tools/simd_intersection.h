@@ -0,0 +1,150 @@
+/******************************************************************************
+ * simd_intersection.h
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#pragma once
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common/definitions.h"
+
+// Intersection of two sorted arrays of distinct vertex ids, e.g. the sorted
+// adjacency lists of sorted_adjacency. For every common element,
+// on_match(i, j) is called with a[i] == b[j], in increasing order. Blocks of
+// 16 (AVX-512) or 8 (AVX2) elements of both arrays are compared all-to-all by
+// comparing one block with all rotations of the other, then the block with
+// the smaller last element is skipped. The remaining elements are merged
+// sequentially. Without AVX2 (the build uses -march=native), only the
+// sequential merge is used.
+class simd_intersection {
+ public:
+    template <class F>
+    static void intersect(const NodeID* a, size_t size_a,
+                          const NodeID* b, size_t size_b, F on_match) {
+        size_t i = 0;
+        size_t j = 0;
+#if defined(__AVX512F__)
+        intersectAVX512(a, size_a, b, size_b, &i, &j, on_match);
+#endif
+#if defined(__AVX2__)
+        intersectAVX2(a, size_a, b, size_b, &i, &j, on_match);
+#endif
+        intersectScalar(a, size_a, b, size_b, i, j, on_match);
+    }
+
+    // number of common elements of a and b
+    static size_t count(const NodeID* a, size_t size_a,
+                        const NodeID* b, size_t size_b) {
+        size_t common = 0;
+        intersect(a, size_a, b, size_b, [&common](size_t, size_t) {
+                      ++common;
+                  });
+        return common;
+    }
+
+ private:
+    template <class F>
+    static void intersectScalar(const NodeID* a, size_t size_a,
+                                const NodeID* b, size_t size_b,
+                                size_t i, size_t j, F on_match) {
+        while (i < size_a && j < size_b) {
+            if (a[i] < b[j]) {
+                ++i;
+            } else if (a[i] > b[j]) {
+                ++j;
+            } else {
+                on_match(i++, j++);
+            }
+        }
+    }
+
+    // calls on_match for every element a[i + k] with bit k set in mask and
+    // its position in b, which is at least j
+    template <class F>
+    static void reportMatches(const NodeID* a, const NodeID* b,
+                              size_t i, size_t j, uint32_t mask,
+                              F on_match) {
+        size_t k = j;
+        while (mask) {
+            size_t pos = i + __builtin_ctz(mask);
+            while (b[k] != a[pos]) {
+                ++k;
+            }
+            on_match(pos, k);
+            mask &= mask - 1;
+        }
+    }
+
+#if defined(__AVX512F__)
+    template <class F>
+    static void intersectAVX512(const NodeID* a, size_t size_a,
+                                const NodeID* b, size_t size_b,
+                                size_t* i, size_t* j, F on_match) {
+        constexpr size_t block = 16;
+        const __m512i rotate = _mm512_set_epi32(0, 15, 14, 13, 12, 11, 10, 9,
+                                                8, 7, 6, 5, 4, 3, 2, 1);
+        while (*i + block <= size_a && *j + block <= size_b) {
+            __m512i va = _mm512_loadu_si512(a + *i);
+            __m512i vb = _mm512_loadu_si512(b + *j);
+            __mmask16 mask = _mm512_cmpeq_epi32_mask(va, vb);
+            for (size_t r = 1; r < block; ++r) {
+                // rotate by one element. the unmasked intrinsics pass an
+                // undefined source vector, which gcc reports as
+                // uninitialized; a full zero-mask compiles to the same vpermd
+                vb = _mm512_maskz_permutexvar_epi32(0xFFFF, rotate, vb);
+                mask |= _mm512_cmpeq_epi32_mask(va, vb);
+            }
+            reportMatches(a, b, *i, *j, mask, on_match);
+
+            NodeID last_a = a[*i + block - 1];
+            NodeID last_b = b[*j + block - 1];
+            if (last_a <= last_b)
+                *i += block;
+            if (last_b <= last_a)
+                *j += block;
+        }
+    }
+#endif
+
+#if defined(__AVX2__)
+    template <class F>
+    static void intersectAVX2(const NodeID* a, size_t size_a,
+                              const NodeID* b, size_t size_b,
+                              size_t* i, size_t* j, F on_match) {
+        constexpr size_t block = 8;
+        const __m256i rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+        while (*i + block <= size_a && *j + block <= size_b) {
+            __m256i va = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(a + *i));
+            __m256i vb = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(b + *j));
+            __m256i eq = _mm256_cmpeq_epi32(va, vb);
+            for (size_t r = 1; r < block; ++r) {
+                vb = _mm256_permutevar8x32_epi32(vb, rotate);
+                eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, vb));
+            }
+            uint32_t mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+            reportMatches(a, b, *i, *j, mask, on_match);
+
+            NodeID last_a = a[*i + block - 1];
+            NodeID last_b = b[*j + block - 1];
+            if (last_a <= last_b)
+                *i += block;
+            if (last_b <= last_a)
+                *j += block;
+        }
+    }
+#endif
+};
@@ -0,0 +1,125 @@
+/******************************************************************************
+ * balanced_cut_index_test.cpp
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "algorithms/global_mincut/cactus/cactus_mincut.h"
+#include "algorithms/global_mincut/dynamic/balanced_cut_index.h"
+#include "common/configuration.h"
+#include "common/definitions.h"
+#include "data_structure/mutable_graph.h"
+#include "gtest/gtest.h"
+#include "tools/random_functions.h"
+
+// minimum cut and most balanced minimum cut by enumerating all cuts
+static std::pair<EdgeWeight, EdgeWeight> bruteForce(mutableGraphPtr G) {
+    EdgeWeight mincut = UNDEFINED_EDGE;
+    EdgeWeight balance = 0;
+    for (uint64_t set = 1; set + 1 < (UINT64_C(1) << G->n()); ++set) {
+        EdgeWeight cut = 0;
+        for (NodeID n : G->nodes()) {
+            for (EdgeID e : G->edges_of(n)) {
+                NodeID t = G->getEdgeTarget(n, e);
+                if (((set >> n) & 1) && !((set >> t) & 1))
+                    cut += G->getEdgeWeight(n, e);
+            }
+        }
+        EdgeWeight size = __builtin_popcountll(set);
+        size = std::min(size, G->n() - size);
+        if (cut < mincut) {
+            mincut = cut;
+            balance = 0;
+        }
+        if (cut == mincut)
+            balance = std::max(balance, size);
+    }
+    return std::make_pair(mincut, balance);
+}
+
+static EdgeWeight cutValue(mutableGraphPtr G, const std::vector<NodeID>& side) {
+    std::vector<bool> in_side(G->n(), false);
+    for (NodeID v : side) {
+        in_side[v] = true;
+    }
+    EdgeWeight cut = 0;
+    for (NodeID n : G->nodes()) {
+        for (EdgeID e : G->edges_of(n)) {
+            if (in_side[n] && !in_side[G->getEdgeTarget(n, e)])
+                cut += G->getEdgeWeight(n, e);
+        }
+    }
+    return cut;
+}
+
+// two cycles sharing vertex 7 and a vertex hanging off vertex 3
+static mutableGraphPtr cyclesWithBridge() {
+    mutableGraphPtr G = std::make_shared<mutable_graph>();
+    G->start_construction(14);
+    for (NodeID i = 0; i < 7; ++i) {
+        G->new_edge(i, i + 1, 1);
+    }
+    G->new_edge(0, 7, 1);
+    for (NodeID i = 7; i < 12; ++i) {
+        G->new_edge(i, i + 1, 1);
+    }
+    G->new_edge(7, 12, 1);
+    G->new_edge(3, 13, 2);
+    G->finish_construction();
+    return G;
+}
+
+TEST(BalancedCutIndexTest, MatchesEnumeration) {
+    configuration::getConfig()->save_cut = true;
+    configuration::getConfig()->find_most_balanced_cut = false;
+    configuration::getConfig()->find_lowest_conductance = false;
+    for (size_t run = 0; run < 10; ++run) {
+        random_functions::setSeed(run);
+        mutableGraphPtr G = cyclesWithBridge();
+        cactus_mincut<mutableGraphPtr> cactus;
+        auto [cut, mg, balanced_edges] =
+            cactus.findAllMincuts(cyclesWithBridge());
+        ASSERT_EQ(cut, 2);
+
+        balanced_cut_index index;
+        index.build(mg, cut);
+
+        while (true) {
+            auto [mincut, balance] = bruteForce(G);
+            if (mincut != cut)
+                break;
+
+            ASSERT_EQ(index.bestWeight(), balance);
+            auto side = index.bestSide();
+            ASSERT_EQ(std::min(side.size(), G->n() - side.size()), balance);
+            ASSERT_EQ(cutValue(G, side), cut);
+
+            NodeID s = random_functions::nextInt(0, G->n() - 1);
+            NodeID t = random_functions::nextInt(0, G->n() - 1);
+            if (s != t) {
+                G->new_edge_order(s, t, 1);
+                index.addEdge(s, t);
+            }
+        }
+    }
+}
+
+TEST(BalancedCutIndexTest, NoCutWithoutMinimumCut) {
+    mutableGraphPtr G = cyclesWithBridge();
+    G->deleteEdge(3, 0);
+    balanced_cut_index index;
+    index.build(G, 0);
+    index.addEdge(0, 5);
+    ASSERT_EQ(index.bestWeight(), 0);
+    ASSERT_TRUE(index.bestSide().empty());
+}
@@ -0,0 +1,242 @@
+/******************************************************************************
+ * biconnectivity_test.cpp
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <memory>
+#include <queue>
+#include <random>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "algorithms/misc/find_articulation_points.h"
+#include "algorithms/misc/parallel_biconnectivity.h"
+#include "algorithms/multicut/multicut_problem.h"
+#include "common/definitions.h"
+#include "data_structure/graph_access.h"
+#include "data_structure/mutable_graph.h"
+#include "gtest/gtest.h"
+
+namespace {
+// random recursive trees plus some random edges, in two components. The
+// parent of every tree vertex is one of the first max_parent vertices of its
+// component. The random edges can be parallel to existing edges.
+mutableGraphPtr randomGraph(NodeID n, NodeID extra_edges, size_t seed,
+                            NodeID max_parent = UNDEFINED_NODE) {
+    std::mt19937 eng(seed);
+    mutableGraphPtr G = std::make_shared<mutable_graph>();
+    G->start_construction(n);
+    NodeID half = n / 2;
+    for (NodeID v = 1; v < n; ++v) {
+        if (v == half) {
+            continue;
+        }
+        NodeID first = v < half ? 0 : half;
+        NodeID choices = std::min(v - first, max_parent);
+        G->new_edge_order(first + eng() % choices, v, 1 + eng() % 3);
+    }
+    for (NodeID i = 0; i < extra_edges; ++i) {
+        NodeID u = eng() % n;
+        NodeID v = eng() % n;
+        if ((u < half) == (v < half)) {
+            G->new_edge_order(u, v, 1);
+        }
+    }
+    G->finish_construction();
+    return G;
+}
+
+// number of vertices reachable from start, without vertex removed and the
+// edges between removed_u and removed_v
+NodeID reachable(mutableGraphPtr G, NodeID start, NodeID removed,
+                 NodeID removed_u, NodeID removed_v) {
+    std::vector<bool> visited(G->n(), false);
+    std::queue<NodeID> q;
+    visited[start] = true;
+    q.push(start);
+    NodeID count = 0;
+    while (!q.empty()) {
+        NodeID v = q.front();
+        q.pop();
+        ++count;
+        for (EdgeID e : G->edges_of(v)) {
+            NodeID t = G->getEdgeTarget(v, e);
+            bool removed_edge = (v == removed_u && t == removed_v)
+                                || (v == removed_v && t == removed_u);
+            if (!visited[t] && t != removed && !removed_edge) {
+                visited[t] = true;
+                q.push(t);
+            }
+        }
+    }
+    return count;
+}
+}  // namespace
+
+TEST(BiconnectivityTest, BridgesAndArticulationPoints) {
+    for (NodeID n : { 20, 200, 5000 }) {
+        for (size_t seed = 0; seed < 3; ++seed) {
+            mutableGraphPtr G = randomGraph(n, n / 10, seed);
+            parallel_biconnectivity<mutableGraphPtr> bcc(G, 4);
+            bcc.findAllBridges();
+            bcc.findAllArticulationPoints();
+
+            std::vector<std::pair<NodeID, NodeID> > bridges;
+            for (auto [v, e] : bcc.bridges()) {
+                NodeID t = G->getEdgeTarget(v, e);
+                bridges.emplace_back(std::min(v, t), std::max(v, t));
+            }
+            std::sort(bridges.begin(), bridges.end());
+
+            std::vector<std::pair<NodeID, NodeID> > expected_bridges;
+            for (NodeID v : G->nodes()) {
+                NodeID size = reachable(G, v, UNDEFINED_NODE,
+                                        UNDEFINED_NODE, UNDEFINED_NODE);
+                for (EdgeID e : G->edges_of(v)) {
+                    NodeID t = G->getEdgeTarget(v, e);
+                    size_t parallel_edges = 0;
+                    for (EdgeID f : G->edges_of(v)) {
+                        parallel_edges += (G->getEdgeTarget(v, f) == t);
+                    }
+                    if (v < t && parallel_edges == 1
+                        && reachable(G, v, UNDEFINED_NODE, v, t) < size) {
+                        expected_bridges.emplace_back(v, t);
+                    }
+                }
+            }
+            ASSERT_EQ(bridges, expected_bridges);
+
+            // roots are the first vertex of every component
+            std::vector<NodeID> aps = bcc.articulationPoints();
+            std::sort(aps.begin(), aps.end());
+            std::vector<NodeID> expected_aps;
+            for (NodeID v : G->nodes()) {
+                if (v == 0 || v == n / 2 || G->getUnweightedNodeDegree(v) < 2) {
+                    continue;
+                }
+                NodeID size = reachable(G, v, UNDEFINED_NODE,
+                                        UNDEFINED_NODE, UNDEFINED_NODE);
+                NodeID start = G->getEdgeTarget(v, 0);
+                if (reachable(G, start, v, UNDEFINED_NODE, UNDEFINED_NODE)
+                    < size - 1) {
+                    expected_aps.emplace_back(v);
+                }
+            }
+            ASSERT_EQ(aps, expected_aps);
+        }
+    }
+}
+
+TEST(BiconnectivityTest, SameContractionAsSequential) {
+    // the large graphs have BFS levels that are expanded in parallel
+    for (NodeID n : { 300, 20000 }) {
+        for (size_t seed = 0; seed < 5; ++seed) {
+            mutableGraphPtr G = randomGraph(n, n / 5, seed, 100);
+            std::mt19937 eng(seed);
+            std::vector<terminal> terminals;
+            for (NodeID i = 0; i < 3; ++i) {
+                terminals.emplace_back(eng() % (n / 2), i);
+            }
+
+            find_articulation_points find_aps(G);
+            parallel_biconnectivity<mutableGraphPtr> bcc(G, 4);
+            ASSERT_EQ(find_aps.findAllArticulationPoints(),
+                      bcc.findAllArticulationPoints());
+            auto expected = find_aps.terminalsOnBothSides(terminals);
+            auto uf = bcc.terminalsOnBothSidesOfArticulationPoints(terminals);
+            ASSERT_EQ(expected.has_value(), uf.has_value());
+            if (!uf.has_value()) {
+                continue;
+            }
+
+            // sets of both union finds are the same
+            std::vector<NodeID> set_of(n, UNDEFINED_NODE);
+            std::vector<NodeID> expected_set_of(n, UNDEFINED_NODE);
+            for (NodeID v : G->nodes()) {
+                NodeID s = uf->Find(v);
+                NodeID e = expected->Find(v);
+                if (set_of[e] == UNDEFINED_NODE) {
+                    set_of[e] = s;
+                    expected_set_of[s] = e;
+                }
+                ASSERT_EQ(set_of[e], s);
+                ASSERT_EQ(expected_set_of[s], e);
+            }
+            ASSERT_LT(uf->n(), n);
+        }
+    }
+}
+
+TEST(BiconnectivityTest, BridgeCut) {
+    // two cliques of size 10, connected by an edge of weight 2
+    NodeID size = 10;
+    graphAccessPtr G = std::make_shared<graph_access>();
+    G->start_construction(2 * size, 2 * size * (size - 1) + 2);
+    for (NodeID v = 0; v < 2 * size; ++v) {
+        G->new_node();
+        NodeID first = v < size ? 0 : size;
+        for (NodeID u = first; u < first + size; ++u) {
+            if (u != v) {
+                G->new_edge(v, u, 1);
+            }
+        }
+        if (v == 0) {
+            G->new_edge(0, size, 2);
+        }
+        if (v == size) {
+            G->new_edge(size, 0, 2);
+        }
+    }
+    G->finish_construction();
+
+    parallel_biconnectivity<graphAccessPtr> bcc(G, 4);
+    ASSERT_TRUE(bcc.findAllBridges());
+    ASSERT_EQ(bcc.bridgeCut(G->getMinDegree(), true), (EdgeWeight)2);
+    for (NodeID v : G->nodes()) {
+        ASSERT_EQ(G->getNodeInCut(v), v >= size);
+    }
+    ASSERT_EQ(bcc.bridgeCut(1, false), (EdgeWeight)1);
+}
+
+TEST(BiconnectivityTest, TerminalsOnBothSidesOfBridges) {
+    // cycle 0 - 1 - 2 - 3 - 0 without bridges, plus path 3 - 4 - 5 with two
+    // bridges once the edges to 4 are added
+    for (bool with_path : { false, true }) {
+        mutableGraphPtr G = std::make_shared<mutable_graph>();
+        G->start_construction(with_path ? 6 : 4);
+        G->new_edge_order(0, 1, 1);
+        G->new_edge_order(1, 2, 1);
+        G->new_edge_order(2, 3, 1);
+        G->new_edge_order(3, 0, 1);
+        if (with_path) {
+            G->new_edge_order(3, 4, 1);
+            G->new_edge_order(4, 5, 1);
+        }
+        G->finish_construction();
+        std::vector<terminal> terminals = { terminal(0, 0), terminal(2, 1) };
+
+        parallel_biconnectivity<mutableGraphPtr> bcc(G, 4);
+        ASSERT_EQ(bcc.findAllBridges(), with_path);
+        auto result = bcc.terminalsOnBothSidesOfBridges(terminals);
+        ASSERT_EQ(result.has_value(), with_path);
+        if (!with_path) {
+            continue;
+        }
+
+        // path has no terminals and is contracted into vertex 3
+        ASSERT_TRUE(std::holds_alternative<union_find>(*result));
+        union_find& uf = std::get<union_find>(*result);
+        ASSERT_EQ(uf.Find(4), uf.Find(3));
+        ASSERT_EQ(uf.Find(5), uf.Find(3));
+        ASSERT_NE(uf.Find(0), uf.Find(3));
+        ASSERT_NE(uf.Find(2), uf.Find(3));
+    }
+}
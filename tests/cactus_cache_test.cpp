@@ -0,0 +1,153 @@
+/******************************************************************************
+ * cactus_cache_test.cpp
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "algorithms/global_mincut/dynamic/cactus_cache.h"
+#include "common/definitions.h"
+#include "data_structure/mutable_graph.h"
+#include "gtest/gtest.h"
+
+static mutableGraphPtr makeCycle(NodeID n) {
+    mutableGraphPtr G = std::make_shared<mutable_graph>();
+    G->start_construction(n);
+    for (NodeID i = 0; i < n; ++i) {
+        G->new_edge(i, (i + 1) % n, 1);
+    }
+    G->finish_construction();
+    return G;
+}
+
+TEST(CactusCacheTest, InsertsMoveToNextCactus) {
+    cactus_cache cache(UNDEFINED_EDGE, 100, false);
+    ASSERT_EQ(cache.lowestCut(), UNDEFINED_EDGE);
+
+    auto G3 = makeCycle(3);
+    auto G5 = makeCycle(5);
+    cache.put(G5, 5);
+    cache.addEdge(0, 1, 1);
+    cache.put(G3, 3);
+    cache.addEdge(1, 2, 2);
+
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_EQ(cache.lowestCut(), 3);
+    ASSERT_EQ(cache.lowestInserts(), 1);
+    ASSERT_EQ(cache.lowestCactusVertices(), 3);
+
+    auto [cactus3, inserts3] = cache.takeLowest();
+    ASSERT_EQ(cactus3, G3);
+    ASSERT_EQ(inserts3.size(), 1);
+    ASSERT_EQ(inserts3[0], std::make_tuple(1, 2, 2));
+
+    // cactus for cut 5 needs the inserts of both caching periods
+    ASSERT_EQ(cache.lowestCut(), 5);
+    auto [cactus5, inserts5] = cache.takeLowest();
+    ASSERT_EQ(cactus5, G5);
+    ASSERT_EQ(inserts5.size(), 2);
+    ASSERT_TRUE(cache.empty());
+    ASSERT_EQ(cache.bytes(), 0);
+}
+
+TEST(CactusCacheTest, TooManyInsertsClearCache) {
+    cactus_cache cache(UNDEFINED_EDGE, 2, false);
+    cache.put(makeCycle(4), 4);
+    cache.put(makeCycle(3), 3);
+    for (NodeID i = 0; i < 3; ++i) {
+        cache.addEdge(0, i, 1);
+    }
+    ASSERT_FALSE(cache.empty());
+    cache.addEdge(0, 1, 1);
+    ASSERT_TRUE(cache.empty());
+}
+
+TEST(CactusCacheTest, EvictHighestCutOverBudget) {
+    auto G = makeCycle(10);
+    size_t bytes = G->memoryUsage();
+    cactus_cache cache(2 * bytes, 100, false);
+    cache.put(makeCycle(10), 7);
+    cache.put(makeCycle(10), 5);
+    ASSERT_EQ(cache.size(), 2);
+    cache.put(makeCycle(10), 6);
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_LE(cache.bytes(), 2 * bytes);
+
+    ASSERT_EQ(std::get<0>(cache.takeLowest())->n(), 10);
+    ASSERT_EQ(cache.lowestCut(), 6);
+}
+
+TEST(CactusCacheTest, CompactStorage) {
+    auto G = makeCycle(20);
+    G->contractEdge(0, 0);
+    cactus_cache cache(UNDEFINED_EDGE, 100, true);
+    cache.put(G, 2);
+    ASSERT_LT(cache.bytes(), G->memoryUsage());
+
+    auto [cactus, inserts] = cache.takeLowest();
+    ASSERT_NE(cactus, G);
+    ASSERT_TRUE(inserts.empty());
+    ASSERT_EQ(cactus->n(), G->n());
+    ASSERT_EQ(cactus->m(), G->m());
+    for (NodeID n = 0; n < G->getOriginalNodes(); ++n) {
+        ASSERT_EQ(cactus->getCurrentPosition(n), G->getCurrentPosition(n));
+    }
+}
+
+TEST(CactusCacheTest, SerializeRoundTrip) {
+    for (bool compact : { false, true }) {
+        cactus_cache cache(UNDEFINED_EDGE, 100, compact);
+        cache.put(makeCycle(5), 5);
+        cache.addEdge(0, 1, 1);
+        cache.put(makeCycle(3), 3);
+        cache.addEdge(1, 2, 2);
+
+        std::vector<uint64_t> serial;
+        cache.serialize(&serial);
+        cactus_cache restored(UNDEFINED_EDGE, 100, compact);
+        ASSERT_EQ(restored.deserialize(serial.data(), serial.size()),
+                  serial.size());
+        ASSERT_EQ(restored.size(), 2);
+        ASSERT_EQ(restored.bytes(), cache.bytes());
+        ASSERT_EQ(restored.lowestCut(), 3);
+        ASSERT_EQ(restored.lowestCactusVertices(), 3);
+
+        auto [cactus3, inserts3] = restored.takeLowest();
+        ASSERT_EQ(cactus3->n(), 3);
+        ASSERT_EQ(inserts3.size(), 1);
+        ASSERT_EQ(inserts3[0], std::make_tuple(1, 2, 2));
+        auto [cactus5, inserts5] = restored.takeLowest();
+        ASSERT_EQ(cactus5->n(), 5);
+        ASSERT_EQ(inserts5.size(), 2);
+    }
+}
+
+TEST(CactusCacheTest, DeserializeTruncated) {
+    for (bool compact : { false, true }) {
+        cactus_cache cache(UNDEFINED_EDGE, 100, compact);
+        cache.put(makeCycle(5), 5);
+        cache.addEdge(0, 1, 1);
+        cache.put(makeCycle(3), 3);
+        cache.addEdge(1, 2, 2);
+
+        std::vector<uint64_t> serial;
+        cache.serialize(&serial);
+        for (size_t length = 0; length < serial.size(); ++length) {
+            // copy, so that reads past the end are found by sanitizers
+            std::vector<uint64_t> prefix(serial.begin(),
+                                         serial.begin() + length);
+            cactus_cache restored(UNDEFINED_EDGE, 100, compact);
+            ASSERT_EQ(restored.deserialize(prefix.data(), prefix.size()), 0);
+            ASSERT_TRUE(restored.empty());
+            ASSERT_EQ(restored.bytes(), 0);
+        }
+    }
+}
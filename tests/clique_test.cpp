@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "algorithms/misc/maximal_clique.h"
+#include "common/configuration.h"
 #include "common/definitions.h"
 #include "data_structure/mutable_graph.h"
 #include "gtest/gtest_pred_impl.h"
@@ -99,3 +100,29 @@ TEST(CliqueTest, CliqueWithTriangleEars) {
         ASSERT_GE(c.size(), 3);
     }
 }
+
+TEST(CliqueTest, SortedAdjacency) {
+    mutableGraphPtr G = std::make_shared<mutable_graph>();
+
+    G->start_construction(16);
+
+    for (NodeID k = 0; k < 4; ++k) {
+        for (NodeID i = 0; i < 4; ++i) {
+            for (NodeID j = i + 1; j < 4; ++j) {
+                G->new_edge((4 * k) + i, (4 * k) + j);
+            }
+        }
+        G->new_edge(4 * k, (4 * k + 4) % 16);
+    }
+
+    G->finish_construction();
+
+    configuration::getConfig()->sorted_adjacency = true;
+    maximal_clique mc;
+    auto r = mc.findCliques(G);
+    configuration::getConfig()->sorted_adjacency = false;
+
+    maximal_clique mc_unsorted;
+    ASSERT_EQ(r, mc_unsorted.findCliques(G));
+    ASSERT_GE(r.size(), 4);
+}
@@ -0,0 +1,110 @@
+/******************************************************************************
+ * connected_components_test.cpp
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#include <omp.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "algorithms/misc/connected_components.h"
+#include "common/definitions.h"
+#include "data_structure/graph_access.h"
+#include "data_structure/mutable_graph.h"
+#include "gtest/gtest.h"
+#include "io/graph_io.h"
+
+TEST(ConnectedComponentsTest, SingleComponent) {
+    auto G = graph_io::readGraphWeighted(std::string(VIECUT_PATH)
+                                         + "/graphs/small.metis");
+    auto [components, num_comp, blocksizes] =
+        connected_components::components(G);
+
+    ASSERT_EQ(num_comp, 1);
+    ASSERT_EQ(blocksizes.size(), 1);
+    ASSERT_EQ(blocksizes[0], G->number_of_nodes());
+    for (NodeID n : G->nodes()) {
+        ASSERT_EQ(components[n], 0);
+    }
+}
+
+TEST(ConnectedComponentsTest, PathsAndIsolatedVertices) {
+#ifdef PARALLEL
+    omp_set_num_threads(4);
+#endif
+    // every third vertex is isolated, the others are paired to the vertex
+    // 3 * num_pairs positions later, giving components {i, i + offset}
+    NodeID num_pairs = 500;
+    NodeID offset = 3 * num_pairs;
+    mutableGraphPtr G = std::make_shared<mutable_graph>();
+    G->start_construction(2 * offset);
+    for (NodeID i = 0; i < offset; ++i) {
+        if (i % 3 != 0) {
+            G->new_edge(i, i + offset, 1);
+        }
+    }
+    G->finish_construction();
+
+    auto [components, num_comp, blocksizes] =
+        connected_components::components(G);
+
+    ASSERT_EQ(num_comp, offset + num_pairs);
+    ASSERT_EQ(blocksizes.size(), num_comp);
+
+    size_t sum = 0;
+    for (size_t b : blocksizes) {
+        sum += b;
+    }
+    ASSERT_EQ(sum, G->n());
+
+    for (NodeID i = 0; i < offset; ++i) {
+        if (i % 3 != 0) {
+            ASSERT_EQ(components[i], components[i + offset]);
+            ASSERT_EQ(blocksizes[components[i]], 2);
+        } else {
+            ASSERT_NE(components[i], components[i + offset]);
+            ASSERT_EQ(blocksizes[components[i]], 1);
+        }
+    }
+
+    // component ids are ordered by their smallest vertex
+    for (NodeID i = 1; i < offset; ++i) {
+        ASSERT_EQ(components[i], components[i - 1] + 1);
+    }
+}
+
+TEST(ConnectedComponentsTest, LargestComponent) {
+#ifdef PARALLEL
+    omp_set_num_threads(4);
+#endif
+    // a long path on the even vertices and isolated edges between odd ones
+    NodeID n = 10000;
+    mutableGraphPtr mG = std::make_shared<mutable_graph>();
+    mG->start_construction(n);
+    for (NodeID i = 0; i + 2 < n; i += 2) {
+        mG->new_edge(i, i + 2, 1);
+    }
+    for (NodeID i = 1; i + 2 < n; i += 4) {
+        mG->new_edge(i, i + 2, 1);
+    }
+    mG->finish_construction();
+    auto G = mG->to_graph_access();
+
+    auto [components, num_comp, blocksizes] =
+        connected_components::components(G);
+    ASSERT_EQ(num_comp, 1 + (n / 4));
+    ASSERT_EQ(blocksizes[0], n / 2);
+
+    auto largest = connected_components::largest_cc(G);
+    ASSERT_EQ(largest->number_of_nodes(), n / 2);
+    ASSERT_EQ(largest->number_of_edges(), n - 2);
+}
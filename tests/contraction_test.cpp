@@ -13,7 +13,9 @@
 
 #include <algorithm>
 #include <memory>
+#include <random>
 #include <string>
+#include <utility>
 #include <vector>
 
 #ifdef PARALLEL
@@ -21,6 +23,7 @@
 #else
 #include "coarsening/contract_graph.h"
 #endif
+#include "common/configuration.h"
 #include "common/definitions.h"
 #include "data_structure/graph_access.h"
 #include "gtest/gtest_pred_impl.h"
@@ -88,3 +91,65 @@ TEST(ContractionTest, ContrBlock) {
         }
     }
 }
+
+#ifdef PARALLEL
+TEST(ContractionTest, NumaSameAsDefault) {
+    // in NUMA mode, the edge array of the contracted graph is first touched
+    // by all threads, which must not change the contracted graph
+    omp_set_num_threads(4);
+    std::mt19937 eng(0);
+    NodeID n = 5000;
+    graphAccessPtr G = std::make_shared<graph_access>();
+    std::vector<std::vector<std::pair<NodeID, EdgeWeight> > > adj(n);
+    for (NodeID i = 0; i < 5 * n; ++i) {
+        NodeID u = eng() % n;
+        NodeID v = eng() % n;
+        if (u != v) {
+            EdgeWeight w = 1 + eng() % 10;
+            adj[u].emplace_back(v, w);
+            adj[v].emplace_back(u, w);
+        }
+    }
+    G->start_construction(n, 10 * n);
+    for (NodeID u = 0; u < n; ++u) {
+        G->new_node();
+        for (auto [v, w] : adj[u]) {
+            G->new_edge(u, v, w);
+        }
+    }
+    G->finish_construction();
+
+    std::vector<NodeID> mapping;
+    std::vector<std::vector<NodeID> > reverse_mapping(n / 8);
+    for (NodeID v : G->nodes()) {
+        mapping.push_back(eng() % (n / 8));
+        reverse_mapping[mapping.back()].emplace_back(v);
+    }
+
+    auto sortedEdges = [](graphAccessPtr C) {
+        std::vector<std::vector<std::pair<NodeID, EdgeWeight> > > edges(
+            C->number_of_nodes());
+        for (NodeID v : C->nodes()) {
+            for (EdgeID e : C->edges_of(v)) {
+                edges[v].emplace_back(C->getEdgeTarget(e),
+                                      C->getEdgeWeight(e));
+            }
+            std::sort(edges[v].begin(), edges[v].end());
+        }
+        return edges;
+    };
+
+    auto cfg = configuration::getConfig();
+    cfg->numa = false;
+    graphAccessPtr expected = contraction::contractGraph(
+        G, mapping, reverse_mapping);
+    cfg->numa = true;
+    graphAccessPtr numa = contraction::contractGraph(
+        G, mapping, reverse_mapping);
+    cfg->numa = false;
+
+    ASSERT_EQ(numa->number_of_nodes(), expected->number_of_nodes());
+    ASSERT_EQ(numa->number_of_edges(), expected->number_of_edges());
+    ASSERT_EQ(sortedEdges(numa), sortedEdges(expected));
+}
+#endif
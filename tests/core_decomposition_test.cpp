@@ -9,10 +9,18 @@
  * Published under the MIT license in the LICENSE file.
  *****************************************************************************/
 
+#include <omp.h>
+
 #include <algorithm>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "algorithms/misc/core_decomposition.h"
 #include "data_structure/graph_access.h"
+#include "data_structure/mutable_graph.h"
 #include "gtest/gtest.h"
 #include "io/graph_io.h"
 
@@ -97,3 +105,65 @@ TEST(CoreDecompositionTest, CreateCoreGraph) {
                   std::min<EdgeID>(8, 10 - (2 * k)));
     }
 }
+
+TEST(CoreDecompositionTest, ParallelPeelingEqualsBZ) {
+#ifdef PARALLEL
+    omp_set_num_threads(4);
+#endif
+    // random graph where vertex i has edges to up to i / 10 random
+    // smaller vertices, giving a wide range of core numbers
+    mutableGraphPtr mG = std::make_shared<mutable_graph>();
+    mG->start_construction(1000);
+    std::mt19937 mt(1);
+    for (NodeID i = 1; i < 1000; ++i) {
+        std::set<NodeID> nbrs;
+        for (NodeID j = 0; j < i / 10; ++j) {
+            nbrs.insert(std::uniform_int_distribution<NodeID>(0, i - 1)(mt));
+        }
+        for (NodeID nbr : nbrs) {
+            mG->new_edge(i, nbr, 1);
+        }
+    }
+    mG->finish_construction();
+
+    std::vector<graphAccessPtr> graphs = {
+        graph_io::readGraphWeighted(std::string(VIECUT_PATH)
+                                    + "/graphs/small.metis"),
+        mG->to_graph_access(), make_G2()
+    };
+
+    for (auto G : graphs) {
+        k_cores bz = core_decomposition::batagelj_zaversnik(G);
+        k_cores peel = core_decomposition::parallel_peeling(G);
+
+        ASSERT_EQ(peel.buckets, bz.buckets);
+        ASSERT_EQ(peel.degrees, bz.degrees);
+        for (NodeID n : G->nodes()) {
+            ASSERT_EQ(peel.vertices[peel.position[n]], n);
+            if (peel.position[n] > 0) {
+                NodeID prev = peel.vertices[peel.position[n] - 1];
+                ASSERT_LE(peel.degrees[prev], peel.degrees[n]);
+            }
+        }
+    }
+}
+
+TEST(CoreDecompositionTest, ParallelPeelingCoreGraph) {
+#ifdef PARALLEL
+    omp_set_num_threads(4);
+#endif
+    auto G = make_G2();
+    k_cores kCores = core_decomposition::parallel_peeling(G);
+
+    std::vector<NodeID> target_buckets = { 0, 1, 2, 5 };
+    std::vector<NodeID> target_degrees = { 2, 2, 2, 1, 0 };
+    ASSERT_EQ(kCores.buckets, target_buckets);
+    ASSERT_EQ(kCores.degrees, target_degrees);
+
+    for (size_t k : { 0, 1, 2 }) {
+        auto new_graph = core_decomposition::createCoreGraph(kCores, k, G);
+        ASSERT_EQ(new_graph->number_of_nodes(), std::min<EdgeID>(4, 5 - k));
+        ASSERT_EQ(new_graph->number_of_edges(),
+                  std::min<EdgeID>(8, 10 - (2 * k)));
+    }
+}
@@ -0,0 +1,195 @@
+/******************************************************************************
+ * dynamic_mincut_test.cpp
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "algorithms/global_mincut/dynamic/dynamic_mincut.h"
+#include "common/configuration.h"
+#include "common/definitions.h"
+#include "data_structure/mutable_graph.h"
+#include "gtest/gtest.h"
+#include "io/graph_io.h"
+#include "tools/random_functions.h"
+
+TEST(DynamicMincutTest, CheckpointRoundTrip) {
+    configuration::getConfig()->save_cut = true;
+    random_functions::setSeed(1);
+    auto G = graph_io::readGraphWeighted<mutable_graph>(
+        std::string(VIECUT_PATH) + "/graphs/small.metis");
+
+    std::vector<std::tuple<NodeID, NodeID, bool> > updates;
+    for (size_t i = 0; i < 40; ++i) {
+        NodeID s = random_functions::nextInt(0, G->n() - 1);
+        NodeID t = random_functions::nextInt(0, G->n() - 1);
+        updates.emplace_back(s, t, i % 3 != 2);
+    }
+
+    auto apply = [](dynamic_mincut* dynmc, auto update) {
+        auto [s, t, insert] = update;
+        if (s == t)
+            return dynmc->getCurrentCut();
+        return insert ? dynmc->addEdge(s, t, 1) : dynmc->removeEdge(s, t);
+    };
+
+    dynamic_mincut dynmc;
+    dynmc.initialize(G);
+    for (size_t i = 0; i < 20; ++i) {
+        apply(&dynmc, updates[i]);
+    }
+
+    std::string path = "dynamic_mincut_test_checkpoint.bin";
+    dynmc.saveCheckpoint(path, 20);
+    dynamic_mincut restored;
+    ASSERT_EQ(restored.loadCheckpoint(path), 20);
+    std::remove(path.c_str());
+
+    ASSERT_EQ(restored.getCurrentCut(), dynmc.getCurrentCut());
+    ASSERT_EQ(restored.getCurrentCactus()->n(), dynmc.getCurrentCactus()->n());
+    ASSERT_EQ(restored.getOriginalGraph()->m(), dynmc.getOriginalGraph()->m());
+    for (NodeID n = 0; n < G->n(); ++n) {
+        ASSERT_EQ(restored.getCurrentCactus()->getCurrentPosition(n),
+                  dynmc.getCurrentCactus()->getCurrentPosition(n));
+    }
+
+    // both instances continue with the same random state
+    std::vector<EdgeWeight> cuts;
+    random_functions::setSeed(15);
+    for (size_t i = 20; i < updates.size(); ++i) {
+        cuts.emplace_back(apply(&dynmc, updates[i]));
+    }
+    random_functions::setSeed(15);
+    for (size_t i = 20; i < updates.size(); ++i) {
+        ASSERT_EQ(apply(&restored, updates[i]), cuts[i - 20]);
+    }
+}
+
+TEST(DynamicMincutTest, CheckpointOfEmptyStartGraph) {
+    // as in the app without initial graph, the sparse graph has vertex ids
+    // larger than its number of edges
+    configuration::getConfig()->save_cut = true;
+    mutableGraphPtr G = std::make_shared<mutable_graph>();
+    G->start_construction(100);
+    G->finish_construction();
+
+    dynamic_mincut dynmc;
+    dynmc.initialize(G);
+    std::string path = "dynamic_mincut_test_empty_checkpoint.bin";
+    std::vector<std::pair<NodeID, NodeID> > edges = { { 0, 50 }, { 1, 2 } };
+    for (size_t i = 0; i <= edges.size(); ++i) {
+        dynmc.saveCheckpoint(path, i);
+        dynamic_mincut restored;
+        ASSERT_EQ(restored.loadCheckpoint(path), i);
+        ASSERT_EQ(restored.getOriginalGraph()->n(), 100);
+        ASSERT_EQ(restored.getOriginalGraph()->m(), 2 * i);
+        ASSERT_EQ(restored.getCurrentCut(), dynmc.getCurrentCut());
+        ASSERT_EQ(restored.getCurrentCactus()->n(),
+                  dynmc.getCurrentCactus()->n());
+        if (i < edges.size()) {
+            dynmc.addEdge(edges[i].first, edges[i].second, 1);
+        }
+    }
+    std::remove(path.c_str());
+}
+
+TEST(DynamicMincutTest, CheckpointWriteFailure) {
+    configuration::getConfig()->save_cut = true;
+    auto G = graph_io::readGraphWeighted<mutable_graph>(
+        std::string(VIECUT_PATH) + "/graphs/small.metis");
+    dynamic_mincut dynmc;
+    dynmc.initialize(G);
+    // every write to /dev/full fails as if the disk was full
+    ASSERT_EXIT(dynmc.saveCheckpoint("/dev/full", 0),
+                ::testing::ExitedWithCode(1), "");
+}
+
+TEST(DynamicMincutTest, SnapshotsDuringUpdates) {
+    configuration::getConfig()->save_cut = true;
+    configuration::getConfig()->cactus_snapshots = true;
+    random_functions::setSeed(1);
+    auto G = graph_io::readGraphWeighted<mutable_graph>(
+        std::string(VIECUT_PATH) + "/graphs/small.metis");
+    NodeID n = G->n();
+
+    dynamic_mincut dynmc;
+    dynmc.initialize(G);
+
+    // reader checks that every snapshot it sees is consistent
+    std::atomic<bool> done = false;
+    size_t inconsistent = 0;
+    std::thread reader([&]() {
+        uint64_t last_version = 0;
+        std::mt19937 eng(0);
+        while (!done) {
+            cactusSnapshotPtr snap = dynmc.getSnapshot();
+            if (snap->version() < last_version)
+                inconsistent++;
+            last_version = snap->version();
+            NodeID vertices = snap->numCactusVertices();
+            for (size_t i = 0; i < n; ++i) {
+                NodeID u = eng() % n;
+                NodeID v = eng() % n;
+                if (snap->cactusVertex(u) >= vertices
+                    || snap->sameSide(u, v)
+                    != (snap->cactusVertex(u) == snap->cactusVertex(v)))
+                    inconsistent++;
+            }
+            // cactus edges are tree edges with the weight of a minimum cut
+            // or cycle edges with half of it, and every cactus vertex is
+            // one side of a minimum cut
+            EdgeWeight cut = snap->cutValue();
+            std::vector<EdgeWeight> degree(vertices, 0);
+            for (auto [s, t, w] : snap->cutEdges()) {
+                if (s >= vertices || t >= vertices
+                    || (w != cut && 2 * w != cut)) {
+                    inconsistent++;
+                } else {
+                    degree[s] += w;
+                    degree[t] += w;
+                }
+            }
+            for (NodeID c = 0; vertices > 1 && c < vertices; ++c) {
+                if (degree[c] < cut)
+                    inconsistent++;
+            }
+        }
+    });
+
+    for (size_t i = 0; i < 40; ++i) {
+        NodeID s = random_functions::nextInt(0, n - 1);
+        NodeID t = random_functions::nextInt(0, n - 1);
+        if (s == t)
+            continue;
+        EdgeWeight cut = (i % 3 == 2) ? dynmc.removeEdge(s, t)
+                         : dynmc.addEdge(s, t, 1);
+
+        cactusSnapshotPtr snap = dynmc.getSnapshot();
+        mutableGraphPtr cactus = dynmc.getCurrentCactus();
+        ASSERT_EQ(snap->cutValue(), cut);
+        ASSERT_EQ(snap->numCactusVertices(), cactus->n());
+        ASSERT_EQ(snap->cutEdges().size(), cactus->m() / 2);
+        for (NodeID v = 0; v < n; ++v) {
+            ASSERT_EQ(snap->sameSide(s, v), cactus->getCurrentPosition(s)
+                      == cactus->getCurrentPosition(v));
+        }
+    }
+    done = true;
+    reader.join();
+    ASSERT_EQ(inconsistent, 0);
+    configuration::getConfig()->cactus_snapshots = false;
+}
@@ -0,0 +1,104 @@
+/******************************************************************************
+ * label_propagation_test.cpp
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#include <omp.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#ifdef PARALLEL
+#include "parallel/coarsening/label_propagation.h"
+#else
+#include "coarsening/label_propagation.h"
+#endif
+#include "common/configuration.h"
+#include "common/definitions.h"
+#include "data_structure/graph_access.h"
+#include "data_structure/sparse_accumulator.h"
+#include "gtest/gtest.h"
+#include "io/graph_io.h"
+#include "tools/random_functions.h"
+
+namespace {
+const std::vector<std::string> graphs = { "", "-wgt", "-wgt2" };
+
+// a full sweep over all vertices would not change any label, i.e. every
+// vertex is connected at least as strongly to its own cluster as to any
+// other adjacent cluster
+bool isFixedPoint(graphAccessPtr G, const std::vector<NodeID>& cluster) {
+    sparse_accumulator connection;
+    for (NodeID n : G->nodes()) {
+        connection.reset(G->getUnweightedNodeDegree(n));
+        for (EdgeID e : G->edges_of(n)) {
+            connection.add(cluster[G->getEdgeTarget(n, e)],
+                           G->getEdgeWeight(n, e));
+        }
+        EdgeWeight max_value = 0;
+        connection.forEach([&max_value](NodeID, EdgeWeight sum) {
+                               max_value = std::max(max_value, sum);
+                           });
+        if (connection.get(cluster[n]) != max_value) {
+            return false;
+        }
+    }
+    return true;
+}
+}  // namespace
+
+TEST(LabelPropagationTest, ActiveSetConverges) {
+#ifdef PARALLEL
+    omp_set_num_threads(4);
+#endif
+    auto cfg = configuration::getConfig();
+    size_t iterations = cfg->lp_iterations;
+    double convergence = cfg->lp_convergence;
+    cfg->lp_iterations = 1000;
+    cfg->lp_convergence = 0;
+    for (std::string graph : graphs) {
+        graphAccessPtr G = graph_io::readGraphWeighted(
+            std::string(VIECUT_PATH) + "/graphs/small" + graph + ".metis");
+        for (size_t seed = 0; seed < 5; ++seed) {
+            random_functions::setSeed(seed);
+            label_propagation<graphAccessPtr> lp;
+            std::vector<NodeID> cluster = lp.propagate_labels(G);
+            ASSERT_EQ(cluster.size(), G->number_of_nodes());
+            for (NodeID n : G->nodes()) {
+                ASSERT_LT(cluster[n], G->number_of_nodes());
+            }
+            ASSERT_TRUE(isFixedPoint(G, cluster));
+        }
+    }
+    cfg->lp_iterations = iterations;
+    cfg->lp_convergence = convergence;
+}
+
+TEST(LabelPropagationTest, ClusterSizeLimit) {
+#ifdef PARALLEL
+    omp_set_num_threads(4);
+#endif
+    auto cfg = configuration::getConfig();
+    size_t cluster_size = cfg->lp_cluster_size;
+    for (NodeID limit : { 1, 2, 3 }) {
+        cfg->lp_cluster_size = limit;
+        for (std::string graph : graphs) {
+            graphAccessPtr G = graph_io::readGraphWeighted(
+                std::string(VIECUT_PATH) + "/graphs/small" + graph + ".metis");
+            label_propagation<graphAccessPtr> lp;
+            std::vector<NodeID> cluster = lp.propagate_labels(G);
+            std::vector<NodeID> size(G->number_of_nodes(), 0);
+            for (NodeID n : G->nodes()) {
+                ASSERT_LE(++size[cluster[n]], limit);
+            }
+        }
+    }
+    cfg->lp_cluster_size = cluster_size;
+}
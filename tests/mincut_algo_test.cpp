@@ -9,9 +9,15 @@
  * Published under the MIT license in the LICENSE file.
  *****************************************************************************/
 
+#include <omp.h>
+
+#include <memory>
 #include <string>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "algorithms/global_mincut/approximate_mincut.h"
 #ifdef PARALLEL
 #include "algorithms/global_mincut/viecut.h"
 #include "parallel/algorithm/exact_parallel_minimum_cut.h"
@@ -25,10 +31,15 @@
 #include "algorithms/global_mincut/stoer_wagner_minimum_cut.h"
 #include "algorithms/global_mincut/viecut.h"
 #endif
+#include "common/configuration.h"
 #include "common/definitions.h"
+#include "data_structure/graph_access.h"
 #include "gtest/gtest_pred_impl.h"
 #include "io/graph_io.h"
+#include "tools/random_functions.h"
 
+template <class GraphPtr>
+class approximate_mincut;
 template <class GraphPtr>
 class exact_parallel_minimum_cut;
 template <class GraphPtr>
@@ -52,9 +63,11 @@ class MincutAlgoTest : public testing::Test { };
 typedef testing::Types<viecut<graphAccessPtr>,
                        exact_parallel_minimum_cut<graphAccessPtr>,
                        parallel_cactus<graphAccessPtr>,
+                       approximate_mincut<graphAccessPtr>,
                        viecut<mutableGraphPtr>,
                        exact_parallel_minimum_cut<mutableGraphPtr>,
-                       parallel_cactus<mutableGraphPtr> >
+                       parallel_cactus<mutableGraphPtr>,
+                       approximate_mincut<mutableGraphPtr> >
     MCAlgTypes;
 #else
 typedef testing::Types<viecut<graphAccessPtr>,
@@ -63,11 +76,13 @@ typedef testing::Types<viecut<graphAccessPtr>,
                        matula_approx<graphAccessPtr>,
                        ks_minimum_cut,
                        cactus_mincut<graphAccessPtr>,
+                       approximate_mincut<graphAccessPtr>,
                        viecut<mutableGraphPtr>,
                        noi_minimum_cut<mutableGraphPtr>,
                        padberg_rinaldi<mutableGraphPtr>,
                        matula_approx<mutableGraphPtr>,
-                       cactus_mincut<mutableGraphPtr> >
+                       cactus_mincut<mutableGraphPtr>,
+                       approximate_mincut<mutableGraphPtr> >
     MCAlgTypes;
 #endif
 
@@ -132,3 +147,177 @@ TYPED_TEST(MincutAlgoTest, WeightedGraphFromFile) {
         ASSERT_GE(cut, 3);
     }
 }
+
+TYPED_TEST(MincutAlgoTest, ThresholdFromFile) {
+    // mutable graphs are contracted in place, read a new graph for every run
+    auto readGraph = []() {
+        return graph_io::readGraphWeighted<
+            typename TypeParam::GraphPtrType::element_type>(
+            std::string(VIECUT_PATH) + "/graphs/small.metis");
+    };
+    TypeParam mc;
+
+    // minimum cut is 2, thus graph is 1- and 2-edge-connected
+    ASSERT_EQ(mc.perform_minimum_cut_threshold(readGraph(), 1), 1);
+    ASSERT_EQ(mc.perform_minimum_cut_threshold(readGraph(), 2), 2);
+    EdgeWeight cut = mc.perform_minimum_cut_threshold(readGraph(), 3);
+
+#ifdef PARALLEL
+    if (std::is_same<TypeParam,
+                     exact_parallel_minimum_cut<graphAccessPtr> >::value ||
+        std::is_same<TypeParam,
+                     exact_parallel_minimum_cut<mutableGraphPtr> >::value) {
+#else
+    if (std::is_same<TypeParam, noi_minimum_cut<graphAccessPtr> >::value ||
+        std::is_same<TypeParam, noi_minimum_cut<mutableGraphPtr> >::value) {
+#endif
+        ASSERT_EQ(cut, 2);
+    } else {
+        ASSERT_LE(cut, 3);
+        ASSERT_GE(cut, 2);
+    }
+}
+
+TYPED_TEST(MincutAlgoTest, SortedAdjacency) {
+    // triangle tests intersect sorted adjacency lists
+    auto cfg = configuration::getConfig();
+    cfg->sorted_adjacency = true;
+    for (auto [file, mincut] : { std::make_pair("small.metis", 2),
+                                 std::make_pair("small-wgt.metis", 3) }) {
+        typename TypeParam::GraphPtrType G =
+            graph_io::readGraphWeighted<
+                typename TypeParam::GraphPtrType::element_type>(
+                std::string(VIECUT_PATH) + "/graphs/" + file);
+        TypeParam mc;
+        EdgeWeight cut = mc.perform_minimum_cut(G);
+#ifdef PARALLEL
+        if (std::is_same<TypeParam,
+                         exact_parallel_minimum_cut<graphAccessPtr> >::value ||
+            std::is_same<TypeParam,
+                         exact_parallel_minimum_cut<mutableGraphPtr> >::value) {
+#else
+        if (std::is_same<TypeParam, noi_minimum_cut<graphAccessPtr> >::value ||
+            std::is_same<TypeParam, noi_minimum_cut<mutableGraphPtr> >::value) {
+#endif
+            ASSERT_EQ(cut, mincut);
+        } else {
+            ASSERT_GE(cut, mincut);
+        }
+    }
+    cfg->sorted_adjacency = false;
+}
+
+TEST(ApproximateMincutTest, DenseGraph) {
+    // two dense random halves with few edges between them, thus the minimum
+    // cut is far above log n and below the minimum degree. The approximate
+    // algorithm samples a skeleton instead of solving exactly for all
+    // epsilon below.
+    auto cfg = configuration::getConfig();
+    for (size_t seed = 3; seed < 6; ++seed) {
+        random_functions::setSeed(seed);
+        NodeID n = 300;
+        graphAccessPtr G = std::make_shared<graph_access>();
+        G->start_construction(n, n * n);
+        std::vector<std::vector<EdgeWeight> > weights(
+            n, std::vector<EdgeWeight>(n));
+        for (NodeID u = 0; u < n; ++u) {
+            for (NodeID v = u + 1; v < n; ++v) {
+                double density = ((u < n / 2) == (v < n / 2)) ? 0.5 : 0.003;
+                if (random_functions::nextDouble(0, 1) < density) {
+                    weights[u][v] = weights[v][u] =
+                                        random_functions::nextInt(1, 100);
+                }
+            }
+        }
+        for (NodeID u = 0; u < n; ++u) {
+            G->new_node();
+            for (NodeID v = 0; v < n; ++v) {
+                if (weights[u][v] > 0) {
+                    G->new_edge(u, v, weights[u][v]);
+                }
+            }
+        }
+        G->finish_construction();
+
+#ifdef PARALLEL
+        exact_parallel_minimum_cut<graphAccessPtr> exact;
+#else
+        noi_minimum_cut<graphAccessPtr> exact;
+#endif
+        EdgeWeight mincut = exact.perform_minimum_cut(G);
+
+        for (double epsilon : { 0.3, 0.5, 0.9 }) {
+            cfg->approximation_epsilon = epsilon;
+            cfg->save_cut = true;
+            cfg->seed = seed;
+            approximate_mincut<graphAccessPtr> approx;
+            EdgeWeight cut = approx.perform_minimum_cut(G);
+            ASSERT_GE(cut, mincut);
+            ASSERT_LE(cut, (1.0 + epsilon) * mincut);
+
+            // returned cut is the cut given by the vertices in the cut
+            EdgeWeight sides = 0;
+            for (NodeID u : G->nodes()) {
+                for (EdgeID e : G->edges_of(u)) {
+                    if (G->getNodeInCut(u)
+                        != G->getNodeInCut(G->getEdgeTarget(e)))
+                        sides += G->getEdgeWeight(e);
+                }
+            }
+            ASSERT_EQ(sides / 2, cut);
+        }
+    }
+    cfg->approximation_epsilon = 0.1;
+    cfg->save_cut = false;
+    cfg->seed = 0;
+}
+
+#ifdef PARALLEL
+TEST(PartitionedCapforestTest, DeterministicContraction) {
+    // the contraction of the partitioned capforest only depends on the seed
+    // and the number of threads, not on the schedule
+    random_functions::setSeed(7);
+    NodeID n = 2000;
+    std::vector<std::vector<std::pair<NodeID, EdgeWeight> > > adj(n);
+    for (NodeID u = 0; u < n; ++u) {
+        for (NodeID i = 1; i <= 4; ++i) {
+            NodeID v = (random_functions::nextDouble(0, 1) < 0.8)
+                       ? (u + i) % n : random_functions::nextInt(0, n - 1);
+            if (u != v) {
+                EdgeWeight w = random_functions::nextInt(1, 5);
+                adj[u].emplace_back(v, w);
+                adj[v].emplace_back(u, w);
+            }
+        }
+    }
+    graphAccessPtr G = std::make_shared<graph_access>();
+    G->start_construction(n, 16 * n);
+    for (NodeID u = 0; u < n; ++u) {
+        G->new_node();
+        for (auto [v, w] : adj[u]) {
+            G->new_edge(u, v, w);
+        }
+    }
+    G->finish_construction();
+
+    int threads = omp_get_max_threads();
+    omp_set_num_threads(4);
+    exact_parallel_minimum_cut<graphAccessPtr> mc;
+    std::vector<std::vector<NodeID> > smallest(2, std::vector<NodeID>(n));
+    for (size_t run = 0; run < 2; ++run) {
+        random_functions::setSeed(11);
+        auto uf = mc.partitioned_capforest(G, G->getMinDegree());
+        ASSERT_LT(uf.n(), n);
+        std::vector<NodeID> smallest_in_set(n, n);
+        for (NodeID v = 0; v < n; ++v) {
+            NodeID root = uf.Find(v);
+            smallest_in_set[root] = std::min(smallest_in_set[root], v);
+        }
+        for (NodeID v = 0; v < n; ++v) {
+            smallest[run][v] = smallest_in_set[uf.Find(v)];
+        }
+    }
+    omp_set_num_threads(threads);
+    ASSERT_EQ(smallest[0], smallest[1]);
+}
+#endif
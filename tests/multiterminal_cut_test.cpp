@@ -10,14 +10,23 @@
  *****************************************************************************/
 
 #include <mpi.h>
+#include <omp.h>
 #include <stddef.h>
 
 #include <algorithm>
 #include <memory>
 #include <random>
+#include <string>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include "algorithms/misc/equal_neighborhood.h"
+#include "algorithms/multicut/multilevel_multicut.h"
 #include "algorithms/multicut/multiterminal_cut.h"
+#include "algorithms/multicut/problem_queues/per_thread_problem_queue.h"
+#include "algorithms/multicut/problem_queues/problem_spill_file.h"
+#include "algorithms/multicut/transposition_table.h"
 #include "common/configuration.h"
 #include "common/definitions.h"
 #include "data_structure/graph_access.h"
@@ -174,6 +183,132 @@ TEST_F(MultiterminalCutTest, FourClustersMinCutUnequal) {
     }
 }
 
+TEST_F(MultiterminalCutTest, RelativeGap) {
+    size_t cluster_size = 50;
+    graphAccessPtr G = std::make_shared<graph_access>();
+    G->start_construction(4 * cluster_size,
+                          2 * cluster_size * (cluster_size - 1) * 4 + 12);
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            if (i != j) {
+                EdgeID e = G->new_edge(i * cluster_size, j * cluster_size);
+                G->setEdgeWeight(e, i + j);
+            }
+        }
+        for (size_t j = 0; j < cluster_size; ++j) {
+            for (size_t k = 0; k < cluster_size; ++k) {
+                if (j != k) {
+                    NodeID base = cluster_size * i;
+                    G->new_edge(base + j, base + k);
+                }
+            }
+        }
+    }
+    G->finish_construction();
+    auto mG = mutable_graph::from_graph_access(G);
+
+    std::vector<NodeID> terminals(mG->n(), UNDEFINED_NODE);
+    for (size_t i = 0; i < 4; ++i) {
+        terminals[i * cluster_size + 1] = i;
+    }
+
+    auto cfg = configuration::getConfig();
+    for (double gap : { 0.0, 0.5 }) {
+        cfg->gap = gap;
+        std::vector<FlowType> incumbents;
+        multiterminal_cut mct;
+        mct.setIncumbentCallback([&incumbents](double, size_t, FlowType cut) {
+                                     incumbents.emplace_back(cut);
+                                 });
+        FlowType f = mct.multicut(mG, terminals, 4);
+
+        ASSERT_LE(mct.lowerBound(), (FlowType)18);
+        ASSERT_GE(f, (FlowType)18);
+        ASSERT_LE(f - mct.lowerBound(), gap * f);
+        ASSERT_GT(incumbents.size(), (size_t)0);
+        ASSERT_EQ(incumbents.back(), f);
+        for (size_t i = 1; i < incumbents.size(); ++i) {
+            ASSERT_LT(incumbents[i], incumbents[i - 1]);
+        }
+    }
+    cfg->gap = 0.0;
+}
+
+TEST_F(MultiterminalCutTest, MultilevelSolver) {
+    // four cliques connected by one edge each, coarsened until every clique
+    // is contracted into a few vertices
+    size_t cluster_size = 50;
+    graphAccessPtr G = std::make_shared<graph_access>();
+    G->start_construction(4 * cluster_size,
+                          2 * cluster_size * (cluster_size - 1) * 4 + 12);
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            if (i != j) {
+                G->new_edge(i * cluster_size, j * cluster_size);
+            }
+        }
+        for (size_t j = 0; j < cluster_size; ++j) {
+            for (size_t k = 0; k < cluster_size; ++k) {
+                if (j != k) {
+                    NodeID base = cluster_size * i;
+                    G->new_edge(base + j, base + k);
+                }
+            }
+        }
+    }
+    G->finish_construction();
+    auto mG = mutable_graph::from_graph_access(G);
+
+    std::vector<NodeID> terminals(mG->n(), UNDEFINED_NODE);
+    for (size_t i = 0; i < 4; ++i) {
+        terminals[i * cluster_size + 1] = i;
+    }
+
+    auto cfg = configuration::getConfig();
+    cfg->multicut_solver = "multilevel";
+    cfg->multilevel_coarsest_size = 10;
+    // solver uses cfg->threads, but does not change the thread count of
+    // the caller
+    int threads = omp_get_max_threads();
+    omp_set_num_threads(3);
+    for (size_t small_component_size : { 0, 100000 }) {
+        cfg->small_component_size = small_component_size;
+        multiterminal_cut mct;
+        FlowType f = mct.multicut(mG, terminals, 4);
+        ASSERT_EQ(f, (FlowType)6);
+        ASSERT_EQ(omp_get_max_threads(), 3);
+    }
+    omp_set_num_threads(threads);
+    cfg->multicut_solver = "exact";
+    cfg->multilevel_coarsest_size = 1000;
+    cfg->small_component_size = 10000;
+}
+
+TEST_F(MultiterminalCutTest, MultilevelClusterWithTerminals) {
+    // label propagation finds the clique as one cluster, which contains all
+    // terminals. Only the terminals are split off.
+    NodeID n = 60;
+    auto G = std::make_shared<mutable_graph>();
+    G->start_construction(n);
+    for (NodeID u = 0; u < n; ++u) {
+        for (NodeID v = u + 1; v < n; ++v) {
+            G->new_edge_order(u, v, 1);
+        }
+    }
+    G->finish_construction();
+    std::vector<NodeID> terminals = { 0, 1, 2 };
+
+    auto [mapping, reverse_mapping] =
+        multilevel_multicut::clusterSeparatingTerminals(G, terminals);
+    ASSERT_LT(reverse_mapping.size(), n / 2);
+    std::unordered_set<NodeID> terminal_clusters;
+    for (NodeID t : terminals) {
+        ASSERT_EQ(reverse_mapping[mapping[t]], std::vector<NodeID>({ t }));
+        terminal_clusters.insert(mapping[t]);
+    }
+    ASSERT_EQ(terminal_clusters.size(), terminals.size());
+}
+
 TEST_F(MultiterminalCutTest, TotallyDisconnected) {
     std::vector<size_t> sizes = { 1, 5, 10, 50, 100 };
     configuration::getConfig()->write_solution = true;
@@ -254,3 +389,400 @@ TEST_F(MultiterminalCutTest, PartiallyDisconnected) {
         ASSERT_EQ(f, (FlowType)2);
     }
 }
+
+TEST_F(MultiterminalCutTest, ManySmallComponents) {
+    // disconnected copies of four connected clusters, all but the last one
+    // are small enough to be solved concurrently
+    std::vector<size_t> sizes = { 5, 10, 5, 10, 5, 10, 80 };
+    size_t n = 0;
+    size_t m = 0;
+    for (size_t cluster_size : sizes) {
+        n += 4 * cluster_size;
+        m += 2 * cluster_size * (cluster_size - 1) * 4 + 12;
+    }
+
+    graphAccessPtr G = std::make_shared<graph_access>();
+    G->start_construction(n, m);
+    std::vector<NodeID> terminals(n, UNDEFINED_NODE);
+    NodeID first = 0;
+    for (size_t cluster_size : sizes) {
+        for (size_t i = 0; i < 4; ++i) {
+            NodeID base = first + cluster_size * i;
+            terminals[base + cluster_size - 1] = i;
+            for (size_t j = 0; j < 4; ++j) {
+                if (i != j) {
+                    G->new_edge(base, first + j * cluster_size);
+                }
+            }
+
+            for (size_t j = 0; j < cluster_size; ++j) {
+                for (size_t k = 0; k < cluster_size; ++k) {
+                    if (j != k) {
+                        G->new_edge(base + j, base + k);
+                    }
+                }
+            }
+        }
+        first += 4 * cluster_size;
+    }
+    G->finish_construction();
+    auto mG = mutable_graph::from_graph_access(G);
+
+    auto cfg = configuration::getConfig();
+    size_t threads = cfg->threads;
+    for (size_t t : { 1, 4 }) {
+        cfg->threads = t;
+        multiterminal_cut mct;
+        FlowType f = mct.multicut(mG, terminals, 4);
+        ASSERT_EQ(f, (FlowType)(6 * sizes.size()));
+    }
+    cfg->threads = threads;
+}
+
+TEST_F(MultiterminalCutTest, ParallelLocalSearch) {
+    // four cliques connected by one edge each, solution has a random tenth
+    // of the vertices in the wrong block
+    size_t cluster_size = 50;
+    graphAccessPtr G = std::make_shared<graph_access>();
+    G->start_construction(4 * cluster_size,
+                          2 * cluster_size * (cluster_size - 1) * 4 + 12);
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            if (i != j) {
+                G->new_edge(i * cluster_size, j * cluster_size);
+            }
+        }
+        for (size_t j = 0; j < cluster_size; ++j) {
+            for (size_t k = 0; k < cluster_size; ++k) {
+                if (j != k) {
+                    NodeID base = cluster_size * i;
+                    G->new_edge(base + j, base + k);
+                }
+            }
+        }
+    }
+    G->finish_construction();
+    auto mG = mutable_graph::from_graph_access(G);
+
+    auto cutValue = [&mG](const std::vector<NodeID>& sol) {
+        FlowType cut = 0;
+        for (NodeID n : mG->nodes()) {
+            for (EdgeID e : mG->edges_of(n)) {
+                auto [t, w] = mG->getEdge(n, e);
+                if (sol[n] != sol[t])
+                    cut += w;
+            }
+        }
+        return cut / 2;
+    };
+
+    std::vector<NodeID> terminals;
+    std::vector<bool> fixed_vertex(mG->n(), false);
+    std::vector<NodeID> sol(mG->n());
+    std::mt19937 eng(7);
+    std::uniform_int_distribution<> block(0, 3);
+    for (size_t i = 0; i < 4; ++i) {
+        NodeID terminal = i * cluster_size + 1;
+        terminals.push_back(terminal);
+        fixed_vertex[terminal] = true;
+        for (size_t j = 0; j < cluster_size; ++j) {
+            NodeID n = i * cluster_size + j;
+            sol[n] = (n == terminal || eng() % 10) ? i : block(eng);
+        }
+    }
+
+    auto cfg = configuration::getConfig();
+    cfg->num_terminals = 4;
+    cfg->local_search_threads = 4;
+    FlowType before = cutValue(sol);
+    local_search ls(*mG, terminals, fixed_vertex, &sol);
+    timer t;
+    FlowType improvement = ls.improveSolution(t);
+    cfg->local_search_threads = 1;
+
+    ASSERT_EQ(cutValue(sol), (FlowType)6);
+    ASSERT_EQ(before - improvement, cutValue(sol));
+    for (size_t i = 0; i < 4; ++i) {
+        ASSERT_EQ(sol[terminals[i]], i);
+    }
+}
+
+TEST_F(MultiterminalCutTest, SpillProblems) {
+    graphAccessPtr G = graph_io::readGraphWeighted(
+        std::string(VIECUT_PATH) + "/graphs/small.metis");
+    per_thread_problem_queue queue(1, "lower_bound");
+    for (FlowType i = 0; i < 10; ++i) {
+        auto mG = mutable_graph::from_graph_access(G);
+        std::vector<terminal> terminals = { terminal(0, 0),
+                                            terminal(i % 7, 1) };
+        auto problem = std::make_shared<multicut_problem>(mG, terminals);
+        problem->lower_bound = i;
+        problem->upper_bound = 2 * i;
+        problem->addFinishedPair(0, 1, 2);
+        queue.addProblem(problem, 0, true);
+    }
+
+    // one problem is held back to be sent, the worse half of the others
+    // is spilled
+    ASSERT_EQ(queue.spillProblems(), (size_t)4);
+    ASSERT_EQ(queue.size(), (size_t)10);
+
+    std::vector<FlowType> lower_bounds;
+    while (!queue.all_empty()) {
+        queue.prepareQueue(0, 8);
+        auto problem = queue.pullProblem(0, false);
+        if (!problem.has_value()) {
+            continue;
+        }
+        auto p = problem.value();
+        lower_bounds.emplace_back(p->lower_bound);
+        ASSERT_EQ(p->upper_bound, 2 * p->lower_bound);
+        ASSERT_EQ(p->graph->n(), G->number_of_nodes());
+        ASSERT_EQ(p->graph->m(), G->number_of_edges());
+        ASSERT_EQ(p->terminals.size(), (size_t)2);
+        ASSERT_EQ(p->terminals[1].position, (NodeID)(p->lower_bound % 7));
+        ASSERT_TRUE(p->isPairFinished(0, 1, 2));
+    }
+
+    // problems with lower bound 8 and 9 can not improve on upper bound 8
+    std::sort(lower_bounds.begin(), lower_bounds.end());
+    ASSERT_EQ(lower_bounds,
+              std::vector<FlowType>({ 0, 1, 2, 3, 4, 5, 6, 7 }));
+}
+
+TEST_F(MultiterminalCutTest, SpillFileReusesSpace) {
+    // sparse problem graph with isolated vertices and vertex ids larger than
+    // its number of edges
+    auto problem = [](FlowType lower_bound) {
+        auto G = std::make_shared<mutable_graph>();
+        G->start_construction(100);
+        G->new_edge_order(0, 50, 3);
+        G->new_edge_order(1, 2, 1);
+        G->finish_construction();
+        std::vector<terminal> terminals = { terminal(0, 0), terminal(1, 1) };
+        auto p = std::make_shared<multicut_problem>(G, terminals);
+        p->lower_bound = lower_bound;
+        return p;
+    };
+
+    problem_spill_file spill("");
+    auto a = spill.store(problem(0));
+    auto b = spill.store(problem(1));
+    auto c = spill.store(problem(2));
+    size_t size = spill.fileSize();
+    ASSERT_EQ(size, a.size + b.size + c.size);
+
+    // space of loaded problems is reused
+    auto p = spill.load(b);
+    ASSERT_EQ(p->lower_bound, 1);
+    ASSERT_EQ(p->graph->n(), 100);
+    ASSERT_EQ(p->graph->m(), 4);
+    ASSERT_EQ(p->graph->getEdgeTarget(0, 0), 50);
+    ASSERT_EQ(p->graph->getEdgeWeight(0, 0), 3);
+    auto d = spill.store(problem(3));
+    ASSERT_EQ(d.offset, b.offset);
+    ASSERT_EQ(spill.fileSize(), size);
+
+    // space at the end of the file is released
+    spill.release(c);
+    ASSERT_EQ(spill.fileSize(), c.offset);
+    ASSERT_EQ(spill.load(a)->lower_bound, 0);
+    ASSERT_EQ(spill.load(d)->lower_bound, 3);
+    ASSERT_EQ(spill.fileSize(), 0);
+}
+
+TEST_F(MultiterminalCutTest, MappingChain) {
+    // contract and simplify the problem graph more often than
+    // max_mapping_chain, as branch_multicut does in deep branches, and check
+    // that mapped() still resolves every original vertex
+    NodeID n = 200;
+    std::mt19937 eng(0);
+    auto G = std::make_shared<mutable_graph>();
+    G->start_construction(n);
+    for (NodeID v = 0; v < n; ++v) {
+        G->new_edge_order(v, (v + 1) % n, 1);
+        G->new_edge_order(v, eng() % n, 1);
+    }
+    G->finish_construction();
+    auto problem = std::make_shared<multicut_problem>(
+        G, std::vector<terminal>());
+
+    union_find uf(n);
+    std::shared_ptr<multicut_problem> sibling;
+    std::vector<NodeID> sibling_positions;
+    size_t steps = 3 * multicut_problem::max_mapping_chain;
+    for (size_t step = 0; step < steps; ++step) {
+        mutableGraphPtr graph = problem->graph;
+        std::vector<NodeID> representative(graph->n());
+        for (NodeID v = 0; v < n; ++v) {
+            representative[graph->getCurrentPosition(problem->mapped(v))] = v;
+        }
+        for (size_t i = 0; i < 10 && graph->n() > 1; ++i) {
+            NodeID v = eng() % graph->n();
+            if (graph->getUnweightedNodeDegree(v) == 0) {
+                continue;
+            }
+            EdgeID e = eng() % graph->getUnweightedNodeDegree(v);
+            uf.Union(representative[v],
+                     representative[graph->getEdgeTarget(v, e)]);
+            // contracting moves the last vertex to the position of one of
+            // the endpoints
+            graph->contractEdge(v, e);
+            for (NodeID o = 0; o < n; ++o) {
+                representative[graph->getCurrentPosition(
+                                   problem->mapped(o))] = o;
+            }
+        }
+
+        auto map = std::make_shared<std::vector<NodeID> >();
+        for (size_t i = 0; i < graph->getOriginalNodes(); ++i) {
+            map->emplace_back(graph->getCurrentPosition(i));
+        }
+        problem->addMapping(map);
+        problem->graph = graph->simplify();
+        ASSERT_LE(problem->mappings.size(),
+                  multicut_problem::max_mapping_chain);
+
+        // same current vertex iff contracted together
+        std::vector<NodeID> set_of_position(problem->graph->n(),
+                                            UNDEFINED_NODE);
+        std::vector<NodeID> positions;
+        for (NodeID v = 0; v < n; ++v) {
+            NodeID pos = problem->graph->getCurrentPosition(
+                problem->mapped(v));
+            ASSERT_LT(pos, problem->graph->n());
+            if (set_of_position[pos] == UNDEFINED_NODE) {
+                set_of_position[pos] = uf.Find(v);
+            }
+            ASSERT_EQ(set_of_position[pos], uf.Find(v));
+            positions.emplace_back(pos);
+        }
+        ASSERT_EQ(uf.n(), problem->graph->n());
+
+        // branches share mappings, later compositions must not change the
+        // mapping of a sibling. The graph is copied, as in branching
+        if (step == 1) {
+            sibling = std::make_shared<multicut_problem>(*problem);
+            sibling->graph = std::make_shared<mutable_graph>(*problem->graph);
+            sibling_positions = positions;
+        }
+    }
+
+    for (NodeID v = 0; v < n; ++v) {
+        ASSERT_EQ(sibling->graph->getCurrentPosition(sibling->mapped(v)),
+                  sibling_positions[v]);
+    }
+}
+
+TEST_F(MultiterminalCutTest, TranspositionTable) {
+    graphAccessPtr G = graph_io::readGraphWeighted(
+        std::string(VIECUT_PATH) + "/graphs/small.metis");
+    auto contracted = [&G](const std::unordered_set<NodeID>& vertices) {
+        auto mG = mutable_graph::from_graph_access(G);
+        mG->contractVertexSet(vertices);
+        std::vector<terminal> terminals = {
+            terminal(mG->getCurrentPosition(0), 0),
+            terminal(mG->getCurrentPosition(1), 1) };
+        return std::make_shared<multicut_problem>(mG, terminals);
+    };
+
+    NodeID n = G->number_of_nodes();
+    auto first = transposition_table::problemHash(contracted({ 2, 3 }), n);
+    auto same = transposition_table::problemHash(contracted({ 3, 2 }), n);
+    auto other = transposition_table::problemHash(contracted({ 2, 4 }), n);
+    auto deleted = contracted({ 2, 3 });
+    deleted->deleted_weight = 1;
+    auto with_deleted = transposition_table::problemHash(deleted, n);
+    ASSERT_EQ(first, same);
+    ASSERT_NE(first, other);
+    ASSERT_NE(first, with_deleted);
+
+    // sibling branches that delete different edges of the same weight have
+    // the same partition and deleted weight, but are different problems
+    auto deleteEdge = [&contracted](NodeID v, NodeID t) {
+        auto p = contracted({ 2, 3 });
+        NodeID v_pos = p->graph->getCurrentPosition(v);
+        NodeID t_pos = p->graph->getCurrentPosition(t);
+        for (EdgeID e : p->graph->edges_of(v_pos)) {
+            if (p->graph->getEdgeTarget(v_pos, e) == t_pos) {
+                p->graph->deleteEdge(v_pos, e);
+                break;
+            }
+        }
+        p->deleted_weight = 1;
+        return p;
+    };
+    NodeID v = 5;
+    NodeID t0 = G->getEdgeTarget(G->get_first_edge(v));
+    NodeID t1 = G->getEdgeTarget(G->get_first_edge(v) + 1);
+    ASSERT_EQ(G->getEdgeWeight(G->get_first_edge(v)),
+              G->getEdgeWeight(G->get_first_edge(v) + 1));
+    auto delete_t0 = transposition_table::problemHash(deleteEdge(v, t0), n);
+    auto delete_t1 = transposition_table::problemHash(deleteEdge(v, t1), n);
+    auto delete_t0_reverse =
+        transposition_table::problemHash(deleteEdge(t0, v), n);
+    ASSERT_NE(delete_t0, delete_t1);
+    ASSERT_EQ(delete_t0, delete_t0_reverse);
+    ASSERT_NE(delete_t0, with_deleted);
+
+    // the second sibling is not pruned as a duplicate of the first, but
+    // the same problem reached in another way is
+    transposition_table siblings(1 << 20);
+    ASSERT_FALSE(siblings.checkAndInsert(delete_t0, 5));
+    ASSERT_FALSE(siblings.checkAndInsert(delete_t1, 5));
+    ASSERT_TRUE(siblings.checkAndInsert(delete_t0_reverse, 5));
+
+    transposition_table table(1 << 20);
+    ASSERT_FALSE(table.checkAndInsert(first, 5));
+    ASSERT_FALSE(table.checkAndInsert(other, 5));
+    ASSERT_TRUE(table.checkAndInsert(same, 5));
+    ASSERT_TRUE(table.checkAndInsert(same, 7));
+    ASSERT_FALSE(table.checkAndInsert(same, 3));
+    ASSERT_TRUE(table.checkAndInsert(first, 3));
+    ASSERT_EQ(table.prunedProblems(), (size_t)3);
+}
+
+TEST_F(MultiterminalCutTest, ParallelEqualNeighborhoods) {
+    auto cfg = configuration::getConfig();
+    size_t threads = cfg->threads;
+    cfg->threads = 4;
+    NodeID hubs = 10;
+    NodeID n = 1000;
+    std::mt19937 eng(7);
+    mutableGraphPtr G = std::make_shared<mutable_graph>();
+    G->start_construction(n);
+    for (NodeID v = hubs; v < n; ++v) {
+        NodeID pattern = v % 7;
+        for (NodeID h = pattern; h < pattern + 3; ++h) {
+            G->new_edge(h, v, 1 + (v % 2));
+        }
+        if (eng() % 10 == 0) {
+            G->new_edge(v, hubs + eng() % (n - hubs));
+        }
+    }
+    std::vector<terminal> terminals = { terminal(0, 0), terminal(1, 1) };
+    auto problem = std::make_shared<multicut_problem>(G, terminals);
+    std::vector<bool> active(n, true);
+
+    equal_neighborhood en;
+    union_find uf(n);
+    en.findEqualNeighborhoodsNonNeighborsParallel(problem, active, &uf);
+    ASSERT_LT(uf.n(), n / 2);
+
+    std::vector<std::vector<std::pair<NodeID, EdgeWeight> > > ngbrs(n);
+    for (NodeID v : G->nodes()) {
+        for (EdgeID e : G->edges_of(v)) {
+            ngbrs[v].emplace_back(G->getEdge(v, e));
+        }
+        std::sort(ngbrs[v].begin(), ngbrs[v].end());
+    }
+
+    for (NodeID u = 2; u < n; ++u) {
+        for (NodeID v = u + 1; v < n; ++v) {
+            bool equal = ngbrs[u].size() <= cfg->neighborhood_degrees
+                         && ngbrs[u] == ngbrs[v];
+            ASSERT_EQ(uf.Find(u) == uf.Find(v), equal);
+        }
+    }
+    cfg->threads = threads;
+}
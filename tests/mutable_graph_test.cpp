@@ -12,10 +12,14 @@
 #include <stddef.h>
 
 #include <cstdint>
+#include <algorithm>
 #include <initializer_list>
+#include <map>
 #include <memory>
 #include <random>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "common/definitions.h"
@@ -251,6 +255,100 @@ TEST(Mutable_Graph_Test, ContractEdgesWeighted) {
     ASSERT_EQ(G.number_of_edges(), 0);
 }
 
+TEST(Mutable_Graph_Test, ContractParallelEdges) {
+    mutable_graph G = make_circle();
+    // parallel edges between 0 and 1 and between 1 and 2
+    G.new_edge_order(0, 1, 2);
+    G.new_edge_order(2, 1, 4);
+    G.new_edge_order(2, 1, 5);
+
+    G.contractEdge(0, 0);
+
+    // second edge between 0 and 1 is removed instead of becoming a loop
+    ASSERT_EQ(G.number_of_nodes(), 2);
+    ASSERT_EQ(G.number_of_edges(), 2);
+    ASSERT_EQ(G.getUnweightedNodeDegree(0), 1);
+    ASSERT_EQ(G.getWeightedNodeDegree(0), 11);
+    ASSERT_EQ(G.getWeightedNodeDegree(1), 11);
+    ASSERT_EQ(G.getEdgeWeight(0, 0), 11);
+    ASSERT_EQ(G.getEdgeWeight(1, 0), 11);
+    ASSERT_EQ(G.getEdgeTarget(1, 0), 0);
+}
+
+TEST(Mutable_Graph_Test, ContractRandomMultigraph) {
+    // regression test: contracting an edge that has parallel edges created
+    // self-loops and summed up weights on stale reverse edges
+    for (size_t variant = 0; variant < 3; ++variant) {
+        for (size_t seed = 0; seed < 20; ++seed) {
+            std::mt19937 eng(seed);
+            NodeID n = 30;
+            std::vector<std::tuple<NodeID, NodeID, EdgeWeight> > edges;
+            mutable_graph G;
+            G.start_construction(n);
+            for (NodeID i = 0; i < 4 * n; ++i) {
+                NodeID u = eng() % n;
+                NodeID v = eng() % 4 == 0 ? (u + 1) % n : eng() % n;
+                if (u != v) {
+                    EdgeWeight w = 1 + eng() % 5;
+                    G.new_edge_order(u, v, w);
+                    edges.emplace_back(u, v, w);
+                }
+            }
+            G.finish_construction();
+
+            while (G.n() > 1) {
+                NodeID v = eng() % G.n();
+                if (G.getUnweightedNodeDegree(v) == 0) {
+                    break;
+                }
+                EdgeID e = eng() % G.getUnweightedNodeDegree(v);
+                if (variant == 0) {
+                    G.contractEdge(v, e);
+                } else if (variant == 1) {
+                    G.contractEdgeSparseTarget(v, e);
+                } else {
+                    NodeID t = G.getEdgeTarget(v, e);
+                    G.contractSparseTargetNoEdge(std::min(v, t),
+                                                 std::max(v, t));
+                }
+
+                // adjacency is consistent and contains no self-loops
+                std::map<std::pair<NodeID, NodeID>, EdgeWeight> weights;
+                EdgeID num_edges = 0;
+                for (NodeID x : G.nodes()) {
+                    EdgeWeight degree = 0;
+                    for (EdgeID f : G.edges_of(x)) {
+                        NodeID y = G.getEdgeTarget(x, f);
+                        EdgeID rev = G.getReverseEdge(x, f);
+                        ASSERT_NE(x, y);
+                        ASSERT_EQ(G.getEdgeTarget(y, rev), x);
+                        ASSERT_EQ(G.getReverseEdge(y, rev), f);
+                        ASSERT_EQ(G.getEdgeWeight(y, rev),
+                                  G.getEdgeWeight(x, f));
+                        degree += G.getEdgeWeight(x, f);
+                        weights[std::make_pair(x, y)] += G.getEdgeWeight(x, f);
+                        ++num_edges;
+                    }
+                    ASSERT_EQ(G.getWeightedNodeDegree(x), degree);
+                }
+                ASSERT_EQ(G.m(), num_edges);
+
+                // weights between contracted vertices are preserved
+                std::map<std::pair<NodeID, NodeID>, EdgeWeight> expected;
+                for (auto [x, y, w] : edges) {
+                    NodeID px = G.getCurrentPosition(x);
+                    NodeID py = G.getCurrentPosition(y);
+                    if (px != py) {
+                        expected[std::make_pair(px, py)] += w;
+                        expected[std::make_pair(py, px)] += w;
+                    }
+                }
+                ASSERT_EQ(weights, expected);
+            }
+        }
+    }
+}
+
 TEST(Mutable_Graph_Test, LargerGraph) {
     for (size_t size : { 5, 10, 50, 100 }) {
         mutableGraphPtr G = std::make_shared<mutable_graph>();
@@ -354,7 +452,7 @@ TEST(Mutable_Graph_Test, SerializeEmpty) {
     mG.finish_construction();
 
     auto s = mG.serialize();
-    std::vector<uint64_t> eq = { 0, 0, 0, 0, UNDEFINED_EDGE };
+    std::vector<uint64_t> eq = { 0, 0, 0, 0 };
 
     ASSERT_EQ(s, eq);
 }
@@ -364,10 +462,9 @@ TEST(Mutable_Graph_Test, SerializeCircle) {
 
     auto s = G.serialize();
     std::vector<uint64_t> eq = { 3, 6, 0, 3,     // values
-                                 6, 1, 1, 2, 1,  // n0
-                                 7, 2, 1,        // n1
-                                 8,              // n2
-                                 UNDEFINED_EDGE,
+                                 2, 1, 1, 2, 1,  // n0
+                                 1, 2, 1,        // n1
+                                 0,              // n2
                                  0, 0, 0,        // partition
                                  0, 1, 2,        // position
     };
@@ -397,6 +494,34 @@ TEST(Mutable_Graph_Test, DeserializedCircleEqual) {
     }
 }
 
+TEST(Mutable_Graph_Test, DeserializedSparseEqual) {
+    // vertex ids are larger than the number of edges and most vertices are
+    // isolated
+    for (NodeID num_edges : { 0, 1, 2 }) {
+        mutable_graph G;
+        G.start_construction(100);
+        if (num_edges > 0) {
+            G.new_edge_order(0, 50, 3);
+        }
+        if (num_edges > 1) {
+            G.new_edge_order(1, 2, 1);
+        }
+        G.finish_construction();
+        auto G2 = mutable_graph::deserialize(G.serialize());
+
+        ASSERT_EQ(G2->n(), 100);
+        ASSERT_EQ(G2->m(), 2 * num_edges);
+        for (NodeID n : G.nodes()) {
+            ASSERT_EQ(G.getUnweightedNodeDegree(n),
+                      G2->getUnweightedNodeDegree(n));
+            for (EdgeID e : G.edges_of(n)) {
+                ASSERT_EQ(G.getEdgeTarget(n, e), G2->getEdgeTarget(n, e));
+                ASSERT_EQ(G.getEdgeWeight(n, e), G2->getEdgeWeight(n, e));
+            }
+        }
+    }
+}
+
 TEST(Mutable_Graph_Test, DeserializedContractedEqual) {
     mutable_graph G = make_circle();
     G.contractEdge(0, 0);
@@ -0,0 +1,118 @@
+/******************************************************************************
+ * numa_tools_test.cpp
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#include <omp.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "common/configuration.h"
+#include "gtest/gtest.h"
+#include "tools/numa_tools.h"
+
+class NumaToolsTest : public ::testing::TestWithParam<bool> {
+ protected:
+    void SetUp() override {
+        omp_set_num_threads(4);
+        configuration::getConfig()->numa = GetParam();
+    }
+
+    void TearDown() override {
+        configuration::getConfig()->numa = false;
+    }
+};
+
+INSTANTIATE_TEST_SUITE_P(NumaMode, NumaToolsTest, ::testing::Bool());
+
+TEST_P(NumaToolsTest, InterleavedVector) {
+    for (size_t n : { 0, 1, 1000, 1000000 }) {
+        std::vector<uint64_t> v = numa_tools::interleavedVector<uint64_t>(
+            n, 42);
+        ASSERT_EQ(v.size(), n);
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(v[i], 42);
+        }
+    }
+}
+
+TEST_P(NumaToolsTest, FirstTouch) {
+    size_t n = 1000000;
+    std::vector<uint32_t> v;
+    numa_tools::interleavedReserve(&v, n);
+    v.resize(n);
+#pragma omp parallel
+    {
+        numa_tools::firstTouch(&v, 0, n / 2, static_cast<uint32_t>(1));
+        numa_tools::firstTouch(&v, n / 2, n, static_cast<uint32_t>(2));
+    }
+    for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(v[i], i < n / 2 ? 1 : 2);
+    }
+
+    // outside of a parallel region, the calling thread touches everything
+    numa_tools::firstTouch(&v, 0, n, static_cast<uint32_t>(3));
+    for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(v[i], 3);
+    }
+}
+
+TEST_P(NumaToolsTest, BindThreads) {
+    cpu_set_t before;
+    CPU_ZERO(&before);
+    ASSERT_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &before), 0);
+    int max_threads = omp_get_max_threads();
+
+    // as in the mincut apps, which pin the threads for every -p value
+    bool pinned = GetParam() && numa_tools::numNodes() > 1;
+    std::atomic<size_t> invalid = 0;
+    for (int threads : { 2, 4 }) {
+        omp_set_num_threads(threads);
+        numa_tools::bindThreads();
+
+        // threads are either not pinned or pinned to single allowed cores,
+        // which are different if there are enough cores
+        std::vector<int> cores(threads, -1);
+#pragma omp parallel
+        {
+            cpu_set_t after;
+            CPU_ZERO(&after);
+            sched_getaffinity(0, sizeof(cpu_set_t), &after);
+            cpu_set_t allowed;
+            CPU_AND(&allowed, &after, &before);
+            if (!CPU_EQUAL(&allowed, &after)
+                || (pinned && CPU_COUNT(&after) != 1)
+                || (!pinned && !CPU_EQUAL(&after, &before))) {
+                ++invalid;
+            }
+            for (int cpu = 0; pinned && cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &after)) {
+                    cores[omp_get_thread_num()] = cpu;
+                }
+            }
+        }
+        std::sort(cores.begin(), cores.end());
+        size_t distinct = std::unique(cores.begin(), cores.end())
+                          - cores.begin();
+        if (pinned && distinct < std::min(threads, CPU_COUNT(&before))) {
+            ++invalid;
+        }
+    }
+
+    // restore the affinity for the following tests
+#pragma omp parallel
+    {
+        sched_setaffinity(0, sizeof(cpu_set_t), &before);
+    }
+    omp_set_num_threads(max_threads);
+    ASSERT_EQ(invalid, 0);
+}
@@ -418,3 +418,25 @@ TEST(PushRelabelTest, ContractSrcBlock) {
     ASSERT_EQ(f5, static_cast<FlowType>(1));
     ASSERT_EQ(src_block5.size(), 7);
 }
+
+TEST(PushRelabelTest, LimitedFlowsReuseInstance) {
+    mutableGraphPtr G = graph_io::readGraphWeighted<mutable_graph>(
+        std::string(VIECUT_PATH) + "/graphs/small.metis");
+
+    push_relabel<true> pr;
+    for (NodeID s = 0; s < G->n(); ++s) {
+        for (NodeID t = 0; t < G->n(); ++t) {
+            if (s == t)
+                continue;
+
+            std::vector<NodeID> terminals = { s, t };
+            push_relabel<true> fresh;
+            auto f = pr.solve_max_flow_min_cut(
+                G, terminals, 0, true, 3, s * G->n() + t).first;
+            auto f_fresh = fresh.solve_max_flow_min_cut(
+                G, terminals, 0, true, 3, s * G->n() + t + 100).first;
+            ASSERT_EQ(f, f_fresh);
+            ASSERT_EQ(f, (s / 4 == t / 4) ? 3 : 2);
+        }
+    }
+}
@@ -0,0 +1,109 @@
+/******************************************************************************
+ * sorted_adjacency_test.cpp
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/definitions.h"
+#include "data_structure/graph_access.h"
+#include "data_structure/mutable_graph.h"
+#include "data_structure/sorted_adjacency.h"
+#include "gtest/gtest.h"
+#include "io/graph_io.h"
+#include "tools/simd_intersection.h"
+
+TEST(SimdIntersectionTest, RandomSets) {
+    std::mt19937 eng(42);
+    for (size_t size : { 0, 1, 7, 8, 9, 16, 33, 100, 1000 }) {
+        for (NodeID range : { 10, 100, 10000 }) {
+            std::uniform_int_distribution<NodeID> dist(0, range);
+            std::vector<NodeID> a(size);
+            std::vector<NodeID> b(size / 2 + 3);
+            for (auto& v : a) {
+                v = dist(eng);
+            }
+            for (auto& v : b) {
+                v = dist(eng);
+            }
+            for (auto* v : { &a, &b }) {
+                std::sort(v->begin(), v->end());
+                v->erase(std::unique(v->begin(), v->end()), v->end());
+            }
+
+            std::vector<NodeID> expected;
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                                  std::back_inserter(expected));
+
+            std::vector<NodeID> common;
+            simd_intersection::intersect(
+                a.data(), a.size(), b.data(), b.size(),
+                [&](size_t i, size_t j) {
+                    ASSERT_EQ(a[i], b[j]);
+                    common.emplace_back(a[i]);
+                });
+            ASSERT_EQ(common, expected);
+            ASSERT_EQ(simd_intersection::count(b.data(), b.size(),
+                                               a.data(), a.size()),
+                      expected.size());
+        }
+    }
+}
+
+TEST(SortedAdjacencyTest, CommonNeighbors) {
+    auto G = graph_io::readGraphWeighted(
+        std::string(VIECUT_PATH) + "/graphs/small-wgt.metis");
+    auto mG = mutable_graph::from_graph_access(G);
+    sorted_adjacency sorted_g(G);
+    sorted_adjacency sorted_m(mG, /* parallel */ true);
+
+    for (NodeID n : G->nodes()) {
+        ASSERT_EQ(sorted_g.degree(n), G->getUnweightedNodeDegree(n));
+        ASSERT_TRUE(std::is_sorted(sorted_g.neighbors(n),
+                                   sorted_g.neighbors(n)
+                                   + sorted_g.degree(n)));
+    }
+
+    for (NodeID u : G->nodes()) {
+        for (NodeID v : G->nodes()) {
+            std::vector<sorted_adjacency::common_neighbor> expected;
+            for (EdgeID e1 : G->edges_of(u)) {
+                for (EdgeID e2 : G->edges_of(v)) {
+                    if (G->getEdgeTarget(e1) == G->getEdgeTarget(e2)) {
+                        expected.push_back({ G->getEdgeTarget(e1),
+                                             G->getEdgeWeight(e1),
+                                             G->getEdgeWeight(e2) });
+                    }
+                }
+            }
+            std::sort(expected.begin(), expected.end(),
+                      [](const auto& c1, const auto& c2) {
+                          return c1.vertex < c2.vertex;
+                      });
+
+            for (const auto* sorted : { &sorted_g, &sorted_m }) {
+                auto common = sorted->commonNeighbors(u, v);
+                ASSERT_EQ(common.size(), expected.size());
+                for (size_t i = 0; i < common.size(); ++i) {
+                    ASSERT_EQ(common[i].vertex, expected[i].vertex);
+                    ASSERT_EQ(common[i].weight_u, expected[i].weight_u);
+                    ASSERT_EQ(common[i].weight_v, expected[i].weight_v);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,121 @@
+/******************************************************************************
+ * sparse_accumulator_test.cpp
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "common/definitions.h"
+#include "data_structure/sparse_accumulator.h"
+#include "gtest/gtest.h"
+
+TEST(SparseAccumulatorTest, Empty) {
+    sparse_accumulator acc;
+    acc.reset(0);
+    ASSERT_EQ(acc.size(), 0);
+    ASSERT_EQ(acc.get(0), 0);
+    ASSERT_EQ(acc.get(12345), 0);
+}
+
+TEST(SparseAccumulatorTest, AddAndGet) {
+    sparse_accumulator acc;
+    acc.reset(3);
+    ASSERT_EQ(acc.add(7, 2), 2);
+    ASSERT_EQ(acc.add(3, 5), 5);
+    ASSERT_EQ(acc.add(7, 4), 6);
+    ASSERT_EQ(acc.add(0, 1), 1);
+    ASSERT_EQ(acc.get(7), 6);
+    ASSERT_EQ(acc.get(3), 5);
+    ASSERT_EQ(acc.get(0), 1);
+    ASSERT_EQ(acc.get(1), 0);
+    ASSERT_EQ(acc.size(), 3);
+}
+
+TEST(SparseAccumulatorTest, IterateInInsertionOrder) {
+    sparse_accumulator acc;
+    acc.reset(4);
+    acc.add(42, 1);
+    acc.add(5, 2);
+    acc.add(42, 3);
+    acc.add(100000, 4);
+    acc.add(5, 5);
+
+    std::vector<std::pair<NodeID, EdgeWeight> > entries;
+    acc.forEach([&entries](NodeID key, EdgeWeight sum) {
+                    entries.emplace_back(key, sum);
+                });
+    std::vector<std::pair<NodeID, EdgeWeight> > expected = {
+        { 42, 4 }, { 5, 7 }, { 100000, 4 }
+    };
+    ASSERT_EQ(entries, expected);
+}
+
+TEST(SparseAccumulatorTest, ResetAndReuse) {
+    sparse_accumulator acc;
+    acc.reset(100);
+    for (NodeID key = 0; key < 100; ++key) {
+        acc.add(key, key + 1);
+    }
+    ASSERT_EQ(acc.size(), 100);
+
+    // smaller table afterwards, old keys must not be visible anymore
+    acc.reset(2);
+    ASSERT_EQ(acc.size(), 0);
+    for (NodeID key = 0; key < 100; ++key) {
+        ASSERT_EQ(acc.get(key), 0);
+    }
+    acc.add(17, 3);
+    acc.add(99, 1);
+    ASSERT_EQ(acc.get(17), 3);
+    ASSERT_EQ(acc.get(99), 1);
+    size_t visited = 0;
+    acc.forEach([&visited](NodeID, EdgeWeight) { ++visited; });
+    ASSERT_EQ(visited, 2);
+
+    // and larger again
+    acc.reset(1000);
+    ASSERT_EQ(acc.get(17), 0);
+    ASSERT_EQ(acc.add(17, 1), 1);
+}
+
+TEST(SparseAccumulatorTest, RandomAgainstMap) {
+    std::mt19937 eng(0);
+    sparse_accumulator acc;
+    for (size_t round = 0; round < 50; ++round) {
+        size_t keys = 1 + eng() % 200;
+        acc.reset(keys);
+        std::map<NodeID, EdgeWeight> expected;
+        std::vector<NodeID> key_set;
+        for (size_t i = 0; i < keys; ++i) {
+            key_set.emplace_back(eng());
+        }
+        for (size_t i = 0; i < 3 * keys; ++i) {
+            NodeID key = key_set[eng() % keys];
+            EdgeWeight w = eng() % 10;
+            expected[key] += w;
+            ASSERT_EQ(acc.add(key, w), expected[key]);
+        }
+
+        std::map<NodeID, EdgeWeight> found;
+        acc.forEach([&found](NodeID key, EdgeWeight sum) {
+                        ASSERT_EQ(found.count(key), 0);
+                        found[key] = sum;
+                    });
+        ASSERT_EQ(acc.size(), found.size());
+        for (auto [key, sum] : expected) {
+            ASSERT_EQ(acc.get(key), sum);
+        }
+        for (auto [key, sum] : found) {
+            ASSERT_EQ(expected[key], sum);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/******************************************************************************
+ * temporal_edge_stream_test.cpp
+ *
+ * Source of VieCut.
+ *
+ ******************************************************************************
+ * Copyright (C) 2020 Alexander Noe <alexander.noe@univie.ac.at>
+ *
+ * Published under the MIT license in the LICENSE file.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "common/definitions.h"
+#include "gtest/gtest.h"
+#include "io/temporal_edge_stream.h"
+#include "tools/random_functions.h"
+
+typedef temporal_edge_stream::update update;
+
+static std::vector<update> writeUpdates(const std::string& path,
+                                        bool sorted) {
+    std::vector<update> updates;
+    for (uint64_t i = 0; i < 1000; ++i) {
+        NodeID s = random_functions::nextInt(0, 99);
+        NodeID t = random_functions::nextInt(0, 99);
+        int64_t w = random_functions::nextInt(1, 5);
+        if (i % 4 == 3)
+            w = -w;
+        uint64_t time = sorted ? i / 10 : random_functions::nextInt(0, 50);
+        updates.emplace_back(s, t, w, time);
+    }
+
+    std::ofstream f(path);
+    f << "% temporal graph\n";
+    for (auto [s, t, w, time] : updates) {
+        f << (s + 1) << " " << (t + 1) << " "
+          << (w > 0 ? "+" : "-") << std::abs(w) << " " << time << "\n";
+    }
+
+    std::stable_sort(updates.begin(), updates.end(),
+                     [](const auto& u1, const auto& u2) {
+                         return std::get<3>(u1) < std::get<3>(u2);
+                     });
+    return updates;
+}
+
+TEST(TemporalEdgeStreamTest, SortedInput) {
+    random_functions::setSeed(1);
+    std::string path = "temporal_edge_stream_test_sorted.txt";
+    auto updates = writeUpdates(path, true);
+
+    temporal_edge_stream stream(path, 16);
+    ASSERT_TRUE(stream.sorted());
+    ASSERT_EQ(stream.numUpdates(), updates.size());
+    NodeID n = 0;
+    for (auto [s, t, w, time] : updates) {
+        n = std::max(n, std::max(s, t) + 1);
+    }
+    ASSERT_EQ(stream.numVertices(), n);
+
+    std::vector<update> batch;
+    size_t read = 0;
+    while (stream.nextBatch(&batch)) {
+        ASSERT_EQ(batch.size(), 10);
+        for (const update& u : batch) {
+            ASSERT_EQ(u, updates[read++]);
+        }
+    }
+    ASSERT_EQ(read, updates.size());
+    std::remove(path.c_str());
+}
+
+TEST(TemporalEdgeStreamTest, ExternalSort) {
+    random_functions::setSeed(2);
+    std::string path = "temporal_edge_stream_test_unsorted.txt";
+    auto updates = writeUpdates(path, false);
+
+    for (size_t run_size : { 3, 7, 100, 10000 }) {
+        temporal_edge_stream stream(path, run_size, ".");
+        ASSERT_FALSE(stream.sorted());
+        for (size_t pass = 0; pass < 2; ++pass) {
+            update u;
+            size_t read = 0;
+            while (stream.next(&u)) {
+                ASSERT_EQ(u, updates[read++]);
+            }
+            ASSERT_EQ(read, updates.size());
+            stream.rewind();
+        }
+    }
+    std::remove(path.c_str());
+}